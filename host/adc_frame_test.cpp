@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// adc_frame_test - Checks the ADC frame unpack kernels
+// (main/utils/adc_frame_kernel.h) against a reference decoder that reads the
+// TYPE2 conversion result the way the ESP-IDF bitfields lay it out:
+//   - only the 12 data bits make it into the samples, whatever is in the
+//     channel, unit and reserved bits (including all-ones words the driver
+//     leaves in unused slots)
+//   - the min and max match the samples, and an empty frame gives 0 and 0
+//   - every length from 0 to a few frames, so the PIE path's tail (words
+//     that don't fill a vector) is covered
+//   - adc_frame_unpack() gives the same result whether the buffers are
+//     aligned for the PIE path or not
+//   - adc_frame_normalizer() maps the min and max to -1 and +1
+//
+// The build compiles adc_frame_kernel.cpp as if for the S3 and this file
+// stands in for adc_frame_kernel_pie.S with the same steps in C, so the PIE
+// wrapper is checked bit for bit against the scalar kernel too. The assembly
+// itself is checked on the device with TUNER_PROFILE_PITCH_DETECTOR.
+//
+// Usage: adc_frame_test
+//
+// Exits with 1 if any check fails.
+//
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "adc_frame_kernel.h"
+
+#if !ADC_FRAME_KERNEL_HAS_PIE
+#error "adc_frame_test expects adc_frame_kernel.cpp to be built with the PIE path"
+#endif
+
+#define MAX_WORDS       260
+
+// ADC_DIGI_OUTPUT_FORMAT_TYPE2 on the S3 (adc_digi_output_data_t.type2).
+typedef union {
+    struct {
+        uint32_t data:      12;
+        uint32_t channel:   4;
+        uint32_t unit:      1;
+        uint32_t reserved:  15;
+    } type2;
+    uint32_t val;
+} ReferenceWord;
+
+static void reference_unpack(const uint32_t *words, size_t numWords, float *out, float *outMin, float *outMax) {
+    *outMin = 0;
+    *outMax = 0;
+    for (size_t i = 0; i < numWords; i++) {
+        ReferenceWord word;
+        word.val = words[i];
+        out[i] = (float)word.type2.data;
+        if (i == 0 || out[i] < *outMin) {
+            *outMin = out[i];
+        }
+        if (i == 0 || out[i] > *outMax) {
+            *outMax = out[i];
+        }
+    }
+}
+
+// adc_frame_kernel_pie.S, one instruction at a time.
+extern "C" void adc_frame_unpack_pie_blocks(const uint32_t *words, size_t numBlocks, int32_t *out, int32_t *lanes) {
+    int32_t q5[4], q6[4];
+    for (int l = 0; l < 4; l++) {
+        q5[l] = q6[l] = (int32_t)(words[l] & ADC_FRAME_KERNEL_DATA_MASK);
+    }
+    for (size_t b = 0; b < numBlocks; b++) {
+        for (int l = 0; l < 4; l++) {
+            int32_t q0 = (int32_t)(words[b * 4 + l] & ADC_FRAME_KERNEL_DATA_MASK);
+            q5[l] = q0 > q5[l] ? q0 : q5[l];
+            q6[l] = q0 < q6[l] ? q0 : q6[l];
+            out[b * 4 + l] = q0;
+        }
+    }
+    memcpy(lanes, q5, sizeof(q5));
+    memcpy(lanes + 4, q6, sizeof(q6));
+}
+
+typedef void (*unpack_fn_t)(const uint32_t *words, size_t numWords, float *out, float *outMin, float *outMax);
+
+static std::mt19937 rng(0xadc3);
+
+/// @brief Conversion words with random data and random bits everywhere
+/// else. `kind` picks how the data is laid out.
+static void make_words(uint32_t *words, size_t numWords, int kind) {
+    for (size_t i = 0; i < numWords; i++) {
+        uint32_t upper = rng() & ~(uint32_t)ADC_FRAME_KERNEL_DATA_MASK;
+        uint32_t data;
+        switch (kind) {
+            case 0:  data = rng() & ADC_FRAME_KERNEL_DATA_MASK; break;                 // anything
+            case 1:  data = 2048 + (int)(1500 * sin(0.05 * i)) + rng() % 16; break;    // a note
+            case 2:  data = 0; break;                                                   // stuck low
+            default: data = ADC_FRAME_KERNEL_DATA_MASK; break;                          // stuck high
+        }
+        words[i] = upper | (data & ADC_FRAME_KERNEL_DATA_MASK);
+        if (rng() % 17 == 0) {
+            words[i] = 0xFFFFFFFF; // What the driver leaves in a slot it didn't fill
+        }
+    }
+}
+
+/// @return Returns the number of failed checks.
+static int check_kernel(const char *name, unpack_fn_t unpack, size_t alignOffset) {
+    alignas(ADC_FRAME_KERNEL_ALIGNMENT) uint32_t words[MAX_WORDS + 4];
+    alignas(ADC_FRAME_KERNEL_ALIGNMENT) float out[MAX_WORDS + 4];
+    float reference[MAX_WORDS];
+    int failures = 0;
+
+    for (int kind = 0; kind < 4; kind++) {
+        for (size_t numWords = 0; numWords <= MAX_WORDS; numWords++) {
+            uint32_t *w = words + alignOffset;
+            float *o = out + alignOffset;
+            make_words(w, numWords, kind);
+
+            float refMin, refMax;
+            reference_unpack(w, numWords, reference, &refMin, &refMax);
+
+            float minVal = NAN, maxVal = NAN;
+            unpack(w, numWords, o, &minVal, &maxVal);
+
+            if (memcmp(reference, o, numWords * sizeof(float)) != 0) {
+                fprintf(stderr, "FAIL: %s (offset %zu): samples differ from the reference for %zu words\n", name, alignOffset, numWords);
+                failures++;
+            } else if (memcmp(&refMin, &minVal, sizeof(float)) != 0 || memcmp(&refMax, &maxVal, sizeof(float)) != 0) {
+                fprintf(stderr, "FAIL: %s (offset %zu): min/max %.0f/%.0f for %zu words, expected %.0f/%.0f\n",
+                    name, alignOffset, minVal, maxVal, numWords, refMin, refMax);
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+/// @return Returns the number of failed checks.
+static int check_normalizer() {
+    const float ranges[][2] = { { 0, 4095 }, { 1000, 3000 }, { 2047, 2049 }, { 12, 13 } };
+    int failures = 0;
+    for (const auto &range : ranges) {
+        float scale, offset;
+        adc_frame_normalizer(range[0], range[1], &scale, &offset);
+        float low = range[0] * scale + offset;
+        float high = range[1] * scale + offset;
+        if (fabsf(low + 1.0f) > 1e-5f || fabsf(high - 1.0f) > 1e-5f) {
+            fprintf(stderr, "FAIL: normalizer maps [%.0f, %.0f] to [%f, %f]\n", range[0], range[1], low, high);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int main() {
+    int failures = 0;
+    failures += check_kernel("scalar", adc_frame_unpack_scalar, 0);
+    failures += check_kernel("scalar", adc_frame_unpack_scalar, 1);
+    failures += check_kernel("pie", adc_frame_unpack_pie, 0);
+    failures += check_kernel("dispatch", adc_frame_unpack, 0);
+    failures += check_kernel("dispatch", adc_frame_unpack, 1);
+    failures += check_kernel("dispatch", adc_frame_unpack, 3);
+    failures += check_normalizer();
+
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
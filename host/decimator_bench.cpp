@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// decimator_bench - The CPU budget of every supported TUNER_ADC_DECIMATION.
+//
+// For each factor it prints the work per detector frame (taps, multiply-adds
+// and stores), the time the scalar decimator takes for a frame on this
+// machine and an estimate for the S3 scalar and PIE kernels from a simple
+// cycle model, as a share of one 240 MHz core. The real S3 numbers are logged
+// by the firmware with TUNER_PROFILE_PITCH_DETECTOR.
+//
+// It also shows what the filter buys: tones between the detector range and
+// the oversampled Nyquist, and how loud they come out at the detector rate
+// when they are just subsampled and when they are decimated.
+//
+// Usage: decimator_bench [--iterations <n>]
+//
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "defines.h"
+#include "Decimator.hpp"
+
+#define S3_CPU_HZ                   240e6
+// Cycle model for the S3: the scalar loop does two 16-bit loads and a
+// multiply-add per tap, the PIE loop two 128-bit loads and one 8-lane
+// multiply-add per 8 taps. Storing an input sample costs about 3 cycles.
+#define S3_SCALAR_CYCLES_PER_TAP    3.0
+#define S3_PIE_CYCLES_PER_8_TAPS    3.0
+#define S3_CYCLES_PER_STORE         3.0
+
+static const double alias_tones_hz[] = { 3000, 3500, 4500, 6000, 9000 };
+
+static std::vector<uint32_t> tone_words(double frequency, double sampleRate, size_t numWords) {
+    std::vector<uint32_t> words(numWords);
+    for (size_t i = 0; i < numWords; i++) {
+        words[i] = (uint32_t)lround(2048 + 1500 * sin(2 * M_PI * frequency * i / sampleRate));
+    }
+    return words;
+}
+
+static double rms_db(const std::vector<float> &samples) {
+    double sum = 0;
+    for (float s : samples) {
+        sum += (s - 2048) * (s - 2048);
+    }
+    return 20 * log10(sqrt(sum / samples.size()) / (1500 / M_SQRT2));
+}
+
+template <size_t Factor>
+static void bench_factor(int iterations) {
+    typedef Decimator<Factor, TUNER_ADC_SAMPLES_PER_FRAME> FrameDecimator;
+    const size_t frameWords = TUNER_ADC_SAMPLES_PER_FRAME * Factor;
+    const double inputRate = (double)TUNER_ADC_SAMPLE_RATE * Factor;
+    const double frameSeconds = (double)TUNER_ADC_SAMPLES_PER_FRAME / TUNER_ADC_SAMPLE_RATE;
+
+    FrameDecimator decimator;
+    std::vector<uint32_t> words = tone_words(440, inputRate, frameWords * 16);
+    float out[TUNER_ADC_SAMPLES_PER_FRAME];
+    float minVal, maxVal;
+    volatile float sink = 0;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        const uint32_t *frame = &words[(i % 16) * frameWords];
+        decimator.process(frame, frameWords, out, &minVal, &maxVal);
+        sink = sink + out[TUNER_ADC_SAMPLES_PER_FRAME - 1];
+    }
+    double hostUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / iterations;
+
+    double macs = (double)FrameDecimator::NumTaps * TUNER_ADC_SAMPLES_PER_FRAME;
+    double stores = (double)frameWords * FrameDecimator::NumCopies;
+    double scalarCycles = macs * S3_SCALAR_CYCLES_PER_TAP + stores * S3_CYCLES_PER_STORE;
+    double pieCycles = macs / 8 * S3_PIE_CYCLES_PER_8_TAPS + stores * S3_CYCLES_PER_STORE;
+    double framesPerSecond = 1 / frameSeconds;
+
+    printf("x%zu (ADC at %.0f kHz): %zu taps, %zu conversions -> %d samples per %.1f ms frame\n",
+        Factor, inputRate / 1000, FrameDecimator::NumTaps, frameWords, TUNER_ADC_SAMPLES_PER_FRAME, frameSeconds * 1000);
+    printf("  work per frame:  %.0f multiply-adds, %.0f stores (%zu cop%s of the history)\n",
+        macs, stores, FrameDecimator::NumCopies, FrameDecimator::NumCopies == 1 ? "y" : "ies");
+    printf("  host scalar:     %7.2f us/frame (%.3f%% of real time)\n", hostUs, hostUs / (frameSeconds * 1e6) * 100);
+    printf("  S3 scalar (est): %7.0f cycles/frame, %5.2f%% of a core\n", scalarCycles, scalarCycles * framesPerSecond / S3_CPU_HZ * 100);
+    printf("  S3 PIE (est):    %7.0f cycles/frame, %5.2f%% of a core\n", pieCycles, pieCycles * framesPerSecond / S3_CPU_HZ * 100);
+
+    printf("  level at %d Hz:", TUNER_ADC_SAMPLE_RATE);
+    for (double tone : alias_tones_hz) {
+        if (tone >= inputRate / 2) {
+            continue;
+        }
+        std::vector<uint32_t> toneWords = tone_words(tone, inputRate, frameWords * 32);
+
+        std::vector<float> subsampled;
+        for (size_t i = 0; i < toneWords.size(); i += Factor) {
+            subsampled.push_back((float)(toneWords[i] & ADC_FRAME_KERNEL_DATA_MASK));
+        }
+
+        FrameDecimator toneDecimator;
+        std::vector<float> decimated;
+        for (size_t start = 0; start < toneWords.size(); start += frameWords) {
+            size_t numOut = toneDecimator.process(&toneWords[start], frameWords, out, &minVal, &maxVal);
+            if (start >= frameWords * 4) { // Past the filter's start up
+                decimated.insert(decimated.end(), out, out + numOut);
+            }
+        }
+        double alias = fabs(remainder(tone, TUNER_ADC_SAMPLE_RATE));
+        printf("  %.1fk->%.1fk %+.0f/%+.0f dB", tone / 1000, alias / 1000, rms_db(subsampled), rms_db(decimated));
+    }
+    printf("\n                  (tone -> where it aliases, subsampled/decimated)\n");
+}
+
+int main(int argc, char **argv) {
+    int iterations = 20000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--iterations <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    bench_factor<4>(iterations);
+    bench_factor<8>(iterations);
+    return 0;
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// decimator_test - Checks the oversampling decimator (main/utils/Decimator.hpp)
+// on its scalar path, for every supported factor:
+//   - the taps are symmetric and add up to exactly 1.0 in Q15
+//   - the frequency response: flat through the detector range (up to C7)
+//     and at least 55 dB down wherever it would alias into it
+//   - streamed frame by frame (including short frames) it produces exactly
+//     what a straight FIR over the whole input gives
+//   - every window it hands the dot product kernel is 16-byte aligned, as
+//     the SIMD kernel needs
+//
+// On the S3 the SIMD kernel is checked against the scalar one on live ADC
+// data with TUNER_PROFILE_PITCH_DETECTOR.
+//
+// Usage: decimator_test
+//
+// Exits with 1 if any check fails.
+//
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "defines.h"
+#include "Decimator.hpp"
+
+#define PASS_BAND_HZ        2093.0  // C7, the top of the detector range
+#define STOP_BAND_HZ        2907.0  // Aliases to PASS_BAND_HZ at 5 kHz
+#define MAX_RIPPLE_DB       0.1
+#define MIN_REJECTION_DB    55.0
+#define FRAME_OUTPUTS       64
+
+static size_t s_misaligned = 0;
+
+// The scalar kernel, but counting the calls the SIMD kernel couldn't take.
+static int32_t checked_dot(const int16_t *samples, const int16_t *taps, size_t numTaps) {
+    if ((uintptr_t)samples % ADC_FRAME_KERNEL_ALIGNMENT != 0 || (uintptr_t)taps % ADC_FRAME_KERNEL_ALIGNMENT != 0
+        || numTaps % DECIMATOR_KERNEL_LANES != 0) {
+        s_misaligned++;
+    }
+    return decimator_dot_scalar(samples, taps, numTaps);
+}
+
+static double response_db(const int16_t *taps, size_t numTaps, double frequency, double sampleRate) {
+    std::complex<double> sum = 0;
+    for (size_t i = 0; i < numTaps; i++) {
+        sum += std::polar(taps[i] / 32768.0, -2 * M_PI * frequency / sampleRate * i);
+    }
+    return 20 * log10(std::abs(sum));
+}
+
+template <size_t Factor>
+static int check_factor() {
+    int failures = 0;
+    const double inputRate = (double)TUNER_ADC_SAMPLE_RATE * Factor;
+    Decimator<Factor, FRAME_OUTPUTS> decimator(checked_dot);
+    s_misaligned = 0;
+    const size_t numTaps = decimator.NumTaps;
+    const int16_t *taps = decimator.getTaps();
+
+    int32_t sum = 0;
+    for (size_t i = 0; i < numTaps; i++) {
+        sum += taps[i];
+        if (taps[i] != taps[numTaps - 1 - i]) {
+            fprintf(stderr, "FAIL: x%zu tap %zu is not symmetric\n", Factor, i);
+            failures++;
+            break;
+        }
+    }
+    if (sum != 32768) {
+        fprintf(stderr, "FAIL: x%zu taps add up to %d\n", Factor, (int)sum);
+        failures++;
+    }
+
+    double worstRipple = 0;
+    for (double f = 0; f <= PASS_BAND_HZ; f += 5) {
+        worstRipple = std::max(worstRipple, fabs(response_db(taps, numTaps, f, inputRate)));
+    }
+    double worstRejection = 1000;
+    for (double f = STOP_BAND_HZ; f <= inputRate / 2; f += 5) {
+        worstRejection = std::min(worstRejection, -response_db(taps, numTaps, f, inputRate));
+    }
+    if (worstRipple > MAX_RIPPLE_DB) {
+        fprintf(stderr, "FAIL: x%zu pass band ripple %.3f dB\n", Factor, worstRipple);
+        failures++;
+    }
+    if (worstRejection < MIN_REJECTION_DB) {
+        fprintf(stderr, "FAIL: x%zu stop band only %.1f dB down\n", Factor, worstRejection);
+        failures++;
+    }
+
+    // Random conversion words (with junk in the channel bits) fed in frames
+    // of different lengths, including ones that aren't a multiple of Factor.
+    std::mt19937 rng(Factor);
+    std::uniform_int_distribution<uint32_t> word(0, 0xFFFFFFFF);
+    std::vector<uint32_t> words(FRAME_OUTPUTS * Factor * 40);
+    for (auto &w : words) {
+        w = word(rng);
+    }
+
+    std::vector<float> streamed;
+    size_t start = 0;
+    const size_t frameLengths[] = { FRAME_OUTPUTS * Factor, 3 * Factor, FRAME_OUTPUTS * Factor - 1, 1 };
+    for (size_t i = 0; start < words.size(); i++) {
+        size_t length = std::min(frameLengths[i % 4], words.size() - start);
+        size_t used = length / Factor * Factor; // The rest is dropped by the decimator
+        float out[FRAME_OUTPUTS];
+        float minVal, maxVal;
+        size_t numOut = decimator.process(&words[start], length, out, &minVal, &maxVal);
+        if (numOut != used / Factor) {
+            fprintf(stderr, "FAIL: x%zu returned %zu samples for %zu words\n", Factor, numOut, length);
+            return failures + 1;
+        }
+        float expectedMin = INFINITY, expectedMax = -INFINITY;
+        for (size_t j = 0; j < numOut; j++) {
+            expectedMin = std::min(expectedMin, out[j]);
+            expectedMax = std::max(expectedMax, out[j]);
+        }
+        if (numOut > 0 && (minVal != expectedMin || maxVal != expectedMax)) {
+            fprintf(stderr, "FAIL: x%zu min/max don't match the samples\n", Factor);
+            failures++;
+        }
+        // Keep only the words the decimator saw for the reference.
+        words.erase(words.begin() + start + used, words.begin() + start + length);
+        streamed.insert(streamed.end(), out, out + numOut);
+        start += used;
+    }
+
+    size_t mismatches = 0;
+    for (size_t m = 0; m < streamed.size(); m++) {
+        int64_t acc = 0;
+        for (size_t k = 0; k < numTaps; k++) {
+            int64_t index = (int64_t)((m + 1) * Factor) - (int64_t)numTaps + (int64_t)k;
+            int32_t x = index < 0 ? 0 : (int32_t)(words[index] & ADC_FRAME_KERNEL_DATA_MASK) - 2048;
+            acc += (int64_t)x * taps[k];
+        }
+        float expected = (int32_t)acc * (1.0f / 32768) + 2048;
+        if (streamed[m] != expected) {
+            mismatches++;
+        }
+    }
+    if (mismatches > 0) {
+        fprintf(stderr, "FAIL: x%zu %zu of %zu streamed samples differ from the reference\n", Factor, mismatches, streamed.size());
+        failures++;
+    }
+
+    if (s_misaligned > 0) {
+        fprintf(stderr, "FAIL: x%zu %zu windows weren't aligned for the SIMD kernel\n", Factor, s_misaligned);
+        failures++;
+    }
+
+    printf("x%zu: %zu taps, ripple %.3f dB up to %.0f Hz, %.1f dB down from %.0f Hz\n",
+        Factor, numTaps, worstRipple, PASS_BAND_HZ, worstRejection, STOP_BAND_HZ);
+    return failures;
+}
+
+int main() {
+    int failures = 0;
+    failures += check_factor<4>();
+    failures += check_factor<8>();
+
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// footswitch_test - Plays scripted foot switch edges (with contact bounce)
+// through `FootswitchGestures` the way gpio_task does: edges as they happen
+// and `timeout()` whenever a deadline passes. Checks which gestures come out
+// and when.
+//
+// Usage: footswitch_test
+//
+// Exits with 1 if any scenario fails.
+//
+#include <cstdio>
+#include <vector>
+
+#include "defines.h"
+#include "FootswitchGestures.hpp"
+
+#define MS  1000    // microseconds
+
+typedef struct {
+    int64_t timeUs;
+    bool pressed;
+} Edge;
+
+typedef struct {
+    FootswitchGesture gesture;
+    int64_t timeUs;
+} Result;
+
+// A press (or release) with `bounces` extra edges 1 ms apart.
+static void add_edge(std::vector<Edge> &edges, int64_t timeUs, bool pressed, int bounces = 3) {
+    edges.push_back({ timeUs, pressed });
+    for (int i = 0; i < bounces; i++) {
+        edges.push_back({ timeUs + (2 * i + 1) * MS, !pressed });
+        edges.push_back({ timeUs + (2 * i + 2) * MS, pressed });
+    }
+}
+
+static std::vector<Result> run(const std::vector<Edge> &edges, bool waitsForDoublePress, int64_t endUs) {
+    FootswitchGestures gestures(DEBOUNCE_TIME_MS * MS, DOUBLE_PRESS_TIME_MS * MS, LONG_PRESS_TIME_MS * MS);
+    gestures.setWaitsForDoublePress(waitsForDoublePress);
+    std::vector<Result> results;
+    bool level = false;
+    size_t next = 0;
+    while (true) {
+        int64_t deadline = gestures.nextDeadlineUs();
+        int64_t edgeUs = next < edges.size() ? edges[next].timeUs : FOOTSWITCH_NO_DEADLINE;
+        if (deadline > endUs && edgeUs > endUs) {
+            break;
+        }
+        FootswitchGesture gesture;
+        int64_t nowUs;
+        if (edgeUs <= deadline) {
+            level = edges[next].pressed;
+            nowUs = edgeUs;
+            gesture = gestures.edge(level, nowUs);
+            next++;
+        } else {
+            nowUs = deadline;
+            gesture = gestures.timeout(level, nowUs);
+        }
+        if (gesture != footswitchGestureNone) {
+            results.push_back({ gesture, nowUs });
+        }
+    }
+    return results;
+}
+
+static const char *name(FootswitchGesture gesture) {
+    switch (gesture) {
+    case footswitchGestureSingle: return "single";
+    case footswitchGestureDouble: return "double";
+    case footswitchGestureLong: return "long";
+    default: return "none";
+    }
+}
+
+static bool expect(const char *scenario, const std::vector<Result> &results, const std::vector<Result> &expected) {
+    bool ok = results.size() == expected.size();
+    for (size_t i = 0; ok && i < results.size(); i++) {
+        ok = results[i].gesture == expected[i].gesture && results[i].timeUs == expected[i].timeUs;
+    }
+    if (!ok) {
+        fprintf(stderr, "FAIL: %s\n  expected:", scenario);
+        for (auto &r : expected) {
+            fprintf(stderr, " %s@%lldms", name(r.gesture), (long long)(r.timeUs / MS));
+        }
+        fprintf(stderr, "\n  got:     ");
+        for (auto &r : results) {
+            fprintf(stderr, " %s@%lldms", name(r.gesture), (long long)(r.timeUs / MS));
+        }
+        fprintf(stderr, "\n");
+    }
+    return ok;
+}
+
+int main() {
+    int failures = 0;
+    const int64_t t0 = 1000 * MS;
+
+    // A bouncy tap is one single press, reported on the release edge itself.
+    {
+        std::vector<Edge> edges;
+        add_edge(edges, t0, true);
+        add_edge(edges, t0 + 150 * MS, false);
+        failures += expect("tap", run(edges, false, t0 + 2000 * MS),
+            { { footswitchGestureSingle, t0 + 150 * MS } }) ? 0 : 1;
+    }
+
+    // In settings the single press waits out the double press window.
+    {
+        std::vector<Edge> edges;
+        add_edge(edges, t0, true);
+        add_edge(edges, t0 + 100 * MS, false);
+        failures += expect("tap waiting for double", run(edges, true, t0 + 2000 * MS),
+            { { footswitchGestureSingle, t0 + (100 + DOUBLE_PRESS_TIME_MS) * MS } }) ? 0 : 1;
+    }
+
+    // Two quick taps in settings are a double press and no single press.
+    {
+        std::vector<Edge> edges;
+        add_edge(edges, t0, true);
+        add_edge(edges, t0 + 80 * MS, false);
+        add_edge(edges, t0 + 180 * MS, true);
+        add_edge(edges, t0 + 260 * MS, false);
+        failures += expect("double", run(edges, true, t0 + 2000 * MS),
+            { { footswitchGestureDouble, t0 + 260 * MS } }) ? 0 : 1;
+    }
+
+    // Outside of settings two quick taps are two single presses.
+    {
+        std::vector<Edge> edges;
+        add_edge(edges, t0, true);
+        add_edge(edges, t0 + 80 * MS, false);
+        add_edge(edges, t0 + 180 * MS, true);
+        add_edge(edges, t0 + 260 * MS, false);
+        failures += expect("two taps", run(edges, false, t0 + 2000 * MS),
+            { { footswitchGestureSingle, t0 + 80 * MS }, { footswitchGestureSingle, t0 + 260 * MS } }) ? 0 : 1;
+    }
+
+    // Holding it reports a long press while held and nothing on release.
+    {
+        std::vector<Edge> edges;
+        add_edge(edges, t0, true);
+        add_edge(edges, t0 + 1500 * MS, false);
+        failures += expect("long", run(edges, false, t0 + 3000 * MS),
+            { { footswitchGestureLong, t0 + LONG_PRESS_TIME_MS * MS } }) ? 0 : 1;
+    }
+
+    // Released during the debounce lockout (the release edge is swallowed as
+    // bounce): picked up when the lockout ends.
+    {
+        std::vector<Edge> edges;
+        add_edge(edges, t0, true, 0);
+        add_edge(edges, t0 + 20 * MS, false, 0);
+        failures += expect("release during lockout", run(edges, false, t0 + 2000 * MS),
+            { { footswitchGestureSingle, t0 + DEBOUNCE_TIME_MS * MS } }) ? 0 : 1;
+    }
+
+    // A glitch that's over before the interrupt reads the level.
+    {
+        std::vector<Edge> edges = { { t0, false } };
+        failures += expect("glitch", run(edges, false, t0 + 2000 * MS), {}) ? 0 : 1;
+    }
+
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// frame_pool_bench - Times how ADC frames get from the driver buffer to the
+// loop that feeds the pitch detector:
+//   - legacy: a std::vector allocated for every frame, an unpack loop with
+//     float min/max compares and a second pass to normalize (reproduced
+//     below from the original pitch_detector_task.cpp)
+//   - pooled: frames from a fixed pool, unpacked with adc_frame_unpack()
+//     (min/max in the same pass) and handed over SPSCRing, normalizing while
+//     the frame is walked, all on one thread
+//   - pipelined: the same with ingest and detection on two threads, like the
+//     two cores on the device
+//
+// It reports the per-frame time (p50, p99 and max, the max being the jitter
+// that matters for the detector), how many heap allocations each path makes
+// per frame and, for the pipelined path, the throughput.
+//
+// Usage: frame_pool_bench [--frames <n>]
+//
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "defines.h"
+#include "adc_frame_kernel.h"
+#include "SPSCRing.hpp"
+
+static std::atomic<size_t> num_allocations(0);
+
+void *operator new(size_t size) {
+    num_allocations.fetch_add(1, std::memory_order_relaxed);
+    void *p = malloc(size > 0 ? size : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+typedef struct {
+    alignas(ADC_FRAME_KERNEL_ALIGNMENT) float samples[TUNER_ADC_SAMPLES_PER_FRAME];
+    size_t numSamples;
+    float minVal;
+    float maxVal;
+} Frame;
+
+#define POOL_SIZE   TUNER_ADC_FRAME_POOL_SIZE
+
+// Conversion words as the driver hands them over: 12 bits of a sine with
+// noise and the channel number above the data.
+static std::vector<uint32_t> make_words(size_t numFrames) {
+    std::vector<uint32_t> words(numFrames * TUNER_ADC_SAMPLES_PER_FRAME);
+    srand(0xf7);
+    for (size_t i = 0; i < words.size(); i++) {
+        float s = sinf(2.0f * (float)M_PI * 110.0f * i / TUNER_ADC_SAMPLE_RATE);
+        int value = 2048 + (int)(1200.0f * s) + rand() % 32 - 16;
+        words[i] = (uint32_t)value | (7u << 12);
+    }
+    return words;
+}
+
+// What the detection stage does with every sample, minus the detector.
+static inline float consume(float s) {
+    return s * s;
+}
+
+static void legacy_frame(const uint32_t *words, volatile float *sink) {
+    std::vector<float> in(TUNER_ADC_FRAME_SIZE); // a vector of values to pass into qlib
+    int valuesStored = 0;
+    float maxVal = 0;
+    float minVal = MAXFLOAT;
+    for (int i = 0; i < TUNER_ADC_SAMPLES_PER_FRAME; i++, valuesStored++) {
+        in[valuesStored] = (float)(words[i] & ADC_FRAME_KERNEL_DATA_MASK);
+        if (in[valuesStored] > maxVal) {
+            maxVal = in[valuesStored];
+        }
+        if (in[valuesStored] < minVal) {
+            minVal = in[valuesStored];
+        }
+    }
+    float range = maxVal - minVal;
+    float midVal = range / 2;
+    float sum = 0;
+    for (auto i = 0; i < valuesStored; i++) {
+        float newPosition = in[i] - midVal - minVal;
+        sum += consume(newPosition / midVal);
+    }
+    *sink = *sink + sum;
+}
+
+static void ingest(Frame *frame, const uint32_t *words) {
+    adc_frame_unpack(words, TUNER_ADC_SAMPLES_PER_FRAME, frame->samples, &frame->minVal, &frame->maxVal);
+    frame->numSamples = TUNER_ADC_SAMPLES_PER_FRAME;
+}
+
+static void detect(const Frame *frame, volatile float *sink) {
+    float scale, offset;
+    adc_frame_normalizer(frame->minVal, frame->maxVal, &scale, &offset);
+    float sum = 0;
+    for (size_t i = 0; i < frame->numSamples; i++) {
+        sum += consume(frame->samples[i] * scale + offset);
+    }
+    *sink = *sink + sum;
+}
+
+typedef struct {
+    double p50;
+    double p99;
+    double max;
+    double allocationsPerFrame;
+} FrameTimes;
+
+static FrameTimes summarize(std::vector<double> &ns, size_t allocations) {
+    std::sort(ns.begin(), ns.end());
+    return { ns[ns.size() / 2], ns[ns.size() * 99 / 100], ns.back(), (double)allocations / ns.size() };
+}
+
+static FrameTimes run_legacy(const std::vector<uint32_t> &words, size_t numFrames) {
+    std::vector<double> ns(numFrames);
+    volatile float sink = 0;
+    size_t allocations = num_allocations.load();
+    for (size_t f = 0; f < numFrames; f++) {
+        auto start = std::chrono::steady_clock::now();
+        legacy_frame(&words[f * TUNER_ADC_SAMPLES_PER_FRAME], &sink);
+        ns[f] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+    allocations = num_allocations.load() - allocations;
+    return summarize(ns, allocations);
+}
+
+static Frame frame_pool[POOL_SIZE];
+static SPSCRing<Frame *, POOL_SIZE> free_frames;
+static SPSCRing<Frame *, POOL_SIZE> ready_frames;
+
+static FrameTimes run_pooled(const std::vector<uint32_t> &words, size_t numFrames) {
+    std::vector<double> ns(numFrames);
+    volatile float sink = 0;
+    size_t allocations = num_allocations.load();
+    for (size_t f = 0; f < numFrames; f++) {
+        auto start = std::chrono::steady_clock::now();
+        Frame *frame = nullptr;
+        free_frames.pop(frame);
+        ingest(frame, &words[f * TUNER_ADC_SAMPLES_PER_FRAME]);
+        ready_frames.push(frame);
+
+        ready_frames.pop(frame);
+        detect(frame, &sink);
+        free_frames.push(frame);
+        ns[f] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+    allocations = num_allocations.load() - allocations;
+    return summarize(ns, allocations);
+}
+
+/// @brief Runs ingest and detection on two threads.
+/// @return Returns the frames per second that got through.
+static double run_pipelined(const std::vector<uint32_t> &words, size_t numFrames) {
+    volatile float sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::thread detector([&]() {
+        for (size_t f = 0; f < numFrames; ) {
+            Frame *frame = nullptr;
+            if (!ready_frames.pop(frame)) {
+                std::this_thread::yield();
+                continue;
+            }
+            detect(frame, &sink);
+            free_frames.push(frame);
+            f++;
+        }
+    });
+    for (size_t f = 0; f < numFrames; ) {
+        Frame *frame = nullptr;
+        if (!free_frames.pop(frame)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ingest(frame, &words[f * TUNER_ADC_SAMPLES_PER_FRAME]);
+        ready_frames.push(frame);
+        f++;
+    }
+    detector.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return numFrames / seconds;
+}
+
+static void print_times(const char *name, const FrameTimes &t) {
+    printf("  %-10s %8.1f %8.1f %10.1f %8.2f\n", name, t.p50, t.p99, t.max, t.allocationsPerFrame);
+}
+
+int main(int argc, char **argv) {
+    size_t numFrames = 200000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            numFrames = (size_t)atol(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--frames <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (numFrames == 0) {
+        numFrames = 1;
+    }
+
+    std::vector<uint32_t> words = make_words(numFrames);
+    for (size_t i = 0; i < POOL_SIZE; i++) {
+        free_frames.push(&frame_pool[i]);
+    }
+
+    FrameTimes legacy = run_legacy(words, numFrames);
+    FrameTimes pooled = run_pooled(words, numFrames);
+    double framesPerSecond = run_pipelined(words, numFrames);
+
+    printf("%zu frames of %d samples\n", numFrames, TUNER_ADC_SAMPLES_PER_FRAME);
+    printf("  %-10s %8s %8s %10s %8s\n", "", "p50 ns", "p99 ns", "max ns", "allocs");
+    print_times("legacy", legacy);
+    print_times("pooled", pooled);
+    printf("  pooled is %.2fx faster at p50, %.2fx at p99\n", legacy.p50 / pooled.p50, legacy.p99 / pooled.p99);
+    printf("  pipelined: %.0f frames/s (%.0fx the %d frames/s the ADC delivers)\n",
+        framesPerSecond, framesPerSecond * TUNER_ADC_SAMPLES_PER_FRAME / TUNER_ADC_SAMPLE_RATE,
+        TUNER_ADC_SAMPLE_RATE / TUNER_ADC_SAMPLES_PER_FRAME);
+    return 0;
+}
@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// front_end_bench - Compares the two ways `PitchDetectorChain` can bring
+// samples to -1.0 to +1.0 before the signal conditioner:
+//
+//   min/max    every frame by its own min and max (TUNER_STREAMING_NORMALIZER 0)
+//   streaming  DC blocker + slow AGC across frames (main/utils/StreamingNormalizer.hpp)
+//
+// Decaying synthetic plucks go through the noise gate and then through both
+// front ends while the gate is open, just like in the chain. For each string
+// it reports:
+//   - jitter: RMS and max cent error of single periods measured from rising
+//     zero crossings. Both outputs go through the same 4th order low-pass
+//     just above the fundamental first, so what's left is mostly the offset
+//     and scale jumping around.
+//   - slips: periods off by more than SLIP_CENTS (a crossing that was
+//     missed or doubled). These aren't counted in the jitter.
+// and then the time each front end takes per sample.
+//
+// Usage: front_end_bench [--quick]
+//
+// The pitch detector itself needs q. To compare the whole chain run
+// pluck_bench from a second build directory configured with
+// -DCMAKE_CXX_FLAGS=-DTUNER_STREAMING_NORMALIZER=0.
+//
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "adc_frame_kernel.h"
+#include "defines.h"
+#include "NoiseGate.hpp"
+#include "StreamingNormalizer.hpp"
+#include "pluck_synth.h"
+#include "wav_file.h"
+
+#define PLUCK_SILENCE_SECONDS       1.0f
+#define PLUCK_DURATION_SECONDS      4.0f
+#define CORPUS_SEED                 0x7f3d
+#define ZERO_CROSSING_HYSTERESIS    0.02f
+#define SKIP_PERIODS                2       // After the gate opens
+#define SLIP_CENTS                  300
+#define TIMING_PASSES               200
+
+typedef struct {
+    const char  *name;
+    int         midiNote;
+} BenchString;
+
+static const BenchString benchStrings[] = {
+    { "Bass B0",     23 },
+    { "Bass E1",     28 },
+    { "Bass A1",     33 },
+    { "Gtr E2",      40 },
+    { "Gtr A2",      45 },
+    { "Gtr D3",      50 },
+    { "Gtr G3",      55 },
+    { "Gtr E4",      64 },
+};
+
+static const float noiseDbs[] = { -200, -45 };
+static const float decaySeconds[] = { 1.5f, 6.0f };
+static const float levels[] = { 1.0f, 0.35f };
+
+/// RBJ low-pass biquad.
+class LowPass {
+public:
+    LowPass(float cutoffHz, float sampleRate) {
+        float w = 2 * (float)M_PI * cutoffHz / sampleRate;
+        float alpha = sinf(w) / (2 * (float)M_SQRT1_2);
+        float a0 = 1 + alpha;
+        b0 = (1 - cosf(w)) / 2 / a0;
+        b1 = (1 - cosf(w)) / a0;
+        b2 = b0;
+        a1 = -2 * cosf(w) / a0;
+        a2 = (1 - alpha) / a0;
+    }
+
+    float operator()(float x) {
+        float y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+        x2 = x1; x1 = x;
+        y2 = y1; y1 = y;
+        return y;
+    }
+
+private:
+    float b0, b1, b2, a1, a2;
+    float x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+};
+
+typedef struct {
+    double sumSquares = 0;
+    double maxCents = 0;
+    int numPeriods = 0;
+    int numSlips = 0;
+} Summary;
+
+/// Measures the front end output of one pluck.
+class Measurement {
+public:
+    Measurement(float frequency, float sampleRate)
+        : frequency(frequency), sampleRate(sampleRate),
+          lowPass(frequency * 1.2f, sampleRate), lowPass2(frequency * 1.2f, sampleRate) {
+    }
+
+    void sample(float s, size_t index) {
+        float y = lowPass2(lowPass(s));
+        if (!high && lastFiltered <= 0 && y > 0) {
+            // Interpolate where the filtered signal crossed zero
+            crossing = index - y / (y - lastFiltered);
+        }
+        if (!high && y > ZERO_CROSSING_HYSTERESIS) {
+            high = true;
+            if (numCrossings > SKIP_PERIODS) {
+                double cents = 1200 * log2(frequency * (crossing - lastCrossing) / sampleRate);
+                if (fabs(cents) > SLIP_CENTS) {
+                    stats.numSlips++;
+                } else {
+                    stats.sumSquares += cents * cents;
+                    stats.maxCents = std::max(stats.maxCents, fabs(cents));
+                    stats.numPeriods++;
+                }
+            }
+            lastCrossing = crossing;
+            numCrossings++;
+        } else if (high && y < -ZERO_CROSSING_HYSTERESIS) {
+            high = false;
+        }
+        lastFiltered = y;
+    }
+
+    /// The gate closed. Start over the next time it opens.
+    void gap() {
+        numCrossings = 0;
+        high = false;
+    }
+
+    Summary stats;
+
+private:
+    float frequency;
+    float sampleRate;
+    LowPass lowPass;
+    LowPass lowPass2;
+    float lastFiltered = 0;
+    bool high = false;
+    double crossing = 0;
+    double lastCrossing = 0;
+    int numCrossings = 0;
+};
+
+static void add(Summary &total, const Summary &s) {
+    total.sumSquares += s.sumSquares;
+    total.maxCents = std::max(total.maxCents, s.maxCents);
+    total.numPeriods += s.numPeriods;
+    total.numSlips += s.numSlips;
+}
+
+static double rms_cents(const Summary &s) {
+    return s.numPeriods > 0 ? sqrt(s.sumSquares / s.numPeriods) : NAN;
+}
+
+static double midi_to_frequency(int midiNote) {
+    return A4_FREQ * pow(2.0, (midiNote - 69) / 12.0);
+}
+
+static StreamingNormalizer make_normalizer() {
+    return StreamingNormalizer(TUNER_ADC_SAMPLE_RATE, TUNER_DC_BLOCKER_HZ, TUNER_AGC_RELEASE_MS / 1000.0f, TUNER_AGC_MIN_LEVEL);
+}
+
+int main(int argc, char *argv[]) {
+    bool quick = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else {
+            fprintf(stderr, "Usage: front_end_bench [--quick]\n");
+            return 1;
+        }
+    }
+
+    const size_t frameSize = TUNER_ADC_SAMPLES_PER_FRAME;
+    const float frameSeconds = (float)frameSize / TUNER_ADC_SAMPLE_RATE;
+    const NoiseGateConfig gateConfig = TUNER_GATE_CONFIG;
+
+    printf("%-10s %6s | %-26s | %-26s\n", "", "", "min/max", "streaming");
+    printf("%-10s %6s | %8s %8s %8s | %8s %8s %8s\n", "string", "plucks",
+        "jitter", "max", "slips", "jitter", "max", "slips");
+
+    // Every gated frame of the corpus, kept for the timing runs
+    std::vector<float> gatedSamples;
+    std::vector<float> gatedMin, gatedMax;
+
+    Summary minMaxTotal, streamingTotal;
+    uint32_t seed = CORPUS_SEED;
+    size_t numNoises = quick ? 1 : sizeof(noiseDbs) / sizeof(noiseDbs[0]);
+    size_t numDecays = quick ? 1 : sizeof(decaySeconds) / sizeof(decaySeconds[0]);
+    size_t numLevels = quick ? 1 : sizeof(levels) / sizeof(levels[0]);
+
+    for (const BenchString &string : benchStrings) {
+        Summary minMaxSummary, streamingSummary;
+        int plucks = 0;
+
+        for (size_t n = 0; n < numNoises; n++) {
+            for (size_t t = 0; t < numDecays; t++) {
+                for (size_t l = 0; l < numLevels; l++) {
+                    float frequency = (float)midi_to_frequency(string.midiNote);
+                    PluckSpec spec = {
+                        .frequency = frequency,
+                        .decaySeconds = decaySeconds[t],
+                        .level = levels[l],
+                        .noiseDb = noiseDbs[n],
+                        .silenceSeconds = PLUCK_SILENCE_SECONDS,
+                        .durationSeconds = PLUCK_DURATION_SECONDS,
+                        .seed = seed++,
+                    };
+                    std::vector<uint32_t> words = quantize_to_adc_words(render_pluck(spec, TUNER_ADC_SAMPLE_RATE), 1.0f);
+
+                    NoiseGate gate(gateConfig);
+                    StreamingNormalizer normalizer = make_normalizer();
+                    Measurement minMax(frequency, TUNER_ADC_SAMPLE_RATE);
+                    Measurement streaming(frequency, TUNER_ADC_SAMPLE_RATE);
+                    alignas(ADC_FRAME_KERNEL_ALIGNMENT) float samples[TUNER_ADC_SAMPLES_PER_FRAME];
+
+                    for (size_t start = 0; start + frameSize <= words.size(); start += frameSize) {
+                        float minVal, maxVal;
+                        adc_frame_unpack(&words[start], frameSize, samples, &minVal, &maxVal);
+                        if (!gate.process(samples, frameSize, frameSeconds)) {
+                            if (gate.didJustClose()) {
+                                minMax.gap();
+                                streaming.gap();
+                            }
+                            continue;
+                        }
+                        if (gate.didJustOpen()) {
+                            normalizer.reset(gate.getDC(), gate.getEnvelope() * (float)M_SQRT2);
+                        }
+
+                        float scale, offset;
+                        adc_frame_normalizer(minVal, maxVal, &scale, &offset);
+                        for (size_t i = 0; i < frameSize; i++) {
+                            minMax.sample(samples[i] * scale + offset, start + i);
+                            streaming.sample(normalizer(samples[i]), start + i);
+                        }
+
+                        gatedSamples.insert(gatedSamples.end(), samples, samples + frameSize);
+                        gatedMin.push_back(minVal);
+                        gatedMax.push_back(maxVal);
+                    }
+
+                    plucks++;
+                    add(minMaxSummary, minMax.stats);
+                    add(streamingSummary, streaming.stats);
+                }
+            }
+        }
+
+        printf("%-10s %6d | %6.2fc %7.1fc %8d | %6.2fc %7.1fc %8d\n", string.name, plucks,
+            rms_cents(minMaxSummary), minMaxSummary.maxCents, minMaxSummary.numSlips,
+            rms_cents(streamingSummary), streamingSummary.maxCents, streamingSummary.numSlips);
+
+        add(minMaxTotal, minMaxSummary);
+        add(streamingTotal, streamingSummary);
+    }
+
+    printf("%-10s %6s | %6.2fc %7.1fc %8d | %6.2fc %7.1fc %8d\n", "all", "",
+        rms_cents(minMaxTotal), minMaxTotal.maxCents, minMaxTotal.numSlips,
+        rms_cents(streamingTotal), streamingTotal.maxCents, streamingTotal.numSlips);
+
+    // CPU cost: just the normalization of every gated frame, as the chain
+    // does it inside its per-sample loop.
+    size_t numFrames = gatedMin.size();
+    volatile float sink = 0;
+    double minMaxSeconds, streamingSeconds;
+    {
+        auto begin = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < TIMING_PASSES; pass++) {
+            float acc = 0;
+            for (size_t f = 0; f < numFrames; f++) {
+                float scale, offset;
+                adc_frame_normalizer(gatedMin[f], gatedMax[f], &scale, &offset);
+                const float *frame = &gatedSamples[f * frameSize];
+                for (size_t i = 0; i < frameSize; i++) {
+                    acc += frame[i] * scale + offset;
+                }
+            }
+            sink = sink + acc;
+        }
+        minMaxSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+    {
+        auto begin = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < TIMING_PASSES; pass++) {
+            StreamingNormalizer normalizer = make_normalizer();
+            float acc = 0;
+            for (size_t i = 0; i < gatedSamples.size(); i++) {
+                acc += normalizer(gatedSamples[i]);
+            }
+            sink = sink + acc;
+        }
+        streamingSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+    double numSamples = (double)gatedSamples.size() * TIMING_PASSES;
+    printf("\nper sample: min/max %.2f ns, streaming %.2f ns (%zu gated frames x %d passes)\n",
+        minMaxSeconds / numSamples * 1e9, streamingSeconds / numSamples * 1e9, numFrames, TIMING_PASSES);
+    return 0;
+}
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// gui_render_bench - Renders every tuner UI in available_guis
+// (main/tuning-ui/tuner_ui_list.cpp) with LVGL into a memory framebuffer and
+// reports what each frame costs:
+//   - ui: time spent in the UI's display_frequency()
+//   - render: time LVGL spends running timers/animations and drawing
+//   - dirty: pixels LVGL redrew (and flushed)
+//   - flushed: bytes the flush would send to the panel, pixel data plus the
+//     CASET/RASET/RAMWR window commands for every flush
+//   - commands: other panel commands sent by the UI (hardware scrolling)
+//
+// Every UI gets the same scripted scenes at the GUI task's frame rate, on a
+// simulated clock so animations and random note picks are reproducible:
+// silence, a string approaching pitch, holding in tune, changing strings and
+// the note fading out after the string is released.
+//
+// The display is set up like LVGL_Init() does on the pedal: 16-bit color,
+// partial render mode with the same draw buffer size.
+//
+// Usage: gui_render_bench [--ui <name>] [--landscape] [-o frames.csv]
+//                         [--png <dir>] [--png-every <n>]
+//
+//   --ui <name>        Only run the UI with this name (see get_name())
+//   --landscape        Run in landscape (320x240) instead of portrait
+//   -o <file>          Write one CSV row per frame to <file>
+//   --png <dir>        Write the screen as a PNG every --png-every frames
+//   --png-every <n>    Defaults to 10
+//
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "lvgl.h"
+
+#include "defines.h"
+#include "gui_shim.h"
+#include "note_mapper.h"
+#include "png_writer.h"
+#include "rgb444_kernel.h"
+#include "tuner_ui_list.h"
+#include "user_settings.h"
+
+#define BENCH_FRAME_MS              TUNER_GUI_MIN_FRAME_INTERVAL_MS
+#define BENCH_WINDOW_BYTES          (5 + 5 + 1) // CASET, RASET and RAMWR per flush
+#define BENCH_RANDOM_SEED           0x7e57
+
+// Globals the tuner UIs expect from the firmware (tuner_gui_task.cpp and
+// main.cpp).
+UserSettings *userSettings = nullptr;
+lv_coord_t screen_width = 0;
+lv_coord_t screen_height = 0;
+bool is_landscape = false;
+
+static constexpr NoteTable benchNoteTable = make_note_table(440.0);
+
+typedef struct {
+    uint32_t    flushes;
+    uint32_t    dirtyPixels;
+    uint32_t    flushedBytes;
+} FlushStats;
+
+static FlushStats flushStats = {};
+static std::vector<uint16_t> framebuffer;
+static int32_t framebufferWidth = 0;
+
+static void bench_flush_cb(lv_display_t *display, const lv_area_t *area, uint8_t *pxMap) {
+    int32_t width = lv_area_get_width(area);
+    int32_t height = lv_area_get_height(area);
+    uint32_t pixels = (uint32_t)(width * height);
+    flushStats.flushes++;
+    flushStats.dirtyPixels += pixels;
+    flushStats.flushedBytes += BENCH_WINDOW_BYTES + (LCD_RGB444 ? RGB444_PACKED_SIZE(pixels) : pixels * sizeof(uint16_t));
+
+    // Keep a copy of the whole screen for the PNG dumps
+    const uint16_t *src = (const uint16_t *)pxMap;
+    for (int32_t y = 0; y < height; y++) {
+        memcpy(&framebuffer[(area->y1 + y) * framebufferWidth + area->x1], &src[y * width], width * sizeof(uint16_t));
+    }
+    lv_display_flush_ready(display);
+}
+
+//
+// Scenes
+//
+
+typedef struct {
+    float       frequency;  // 0 when nothing is detected
+} BenchReading;
+
+typedef struct {
+    const char  *name;
+    int         frames;
+    BenchReading (*reading)(int frame);
+} BenchScene;
+
+// Deterministic jitter in -1..1 like the last digit of a real reading
+static float bench_jitter(int frame, int salt) {
+    uint32_t x = (uint32_t)(frame * 2654435761u) ^ (uint32_t)(salt * 40503u);
+    x ^= x >> 15;
+    x *= 0x2c1b3c6d;
+    x ^= x >> 12;
+    return (float)(x & 0xFFFF) / 32767.5f - 1.0f;
+}
+
+static float bench_midi_frequency(int midiNote, float cents) {
+    return benchNoteTable.targetFrequencies[midiNote] * powf(2.0f, cents / 1200.0f);
+}
+
+static BenchReading scene_silence(int) {
+    return { 0.0f };
+}
+
+// A2 tuned up from 40 cents flat
+static BenchReading scene_approach(int frame) {
+    float cents = -40.0f * expf(-(float)frame / 25.0f) + 0.3f * bench_jitter(frame, 1);
+    return { bench_midi_frequency(45, cents) };
+}
+
+static BenchReading scene_in_tune(int frame) {
+    return { bench_midi_frequency(45, 0.4f * bench_jitter(frame, 2)) };
+}
+
+// Each string of a guitar, plucked a little sharp and settling
+static BenchReading scene_note_changes(int frame) {
+    static const int strings[] = { 40, 45, 50, 55, 59, 64 };
+    const int framesPerString = 20;
+    int string = (frame / framesPerString) % (int)(sizeof(strings) / sizeof(strings[0]));
+    int stringFrame = frame % framesPerString;
+    float cents = 15.0f * expf(-(float)stringFrame / 6.0f) + 0.5f * bench_jitter(frame, 3);
+    return { bench_midi_frequency(strings[string], cents) };
+}
+
+// Slowly drifting around pitch while the string rings out
+static BenchReading scene_drift(int frame) {
+    float cents = 8.0f * sinf((float)frame / 15.0f) + 0.3f * bench_jitter(frame, 4);
+    return { bench_midi_frequency(52, cents) };
+}
+
+static const BenchScene benchScenes[] = {
+    { "silence",        30,     scene_silence },
+    { "approach",       90,     scene_approach },
+    { "in_tune",        90,     scene_in_tune },
+    { "note_changes",   120,    scene_note_changes },
+    { "drift",          90,     scene_drift },
+    { "release",        90,     scene_silence }, // Lets the note fade animations run
+};
+
+//
+// Running
+//
+
+typedef struct {
+    int         frames;
+    double      uiUs;
+    double      renderUs;
+    double      maxRenderUs;
+    uint64_t    dirtyPixels;
+    uint64_t    flushedBytes;
+    uint64_t    commandBytes;
+} SceneTotals;
+
+static std::string bench_file_name(const char *name) {
+    std::string result;
+    for (const char *c = name; *c != '\0'; c++) {
+        result += (*c == ' ') ? '_' : (char)tolower(*c);
+    }
+    return result;
+}
+
+static double bench_elapsed_us(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+int main(int argc, char *argv[]) {
+    const char *onlyUI = nullptr;
+    const char *outputPath = nullptr;
+    const char *pngDir = nullptr;
+    int pngEvery = 10;
+    bool landscape = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ui") == 0 && i + 1 < argc) {
+            onlyUI = argv[++i];
+        } else if (strcmp(argv[i], "--landscape") == 0) {
+            landscape = true;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (strcmp(argv[i], "--png") == 0 && i + 1 < argc) {
+            pngDir = argv[++i];
+        } else if (strcmp(argv[i], "--png-every") == 0 && i + 1 < argc) {
+            pngEvery = atoi(argv[++i]);
+            if (pngEvery < 1) {
+                pngEvery = 1;
+            }
+        } else {
+            fprintf(stderr, "Usage: gui_render_bench [--ui <name>] [--landscape] [-o frames.csv] [--png <dir>] [--png-every <n>]\n");
+            return 1;
+        }
+    }
+
+    FILE *csv = nullptr;
+    if (outputPath != nullptr) {
+        csv = fopen(outputPath, "w");
+        if (csv == nullptr) {
+            fprintf(stderr, "Unable to open %s\n", outputPath);
+            return 1;
+        }
+        fprintf(csv, "ui,scene,frame,ui_us,render_us,flushes,dirty_px,flushed_bytes,command_bytes\n");
+    }
+
+    UserSettings settings;
+    settings.displayOrientation = landscape ? orientationLeft : orientationNormal;
+    userSettings = &settings;
+
+    // Same resolution and rotation the panel (MADCTL) rotation gives LVGL
+    int32_t width = landscape ? LCD_V_RES : LCD_H_RES;
+    int32_t height = landscape ? LCD_H_RES : LCD_V_RES;
+    host_display_set_rotation(landscape ? LV_DISPLAY_ROTATION_90 : LV_DISPLAY_ROTATION_180);
+
+    lv_init();
+    lv_tick_set_cb(host_clock_ms);
+
+    framebuffer.assign(width * height, 0);
+    framebufferWidth = width;
+    std::vector<uint16_t> drawBuffer1(LCD_DRAWBUF_SIZE), drawBuffer2(LCD_DRAWBUF_SIZE);
+    lv_display_t *display = lv_display_create(width, height);
+    lv_display_set_color_format(display, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(display, drawBuffer1.data(), LCD_DOUBLE_BUFFER ? drawBuffer2.data() : nullptr,
+        LCD_DRAWBUF_SIZE * sizeof(uint16_t), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(display, bench_flush_cb);
+
+    // Set up the screen like the GUI task does
+    lv_obj_t *screen = lv_screen_active();
+    lv_obj_set_style_bg_color(screen, lv_color_black(), LV_PART_MAIN);
+    lv_obj_set_scrollbar_mode(screen, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_set_scroll_dir(screen, LV_DIR_NONE);
+    screen_width = lv_obj_get_width(screen);
+    screen_height = lv_obj_get_height(screen);
+    is_landscape = screen_width > screen_height;
+
+    uint32_t screenPixels = (uint32_t)(width * height);
+    printf("%dx%d, %d ms frames, %s\n", (int)width, (int)height, BENCH_FRAME_MS, LCD_RGB444 ? "12-bit flush" : "16-bit flush");
+    printf("%-14s %-13s %6s %9s %10s %10s %8s %10s %9s\n",
+        "ui", "scene", "frames", "ui us", "render us", "max us", "dirty%", "flushed KB", "cmd bytes");
+
+    int uisRun = 0;
+    for (size_t g = 0; g < num_of_available_guis; g++) {
+        TunerGUIInterface &gui = available_guis[g];
+        if (onlyUI != nullptr && strcmp(onlyUI, gui.get_name()) != 0) {
+            continue;
+        }
+        uisRun++;
+        host_random_seed(BENCH_RANDOM_SEED);
+        std::string fileName = bench_file_name(gui.get_name());
+
+        // Building the UI and drawing it the first time
+        flushStats = {};
+        host_panel_take_traffic();
+        auto start = std::chrono::steady_clock::now();
+        gui.init(screen);
+        lv_refr_now(display);
+        double initUs = bench_elapsed_us(start, std::chrono::steady_clock::now());
+        printf("%-14s %-13s %6d %9s %10.0f %10s %7.1f%% %10.1f %9u\n", gui.get_name(), "init", 1, "-", initUs, "-",
+            100.0 * flushStats.dirtyPixels / screenPixels, flushStats.flushedBytes / 1024.0, host_panel_take_traffic().bytes);
+
+        SceneTotals total = {};
+        for (const BenchScene &scene : benchScenes) {
+            SceneTotals totals = {};
+            for (int frame = 0; frame < scene.frames; frame++) {
+                host_clock_advance_ms(BENCH_FRAME_MS);
+                BenchReading reading = scene.reading(frame);
+                flushStats = {};
+
+                // Called the same way the GUI task calls it
+                auto frameStart = std::chrono::steady_clock::now();
+                FrequencyInfo info = {};
+                if (reading.frequency > 0 && note_mapper_map(benchNoteTable, reading.frequency, &info)) {
+                    gui.display_frequency(info.frequency, info.frequency, info.targetNote, info.targetOctave, info.cents, false);
+                } else {
+                    gui.display_frequency(0, 0, NOTE_NONE, 0, 0, false);
+                }
+                auto uiEnd = std::chrono::steady_clock::now();
+                lv_timer_handler();
+                lv_refr_now(display);
+                auto renderEnd = std::chrono::steady_clock::now();
+
+                double uiUs = bench_elapsed_us(frameStart, uiEnd);
+                double renderUs = bench_elapsed_us(uiEnd, renderEnd);
+                HostPanelTraffic traffic = host_panel_take_traffic();
+
+                totals.frames++;
+                totals.uiUs += uiUs;
+                totals.renderUs += renderUs;
+                totals.maxRenderUs = renderUs > totals.maxRenderUs ? renderUs : totals.maxRenderUs;
+                totals.dirtyPixels += flushStats.dirtyPixels;
+                totals.flushedBytes += flushStats.flushedBytes;
+                totals.commandBytes += traffic.bytes;
+
+                if (csv != nullptr) {
+                    fprintf(csv, "%s,%s,%d,%.1f,%.1f,%u,%u,%u,%u\n", gui.get_name(), scene.name, frame, uiUs, renderUs,
+                        flushStats.flushes, flushStats.dirtyPixels, flushStats.flushedBytes, traffic.bytes);
+                }
+                if (pngDir != nullptr && frame % pngEvery == 0) {
+                    char path[512];
+                    snprintf(path, sizeof(path), "%s/%s_%s_%03d.png", pngDir, fileName.c_str(), scene.name, frame);
+                    if (!png_write_rgb565(path, framebuffer.data(), width, height)) {
+                        fprintf(stderr, "Unable to write %s\n", path);
+                    }
+                }
+            }
+
+            printf("%-14s %-13s %6d %9.1f %10.1f %10.1f %7.1f%% %10.1f %9.1f\n", gui.get_name(), scene.name, totals.frames,
+                totals.uiUs / totals.frames, totals.renderUs / totals.frames, totals.maxRenderUs,
+                100.0 * totals.dirtyPixels / ((double)screenPixels * totals.frames),
+                totals.flushedBytes / 1024.0 / totals.frames, (double)totals.commandBytes / totals.frames);
+
+            total.frames += totals.frames;
+            total.uiUs += totals.uiUs;
+            total.renderUs += totals.renderUs;
+            total.maxRenderUs = totals.maxRenderUs > total.maxRenderUs ? totals.maxRenderUs : total.maxRenderUs;
+            total.dirtyPixels += totals.dirtyPixels;
+            total.flushedBytes += totals.flushedBytes;
+            total.commandBytes += totals.commandBytes;
+        }
+        printf("%-14s %-13s %6d %9.1f %10.1f %10.1f %7.1f%% %10.1f %9.1f\n\n", gui.get_name(), "all", total.frames,
+            total.uiUs / total.frames, total.renderUs / total.frames, total.maxRenderUs,
+            100.0 * total.dirtyPixels / ((double)screenPixels * total.frames),
+            total.flushedBytes / 1024.0 / total.frames, (double)total.commandBytes / total.frames);
+
+        // Switch UIs the way the GUI task does
+        gui.cleanup();
+        lv_obj_clean(screen);
+        lv_refr_now(display);
+    }
+
+    if (csv != nullptr) {
+        fclose(csv);
+    }
+    if (uisRun == 0) {
+        fprintf(stderr, "No tuner UI named \"%s\"\n", onlyUI);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "gui_shim.h"
+
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "waveshare.h"
+
+static int64_t host_clock_us = 0;
+static uint32_t host_random_state = 1;
+static lv_display_rotation_t host_rotation = LV_DISPLAY_ROTATION_0;
+static HostPanelTraffic host_traffic = {};
+
+// Same sizes as the ST7789T commands in Vernon_ST7789T.c
+#define HOST_VSCRDEF_BYTES  (1 + 6)
+#define HOST_VSCSAD_BYTES   (1 + 2)
+#define HOST_NORON_BYTES    1
+
+void host_clock_advance_ms(uint32_t ms) {
+    host_clock_us += (int64_t)ms * 1000;
+}
+
+uint32_t host_clock_ms() {
+    return (uint32_t)(host_clock_us / 1000);
+}
+
+void host_random_seed(uint32_t seed) {
+    host_random_state = seed != 0 ? seed : 1;
+}
+
+void host_display_set_rotation(lv_display_rotation_t rotation) {
+    host_rotation = rotation;
+}
+
+HostPanelTraffic host_panel_take_traffic() {
+    HostPanelTraffic traffic = host_traffic;
+    host_traffic = {};
+    return traffic;
+}
+
+static void host_panel_command(uint32_t bytes) {
+    host_traffic.commands++;
+    host_traffic.bytes += bytes;
+}
+
+extern "C" int64_t esp_timer_get_time(void) {
+    return host_clock_us;
+}
+
+extern "C" uint32_t esp_random(void) {
+    // xorshift32
+    uint32_t x = host_random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    host_random_state = x;
+    return x;
+}
+
+extern "C" lv_display_rotation_t lcd_display_get_rotation() {
+    return host_rotation;
+}
+
+extern "C" esp_err_t lcd_display_scroll_area_set(uint16_t first_line, uint16_t num_lines) {
+    (void)first_line;
+    (void)num_lines;
+    host_panel_command(HOST_VSCRDEF_BYTES);
+    return ESP_OK;
+}
+
+extern "C" esp_err_t lcd_display_scroll_offset_set(uint16_t offset) {
+    (void)offset;
+    host_panel_command(HOST_VSCSAD_BYTES);
+    return ESP_OK;
+}
+
+extern "C" esp_err_t lcd_display_scroll_reset() {
+    host_panel_command(HOST_VSCRDEF_BYTES);
+    host_panel_command(HOST_VSCSAD_BYTES);
+    host_panel_command(HOST_NORON_BYTES);
+    return ESP_OK;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_HOST_GUI_SHIM)
+#define TUNER_HOST_GUI_SHIM
+
+#include <stdint.h>
+
+#include "lvgl.h"
+
+//
+// Host side of the ESP-IDF shims in this directory. The tuner UIs see a
+// simulated clock that only moves when the benchmark advances it, a seeded
+// esp_random() and a panel that counts the commands sent to it.
+//
+
+typedef struct {
+    uint32_t commands;
+    uint32_t bytes;     // Command and parameter bytes
+} HostPanelTraffic;
+
+void host_clock_advance_ms(uint32_t ms);
+uint32_t host_clock_ms();
+
+void host_random_seed(uint32_t seed);
+
+void host_display_set_rotation(lv_display_rotation_t rotation);
+
+/// @brief Returns the panel commands sent by the UI (other than the pixel
+/// data that goes through the flush) since the last call.
+HostPanelTraffic host_panel_take_traffic();
+
+#endif
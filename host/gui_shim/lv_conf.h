@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// LVGL configuration for the host render benchmark. Mirrors the LVGL
+// settings in sdkconfig.defaults so the tuner UIs draw the same way they do
+// on the pedal, everything else is left at LVGL's defaults.
+//
+#if 1
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH              16
+
+#define LV_USE_STDLIB_MALLOC        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_STRING        LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_SPRINTF       LV_STDLIB_CLIB
+
+// The benchmark drives LVGL from one thread
+#define LV_USE_OS                   LV_OS_NONE
+
+#define LV_DEF_REFR_PERIOD          33
+#define LV_CACHE_DEF_SIZE           400000
+#define LV_COLOR_MIX_ROUND_OFS      128
+
+#define LV_FONT_MONTSERRAT_14       1
+#define LV_FONT_MONTSERRAT_18       1
+#define LV_FONT_MONTSERRAT_24       1
+#define LV_FONT_MONTSERRAT_48       1
+#define LV_FONT_DEFAULT             &lv_font_montserrat_14
+
+#define LV_USE_OBSERVER             1
+#define LV_USE_THEME_DEFAULT        1
+#define LV_THEME_DEFAULT_DARK       1
+
+#define LV_USE_SYSMON               0
+#define LV_USE_PERF_MONITOR         0
+
+#endif
+#endif
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_USER_SETTINGS)
+#define TUNER_USER_SETTINGS
+
+#include <cstdint>
+
+#include "lvgl.h"
+#include "defines.h"
+
+// Host stand-in for main/user_settings.h. The real one pulls in NVS and the
+// settings menus, the tuner UIs only read these few settings.
+
+enum TunerOrientation: uint8_t {
+    orientationNormal = 0,
+    orientationLeft,
+    orientationRight,
+    orientationUpsideDown,
+};
+
+class UserSettings {
+public:
+    uint8_t             inTuneCentsWidth        = DEFAULT_IN_TUNE_CENTS_WIDTH;
+    lv_palette_t        noteNamePalette         = DEFAULT_NOTE_NAME_PALETTE;
+    TunerOrientation    displayOrientation      = orientationNormal;
+};
+
+#endif
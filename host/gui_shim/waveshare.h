@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "lvgl.h"
+
+// The display functions the tuner UIs call, implemented in gui_shim.cpp.
+// Panel commands are counted instead of being sent anywhere.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+lv_display_rotation_t lcd_display_get_rotation();
+esp_err_t lcd_display_scroll_area_set(uint16_t first_line, uint16_t num_lines);
+esp_err_t lcd_display_scroll_offset_set(uint16_t offset);
+esp_err_t lcd_display_scroll_reset();
+
+#ifdef __cplusplus
+}
+#endif
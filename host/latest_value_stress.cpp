@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// latest_value_stress - Hammers LatestValue<FrequencyInfo> (the cell the
+// pitch detector publishes readings through) with one writer thread and
+// several reader threads.
+//
+// Every published FrequencyInfo is derived from a single counter so a reader
+// can tell if it ever saw a torn value (fields from two different publishes).
+// Readers also check that versions never go backwards and that a version
+// always comes with the value that was published under it.
+//
+// Usage: latest_value_stress [--seconds <n>] [--readers <n>]
+//
+// Exits with 1 if any torn or out-of-order read was seen. Run it on a
+// multi-core machine; on a single core it mostly exercises readers that give
+// up because the writer was preempted in the middle of a publish.
+//
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "defines.h"
+#include "LatestValue.hpp"
+
+// Float counters stay exact up to 2^24.
+#define READING_MASK    0xFFFFFF
+
+static LatestValue<FrequencyInfo> latest;
+static std::atomic<bool> running(true);
+
+static FrequencyInfo make_reading(uint32_t n) {
+    FrequencyInfo info;
+    memset(&info, 0, sizeof(info)); // Padding too, so values can be compared with memcmp
+    info.frequency = (float)n;
+    info.cents = (float)(n % 101) - 50.0f;
+    info.targetFrequency = (float)n * 2.0f;
+    info.targetNote = (TunerNoteName)(n % 12);
+    info.targetOctave = (int)(n % 9);
+    info.timestampUs = (int64_t)n * 1000;
+    return info;
+}
+
+static bool is_consistent(const FrequencyInfo &info) {
+    FrequencyInfo expected = make_reading((uint32_t)info.frequency);
+    return memcmp(&info, &expected, sizeof(FrequencyInfo)) == 0;
+}
+
+typedef struct {
+    uint64_t reads;
+    uint64_t newReads;
+    uint64_t failedReads;
+    uint64_t torn;
+    uint64_t outOfOrder;
+} ReaderStats;
+
+static void reader(ReaderStats *stats) {
+    uint32_t lastVersion = 0;
+    FrequencyInfo info;
+    while (running.load(std::memory_order_relaxed)) {
+        stats->reads++;
+        if (latest.getVersion() == lastVersion) {
+            continue; // Nothing new
+        }
+        uint32_t version;
+        if (!latest.read(info, &version)) {
+            stats->failedReads++; // Overlapped a write on every attempt
+            continue;
+        }
+        stats->newReads++;
+        if (!is_consistent(info)) {
+            stats->torn++;
+        }
+        // Reading n is published as version n.
+        if (version < lastVersion || (uint32_t)info.frequency != (version & READING_MASK)) {
+            stats->outOfOrder++;
+        }
+        lastVersion = version;
+    }
+}
+
+int main(int argc, char **argv) {
+    int seconds = 5;
+    int numReaders = 3;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--readers") == 0 && i + 1 < argc) {
+            numReaders = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--seconds <n>] [--readers <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<ReaderStats> stats(numReaders);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < numReaders; i++) {
+        stats[i] = {};
+        readers.emplace_back(reader, &stats[i]);
+    }
+
+    // Publish in bursts with short pauses between them so readers see both
+    // back-to-back writes and quiet periods, like the detector's output.
+    uint32_t published = 0;
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    while (std::chrono::steady_clock::now() < end) {
+        for (int i = 0; i < 1000; i++) {
+            published++;
+            latest.publish(make_reading(published & READING_MASK));
+            for (uint32_t spin = 0; spin < (published % 257); spin++) {
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+            }
+        }
+    }
+    running = false;
+    for (std::thread &t : readers) {
+        t.join();
+    }
+
+    uint64_t torn = 0, outOfOrder = 0;
+    printf("Published %u values\n", published);
+    for (int i = 0; i < numReaders; i++) {
+        printf("  reader %d: %llu reads, %llu new, %llu gave up, %llu torn, %llu out of order\n", i,
+            (unsigned long long)stats[i].reads, (unsigned long long)stats[i].newReads,
+            (unsigned long long)stats[i].failedReads, (unsigned long long)stats[i].torn,
+            (unsigned long long)stats[i].outOfOrder);
+        torn += stats[i].torn;
+        outOfOrder += stats[i].outOfOrder;
+    }
+    printf("%s\n", (torn == 0 && outOfOrder == 0) ? "PASS" : "FAIL");
+    return (torn == 0 && outOfOrder == 0) ? 0 : 1;
+}
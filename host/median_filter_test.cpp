@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// median_filter_test - Checks the two-heap rolling median
+// (main/utils/MedianFilter.hpp) against brute force: every value's median is
+// compared with the middle of a sorted copy of the window.
+//   - every window size from 1 to 24 (even and out-of-range sizes are made
+//     odd and clamped the same way) in moving and block mode
+//   - random values, values with lots of duplicates and slow ramps, so ties
+//     and values moving between the two heaps are covered
+//   - reset() and setWindowSize() in the middle of a stream
+//   - a larger Capacity than MAX_MEDIAN_WINDOW_SIZE
+//
+// Usage: median_filter_test
+//
+// Exits with 1 if any check fails.
+//
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "MedianFilter.hpp"
+
+#define VALUES_PER_RUN  2000
+
+/// @brief The window size `MedianFilter::setWindowSize()` ends up with.
+static size_t expected_window_size(size_t size, size_t capacity) {
+    if (size % 2 == 0) {
+        size++;
+    }
+    size = std::min(size, capacity);
+    if (size % 2 == 0) {
+        size--;
+    }
+    return std::max(size, MIN_MEDIAN_WINDOW_SIZE);
+}
+
+/// @brief What MedianFilter should return, worked out by sorting the window
+/// every time.
+class BruteForceMedian {
+public:
+    BruteForceMedian(size_t windowSize, bool useMovingMode) : windowSize(windowSize), useMovingMode(useMovingMode) {}
+
+    float addValue(float value) {
+        window.push_back(value);
+        if (window.size() > windowSize) {
+            window.pop_front();
+        }
+        if (!useMovingMode && window.size() < windowSize) {
+            return -1;
+        }
+        std::vector<float> sorted(window.begin(), window.end());
+        std::sort(sorted.begin(), sorted.end());
+        float result = sorted[sorted.size() / 2]; // The upper middle value while an even window fills
+        if (!useMovingMode) {
+            window.clear();
+        }
+        return result;
+    }
+
+    void reset() { window.clear(); }
+
+private:
+    size_t windowSize;
+    bool useMovingMode;
+    std::deque<float> window;
+};
+
+static std::mt19937 rng(0x3ed1a);
+
+static float next_value(int kind, int i) {
+    switch (kind) {
+        case 0:  return std::uniform_real_distribution<float>(-1000, 1000)(rng);  // anything
+        case 1:  return (float)(rng() % 5);                                        // lots of ties
+        default: return 110.0f + 0.01f * (float)(i % 300) - (float)(rng() % 3);   // a drifting pitch
+    }
+}
+
+/// @return Returns the number of failed checks.
+template <size_t Capacity>
+static int check(size_t requestedSize, bool useMovingMode, int kind) {
+    MedianFilter<Capacity> filter(requestedSize, useMovingMode);
+    size_t windowSize = expected_window_size(requestedSize, Capacity);
+    if (filter.getWindowSize() != windowSize) {
+        fprintf(stderr, "FAIL: window size %zu became %zu, expected %zu\n", requestedSize, filter.getWindowSize(), windowSize);
+        return 1;
+    }
+
+    BruteForceMedian reference(windowSize, useMovingMode);
+    for (int i = 0; i < VALUES_PER_RUN; i++) {
+        if (i == VALUES_PER_RUN / 3) {
+            filter.reset();
+            reference.reset();
+        }
+        if (i == 2 * VALUES_PER_RUN / 3) {
+            // Start over with a different window.
+            windowSize = expected_window_size(requestedSize + 4, Capacity);
+            filter.setWindowSize(requestedSize + 4);
+            reference = BruteForceMedian(windowSize, useMovingMode);
+        }
+
+        float value = next_value(kind, i);
+        float got = filter.addValue(value);
+        float expected = reference.addValue(value);
+        if (got != expected) {
+            fprintf(stderr, "FAIL: capacity %zu, window %zu, %s mode, kind %d: value %d gave %g, expected %g\n",
+                Capacity, windowSize, useMovingMode ? "moving" : "block", kind, i, got, expected);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main() {
+    int failures = 0;
+    int runs = 0;
+    for (size_t size = 1; size <= 24; size++) {
+        for (int mode = 0; mode < 2; mode++) {
+            for (int kind = 0; kind < 3; kind++) {
+                failures += check<MAX_MEDIAN_WINDOW_SIZE>(size, mode == 0, kind);
+                runs++;
+            }
+        }
+    }
+    for (size_t size : { 25, 51, 63 }) {
+        for (int kind = 0; kind < 3; kind++) {
+            failures += check<63>(size, true, kind);
+            failures += check<63>(size, false, kind);
+            runs += 2;
+        }
+    }
+
+    if (failures > 0) {
+        printf("%d of %d runs failed\n", failures, runs);
+        return 1;
+    }
+    printf("OK (%d runs of %d values)\n", runs, VALUES_PER_RUN);
+    return 0;
+}
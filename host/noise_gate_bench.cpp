@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// noise_gate_bench - Runs decaying synthetic plucks through the noise gate in
+// front of the pitch detector (main/utils/NoiseGate.hpp) and through the
+// fixed 600 count peak-to-peak gate it replaced, frame by frame like
+// `PitchDetectorChain::processFrame()`.
+//
+// For every string it reports, for both gates:
+//   - held: time from the pluck until the gate first closes again, which is
+//     as long as the detector can possibly stay locked
+//   - reopens: how often the gate closed and opened again during the pluck.
+//     Every one of these resets the detector and both 1EU filters.
+//   - false: frames the gate was open during the silence before the pluck
+//
+// Usage: noise_gate_bench [--quick]
+//
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "adc_frame_kernel.h"
+#include "defines.h"
+#include "NoiseGate.hpp"
+#include "pluck_synth.h"
+#include "wav_file.h"
+
+#define OLD_GATE_MINIMUM            600     // The old TUNER_READING_DIFF_MINIMUM
+#define PLUCK_SILENCE_SECONDS       2.0f    // Long enough for the floor to be learned
+#define PLUCK_DURATION_SECONDS      8.0f
+#define CORPUS_SEED                 0x6a7e
+
+typedef struct {
+    const char  *name;
+    int         midiNote;
+} BenchString;
+
+static const BenchString benchStrings[] = {
+    { "Bass B0",     23 },
+    { "Bass E1",     28 },
+    { "Bass A1",     33 },
+    { "Bass D2",     38 },
+    { "Gtr E2",      40 },
+    { "Gtr A2",      45 },
+    { "Gtr D3",      50 },
+    { "Gtr G3",      55 },
+    { "Gtr E4",      64 },
+    { "Harm E5",     76 },
+};
+
+static const float noiseDbs[] = { -200, -45, -30 };
+static const float decaySeconds[] = { 1.5f, 6.0f };
+static const float levels[] = { 1.0f, 0.35f };
+
+typedef struct {
+    bool    opened;
+    double  heldSeconds;
+    int     reopens;
+    int     falseFrames;
+} GateResult;
+
+/// Tracks one gate through a pluck.
+class GateTracker {
+public:
+    void frame(bool open, double frameEnd) {
+        if (frameEnd <= 0) {
+            if (open) {
+                result.falseFrames++;
+            }
+        } else if (open && !wasOpen) {
+            if (!result.opened) {
+                result.opened = true;
+            } else {
+                result.reopens++;
+            }
+        } else if (!open && wasOpen && result.opened && !closed) {
+            closed = true;
+            result.heldSeconds = frameEnd;
+        }
+        wasOpen = open;
+    }
+
+    GateResult finish(double endSeconds) {
+        if (result.opened && !closed) {
+            result.heldSeconds = endSeconds; // Still open at the end
+        }
+        return result;
+    }
+
+private:
+    GateResult result = {};
+    bool wasOpen = false;
+    bool closed = false;
+};
+
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return NAN;
+    }
+    std::sort(values.begin(), values.end());
+    size_t index = (size_t)std::min((double)values.size() - 1, floor(p * values.size()));
+    return values[index];
+}
+
+static double midi_to_frequency(int midiNote) {
+    return A4_FREQ * pow(2.0, (midiNote - 69) / 12.0);
+}
+
+typedef struct {
+    std::vector<double> held;
+    int reopens = 0;
+    int falseFrames = 0;
+    int unopened = 0;
+} GateSummary;
+
+static void add(GateSummary &summary, const GateResult &result) {
+    if (!result.opened) {
+        summary.unopened++;
+        return;
+    }
+    summary.held.push_back(result.heldSeconds);
+    summary.reopens += result.reopens;
+    summary.falseFrames += result.falseFrames;
+}
+
+int main(int argc, char *argv[]) {
+    bool quick = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else {
+            fprintf(stderr, "Usage: noise_gate_bench [--quick]\n");
+            return 1;
+        }
+    }
+
+    const float frameSeconds = (float)TUNER_ADC_SAMPLES_PER_FRAME / TUNER_ADC_SAMPLE_RATE;
+    const NoiseGateConfig config = TUNER_GATE_CONFIG;
+
+    printf("%-10s %6s | %-29s | %-29s\n", "", "", "old (600 p-p)", "noise gate");
+    printf("%-10s %6s | %8s %8s %5s %5s | %8s %8s %5s %5s\n", "string", "plucks",
+        "held p10", "held p50", "reop", "false", "held p10", "held p50", "reop", "false");
+
+    GateSummary oldTotal, newTotal;
+    uint32_t seed = CORPUS_SEED;
+    size_t numNoises = quick ? 1 : sizeof(noiseDbs) / sizeof(noiseDbs[0]);
+    size_t numDecays = quick ? 1 : sizeof(decaySeconds) / sizeof(decaySeconds[0]);
+    size_t numLevels = quick ? 1 : sizeof(levels) / sizeof(levels[0]);
+
+    for (const BenchString &string : benchStrings) {
+        GateSummary oldSummary, newSummary;
+        int plucks = 0;
+
+        for (size_t n = 0; n < numNoises; n++) {
+            for (size_t t = 0; t < numDecays; t++) {
+                for (size_t l = 0; l < numLevels; l++) {
+                    PluckSpec spec = {
+                        .frequency = (float)midi_to_frequency(string.midiNote),
+                        .decaySeconds = decaySeconds[t],
+                        .level = levels[l],
+                        .noiseDb = noiseDbs[n],
+                        .silenceSeconds = PLUCK_SILENCE_SECONDS,
+                        .durationSeconds = PLUCK_DURATION_SECONDS,
+                        .seed = seed++,
+                    };
+                    std::vector<uint32_t> words = quantize_to_adc_words(render_pluck(spec, TUNER_ADC_SAMPLE_RATE), 1.0f);
+
+                    NoiseGate gate(config);
+                    GateTracker oldTracker, newTracker;
+                    alignas(ADC_FRAME_KERNEL_ALIGNMENT) float samples[TUNER_ADC_SAMPLES_PER_FRAME];
+                    for (size_t start = 0; start + TUNER_ADC_SAMPLES_PER_FRAME <= words.size(); start += TUNER_ADC_SAMPLES_PER_FRAME) {
+                        double frameEnd = (double)start / TUNER_ADC_SAMPLE_RATE + frameSeconds - PLUCK_SILENCE_SECONDS;
+                        float minVal, maxVal;
+                        adc_frame_unpack(&words[start], TUNER_ADC_SAMPLES_PER_FRAME, samples, &minVal, &maxVal);
+
+                        oldTracker.frame(maxVal - minVal >= OLD_GATE_MINIMUM, frameEnd);
+                        newTracker.frame(gate.process(samples, TUNER_ADC_SAMPLES_PER_FRAME, frameSeconds), frameEnd);
+                    }
+
+                    plucks++;
+                    add(oldSummary, oldTracker.finish(PLUCK_DURATION_SECONDS));
+                    add(newSummary, newTracker.finish(PLUCK_DURATION_SECONDS));
+                }
+            }
+        }
+
+        printf("%-10s %6d | %6.0fms %6.0fms %5d %5d | %6.0fms %6.0fms %5d %5d",
+            string.name, plucks,
+            percentile(oldSummary.held, 0.1) * 1000, percentile(oldSummary.held, 0.5) * 1000,
+            oldSummary.reopens, oldSummary.falseFrames,
+            percentile(newSummary.held, 0.1) * 1000, percentile(newSummary.held, 0.5) * 1000,
+            newSummary.reopens, newSummary.falseFrames);
+        if (oldSummary.unopened > 0 || newSummary.unopened > 0) {
+            printf("  (never opened: old %d, new %d)", oldSummary.unopened, newSummary.unopened);
+        }
+        printf("\n");
+
+        oldTotal.held.insert(oldTotal.held.end(), oldSummary.held.begin(), oldSummary.held.end());
+        newTotal.held.insert(newTotal.held.end(), newSummary.held.begin(), newSummary.held.end());
+        oldTotal.reopens += oldSummary.reopens;
+        newTotal.reopens += newSummary.reopens;
+        oldTotal.falseFrames += oldSummary.falseFrames;
+        newTotal.falseFrames += newSummary.falseFrames;
+    }
+
+    printf("%-10s %6s | %6.0fms %6.0fms %5d %5d | %6.0fms %6.0fms %5d %5d\n", "all", "",
+        percentile(oldTotal.held, 0.1) * 1000, percentile(oldTotal.held, 0.5) * 1000, oldTotal.reopens, oldTotal.falseFrames,
+        percentile(newTotal.held, 0.1) * 1000, percentile(newTotal.held, 0.5) * 1000, newTotal.reopens, newTotal.falseFrames);
+    return 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// note_mapper_bench - Compares the table-driven note mapper in
+// main/note_mapper.h against the original libm (double precision)
+// get_frequency_info() and times both.
+//
+// The sweep walks every float from C0 (16.35 Hz) up to C8 (4186 Hz) in
+// fixed steps of `--step` ULPs (1 = every representable float) and reports:
+//   - note mismatches away from a note boundary
+//   - mismatches within 0.01 cent of a boundary (rounding ties, expected)
+//   - octave differences. The old `(closest_semitone + 9) / 12` truncates
+//     toward zero so every note below C4 other than a C was reported one
+//     octave too high.
+//   - the largest cents difference for frequencies mapped to the same note
+//
+// Usage: note_mapper_bench [--step <ulps>] [--iterations <n>]
+//
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "defines.h"
+#include "note_mapper.h"
+
+#define SWEEP_LOW_FREQ          16.351598f  // C0
+#define SWEEP_HIGH_FREQ         4186.009f   // C8
+#define BOUNDARY_TOLERANCE      0.01f       // cents
+#define TIMING_SAMPLES          4096
+
+static constexpr NoteTable noteTable = make_note_table(A4_FREQ);
+
+// The implementation get_frequency_info() used before the note mapper.
+static bool libm_frequency_info(float input_freq, FrequencyInfo *freqInfo) {
+    if (input_freq <= 0) {
+        return false;
+    }
+    float semitone_offset = 12 * log2(input_freq / A4_FREQ);
+    int closest_semitone = (int)round(semitone_offset);
+    int note_index = (closest_semitone + 9) % 12;
+    if (note_index < 0) {
+        note_index += 12;
+    }
+    int octave = 4 + ((closest_semitone + 9) / 12);
+    float closest_note_freq = A4_FREQ * pow(2.0, closest_semitone / 12.0);
+    freqInfo->frequency = input_freq;
+    freqInfo->targetFrequency = closest_note_freq;
+    freqInfo->cents = 1200 * log2(input_freq / closest_note_freq);
+    freqInfo->targetNote = (TunerNoteName)note_index;
+    freqInfo->targetOctave = octave;
+    return true;
+}
+
+static bool table_frequency_info(float input_freq, FrequencyInfo *freqInfo) {
+    return note_mapper_map(noteTable, input_freq, freqInfo);
+}
+
+static float next_float(float f, uint32_t ulps) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    bits += ulps;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+template <typename Mapper>
+static double time_mapper(Mapper mapper, const std::vector<float> &input, int iterations) {
+    FrequencyInfo info;
+    volatile float sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        for (float f : input) {
+            mapper(f, &info);
+            sink = sink + info.cents;
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    return elapsed.count() / ((double)iterations * input.size());
+}
+
+int main(int argc, char **argv) {
+    uint32_t step = 1;
+    int iterations = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--step") == 0 && i + 1 < argc) {
+            step = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--step <ulps>] [--iterations <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (step == 0) {
+        step = 1;
+    }
+
+    uint64_t compared = 0;
+    uint64_t boundaryMismatches = 0;
+    uint64_t mismatches = 0;
+    uint64_t octaveFixes = 0;
+    float maxCentsDiff = 0;
+    float maxCentsDiffFreq = 0;
+    for (float f = SWEEP_LOW_FREQ; f < SWEEP_HIGH_FREQ; f = next_float(f, step)) {
+        FrequencyInfo expected = {}, actual = {};
+        libm_frequency_info(f, &expected);
+        if (!table_frequency_info(f, &actual)) {
+            mismatches++;
+            continue;
+        }
+        compared++;
+        if (expected.targetNote != actual.targetNote) {
+            if (fabsf(fabsf(expected.cents) - 50.0f) <= BOUNDARY_TOLERANCE) {
+                boundaryMismatches++;
+            } else {
+                if (mismatches < 10) {
+                    printf("MISMATCH %.6f Hz: libm %s %+.4f, table %s %+.4f\n", f,
+                        name_for_note(expected.targetNote), expected.cents,
+                        name_for_note(actual.targetNote), actual.cents);
+                }
+                mismatches++;
+            }
+            continue;
+        }
+        if (expected.targetOctave != actual.targetOctave) {
+            octaveFixes++;
+        }
+        float diff = fabsf(expected.cents - actual.cents);
+        if (diff > maxCentsDiff) {
+            maxCentsDiff = diff;
+            maxCentsDiffFreq = f;
+        }
+    }
+
+    printf("Compared %llu frequencies (every %u ULPs, C0 - C8)\n", (unsigned long long)compared, step);
+    printf("  note mismatches:          %llu\n", (unsigned long long)mismatches);
+    printf("  boundary ties (< %.2f c): %llu\n", BOUNDARY_TOLERANCE, (unsigned long long)boundaryMismatches);
+    printf("  octaves corrected:        %llu\n", (unsigned long long)octaveFixes);
+    printf("  max cents difference:     %.5f (at %.4f Hz)\n", maxCentsDiff, maxCentsDiffFreq);
+
+    // Below C0 the old code could even produce octave 0 or 1 for C-1 notes.
+    FrequencyInfo low;
+    if (table_frequency_info(10.0f, &low)) {
+        printf("  10 Hz maps to:            %s%d %+.2f\n", name_for_note(low.targetNote), low.targetOctave, low.cents);
+    }
+
+    std::vector<float> input(TIMING_SAMPLES);
+    srand(1);
+    for (float &f : input) {
+        f = 30.0f + 2000.0f * (float)rand() / (float)RAND_MAX;
+    }
+    double libmNs = time_mapper(libm_frequency_info, input, iterations);
+    double tableNs = time_mapper(table_frequency_info, input, iterations);
+    printf("\nTiming (%d calls each)\n", iterations * TIMING_SAMPLES);
+    printf("  libm double:              %.2f ns/call\n", libmNs);
+    printf("  note mapper:              %.2f ns/call (%.1fx)\n", tableNs, libmNs / tableNs);
+
+    return (mismatches == 0 && maxCentsDiff < BOUNDARY_TOLERANCE) ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// one_euro_bench - Times the 1EU filter on the same workload the pitch
+// detector gives it: one reading per detected period with a reset() every
+// time the input drops below the gate.
+//
+// Three versions are compared:
+//   - legacy: the original double-precision filter that allocated its low
+//     pass filters with new/delete (reproduced below for reference)
+//   - OneEuroFilter<double>
+//   - OneEuroFilter<float> (what the firmware uses)
+//
+// It also reports how far the float output drifts from the legacy output in
+// cents, which should be far below anything the UI can show.
+//
+// Usage: one_euro_bench [--iterations <n>]
+//
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "defines.h"
+#include "OneEuroFilter.hpp"
+
+#define READINGS_PER_PLUCK      400     // ~2 s of an A2 string
+#define PLUCKS                  32
+
+// The filter as it was before OneEuroFilter.hpp, trimmed to what the pitch
+// detector used.
+class LegacyLowPassFilter {
+    double y, a, s;
+    bool initialized;
+public:
+    LegacyLowPassFilter(double alpha) : y(0), a(alpha), s(0), initialized(false) {}
+    double filterWithAlpha(double value, double alpha) {
+        a = (alpha <= 0.0 || alpha > 1.0) ? 0.0 : alpha;
+        double result = initialized ? a * value + (1.0 - a) * s : value;
+        initialized = true;
+        y = value;
+        s = result;
+        return result;
+    }
+    bool hasLastRawValue() { return initialized; }
+    double lastFilteredValue() { return s; }
+};
+
+class LegacyOneEuroFilter {
+    double freq, mincutoff, beta_, dcutoff;
+    LegacyLowPassFilter *x;
+    LegacyLowPassFilter *dx;
+    double lasttime;
+
+    double alpha(double cutoff) {
+        double te = 1.0 / freq;
+        double tau = 1.0 / (2 * M_PI * cutoff);
+        return 1.0 / (1.0 + tau / te);
+    }
+public:
+    LegacyOneEuroFilter(double freq, double mincutoff, double beta_, double dcutoff)
+        : freq(freq), mincutoff(mincutoff), beta_(beta_), dcutoff(dcutoff), lasttime(-1.0) {
+        x = new LegacyLowPassFilter(alpha(mincutoff));
+        dx = new LegacyLowPassFilter(alpha(dcutoff));
+    }
+    ~LegacyOneEuroFilter() {
+        delete x;
+        delete dx;
+    }
+    void reset() {
+        delete x;
+        delete dx;
+        x = new LegacyLowPassFilter(alpha(mincutoff));
+        dx = new LegacyLowPassFilter(alpha(dcutoff));
+        lasttime = -1.0;
+    }
+    void setFrequency(double f) { freq = f <= 0 ? 0 : f; }
+    double filter(double value, double timestamp) {
+        if (lasttime != -1.0 && timestamp != -1.0 && timestamp > lasttime)
+            freq = 1.0 / (timestamp - lasttime);
+        lasttime = timestamp;
+        double dvalue = x->hasLastRawValue() ? (value - x->lastFilteredValue()) * freq : 0.0;
+        double edvalue = dx->filterWithAlpha(dvalue, alpha(dcutoff));
+        double cutoff = mincutoff + beta_ * fabs(edvalue);
+        return x->filterWithAlpha(value, alpha(cutoff));
+    }
+};
+
+typedef struct {
+    float       frequency;
+    TimeStamp   timestampUs;
+    bool        resetBefore;
+} Reading;
+
+// Jittery readings around a slowly drifting pitch, like the detector gives
+// after a pluck, timestamped on the 5 kHz sample grid.
+static std::vector<Reading> make_readings() {
+    std::vector<Reading> readings;
+    srand(0x1e);
+    TimeStamp timestampUs = 1000000;
+    int64_t sampleUs = 1000000 / TUNER_ADC_SAMPLE_RATE;
+    for (int p = 0; p < PLUCKS; p++) {
+        float pitch = 82.41f * powf(2.0f, (float)(rand() % 36) / 12.0f);
+        for (int r = 0; r < READINGS_PER_PLUCK; r++) {
+            float jitter = ((float)rand() / (float)RAND_MAX - 0.5f) * 0.01f;
+            float drift = 1.0f + 0.004f * expf(-(float)r / 80.0f);
+            int64_t periodSamples = (int64_t)(TUNER_ADC_SAMPLE_RATE / pitch) + 1;
+            timestampUs += periodSamples * sampleUs;
+            readings.push_back({ pitch * drift * (1.0f + jitter), timestampUs, r == 0 });
+        }
+        timestampUs += 500000; // half a second of silence between plucks
+    }
+    return readings;
+}
+
+template <typename Filter, typename Scalar, typename Stamp>
+static double run_filters(Filter &f1, Filter &f2, const std::vector<Reading> &readings, int iterations, Stamp (*toStamp)(TimeStamp), std::vector<float> *outputs) {
+    volatile float sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        for (const Reading &reading : readings) {
+            if (reading.resetBefore) {
+                f1.reset();
+                f2.reset();
+            }
+            Stamp stamp = toStamp(reading.timestampUs);
+            Scalar f = reading.frequency;
+            f1.setFrequency(f);
+            f = f1.filter(f, stamp);
+            f2.setFrequency(f);
+            f = f2.filter(f, stamp);
+            sink = sink + (float)f;
+            if (outputs != nullptr && i == 0) {
+                outputs->push_back((float)f);
+            }
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    return elapsed.count() / ((double)iterations * readings.size());
+}
+
+static double to_seconds(TimeStamp us) { return (double)us / 1000000; }
+static TimeStamp to_micros(TimeStamp us) { return us; }
+
+int main(int argc, char **argv) {
+    int iterations = 200;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--iterations <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<Reading> readings = make_readings();
+
+    LegacyOneEuroFilter legacy1(EU_FILTER_ESTIMATED_FREQ, EU_FILTER_MIN_CUTOFF, EU_FILTER_BETA, EU_FILTER_DERIVATIVE_CUTOFF);
+    LegacyOneEuroFilter legacy2(EU_FILTER_ESTIMATED_FREQ, EU_FILTER_MIN_CUTOFF_2, EU_FILTER_BETA_2, EU_FILTER_DERIVATIVE_CUTOFF_2);
+    OneEuroFilter<double> double1(EU_FILTER_ESTIMATED_FREQ, EU_FILTER_MIN_CUTOFF, EU_FILTER_BETA, EU_FILTER_DERIVATIVE_CUTOFF);
+    OneEuroFilter<double> double2(EU_FILTER_ESTIMATED_FREQ, EU_FILTER_MIN_CUTOFF_2, EU_FILTER_BETA_2, EU_FILTER_DERIVATIVE_CUTOFF_2);
+    OneEuroFilter<float> float1(EU_FILTER_ESTIMATED_FREQ, EU_FILTER_MIN_CUTOFF, EU_FILTER_BETA, EU_FILTER_DERIVATIVE_CUTOFF);
+    OneEuroFilter<float> float2(EU_FILTER_ESTIMATED_FREQ, EU_FILTER_MIN_CUTOFF_2, EU_FILTER_BETA_2, EU_FILTER_DERIVATIVE_CUTOFF_2);
+
+    std::vector<float> legacyOut, floatOut;
+    double legacyNs = run_filters<LegacyOneEuroFilter, double, double>(legacy1, legacy2, readings, iterations, to_seconds, &legacyOut);
+    double doubleNs = run_filters<OneEuroFilter<double>, double, TimeStamp>(double1, double2, readings, iterations, to_micros, nullptr);
+    double floatNs = run_filters<OneEuroFilter<float>, float, TimeStamp>(float1, float2, readings, iterations, to_micros, &floatOut);
+
+    float maxCents = 0;
+    for (size_t i = 0; i < legacyOut.size(); i++) {
+        float cents = fabsf(1200.0f * log2f(floatOut[i] / legacyOut[i]));
+        if (cents > maxCents) {
+            maxCents = cents;
+        }
+    }
+
+    printf("%zu readings x %d iterations (two filters per reading, reset every %d)\n", readings.size(), iterations, READINGS_PER_PLUCK);
+    printf("  legacy double (heap): %7.2f ns/reading\n", legacyNs);
+    printf("  OneEuroFilter<double>:%7.2f ns/reading (%.2fx)\n", doubleNs, legacyNs / doubleNs);
+    printf("  OneEuroFilter<float>: %7.2f ns/reading (%.2fx)\n", floatNs, legacyNs / floatNs);
+    printf("  max float vs legacy:  %.5f cents\n", maxCents);
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// pitch_replay - Streams WAV files or raw ADC captures through the exact
+// firmware DSP chain and writes a per-frame CSV of the FrequencyInfo the GUI
+// would have seen.
+//
+// Usage: pitch_replay [options] <input.wav|input.raw> [more inputs...]
+//
+//   -o <file>      Write the CSV to <file> instead of stdout
+//   --raw          Inputs are raw ADC captures (32-bit TYPE2 words at
+//                  the instrument's sample rate) instead of WAV files
+//   --instrument <n>
+//                  Run the chain with instrument profile <n> (the index in
+//                  main/instrument_profiles.h, default 0 = Chromatic)
+//   --preset <n>   Run the chain with tuning preset <n> (the index in
+//                  main/tuning_presets.h, default 0 = Off)
+//   --gain <g>     Scale WAV samples by <g> before quantizing them to 12-bit
+//                  ADC values (default 1.0 = full ADC range)
+//
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "defines.h"
+#include "replay.h"
+#include "wav_file.h"
+
+static void print_usage() {
+    fprintf(stderr, "Usage: pitch_replay [-o output.csv] [--raw] [--gain g] [--instrument n] [--preset n] <input> [more inputs...]\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *outputPath = NULL;
+    bool rawInput = false;
+    float gain = 1.0f;
+    int instrument = instrumentChromatic;
+    int preset = tuningPresetOff;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (strcmp(argv[i], "--raw") == 0) {
+            rawInput = true;
+        } else if (strcmp(argv[i], "--gain") == 0 && i + 1 < argc) {
+            gain = strtof(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--instrument") == 0 && i + 1 < argc) {
+            instrument = atoi(argv[++i]);
+            if (instrument < 0 || instrument >= instrumentCount) {
+                print_usage();
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--preset") == 0 && i + 1 < argc) {
+            preset = atoi(argv[++i]);
+            if (preset < 0 || preset >= tuningPresetCount) {
+                print_usage();
+                return 1;
+            }
+        } else if (argv[i][0] == '-') {
+            print_usage();
+            return 1;
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+    if (inputs.empty()) {
+        print_usage();
+        return 1;
+    }
+
+    FILE *csv = outputPath != NULL ? fopen(outputPath, "w") : stdout;
+    if (csv == NULL) {
+        fprintf(stderr, "Unable to open %s\n", outputPath);
+        return 1;
+    }
+    fprintf(csv, "file,frame,time_s,published,frequency,cents,target_frequency,target_note,target_octave,process_us\n");
+
+    const InstrumentProfile &profile = instrument_profile((TunerInstrument)instrument);
+    const TuningPreset &tuningPreset = tuning_preset((TunerTuningPreset)preset);
+    fprintf(stderr, "Instrument: %s (%u Hz, %zu samples per frame), tuning preset: %s\n", profile.name, (unsigned)profile.sampleRate, profile.samplesPerFrame, tuningPreset.name);
+
+    double totalAudioSeconds = 0;
+    double totalProcessSeconds = 0;
+    for (const std::string &input : inputs) {
+        std::vector<uint32_t> words;
+        std::string error;
+        if (rawInput) {
+            if (!read_raw_adc_capture(input, words, error)) {
+                fprintf(stderr, "%s\n", error.c_str());
+                return 1;
+            }
+        } else {
+            std::vector<float> samples;
+            uint32_t sampleRate;
+            if (!read_wav_file(input, samples, sampleRate, error)) {
+                fprintf(stderr, "%s\n", error.c_str());
+                return 1;
+            }
+            samples = resample_linear(samples, sampleRate, profile.sampleRate);
+            words = quantize_to_adc_words(samples, gain);
+        }
+
+        totalAudioSeconds += (double)words.size() / profile.sampleRate;
+        totalProcessSeconds += replay_adc_words(words, profile, tuningPreset, [&](const ReplayFrame &frame) {
+            const FrequencyInfo &r = frame.reading;
+            bool hasPitch = frame.hasReading && r.frequency > 0;
+            fprintf(csv, "%s,%zu,%.6f,%d,%.4f,%.3f,%.4f,%s,%d,%.2f\n",
+                input.c_str(), frame.index, frame.timeSeconds, frame.numPublished,
+                hasPitch ? r.frequency : -1.0f,
+                hasPitch ? r.cents : 0.0f,
+                hasPitch ? r.targetFrequency : -1.0f,
+                name_for_note(hasPitch ? r.targetNote : NOTE_NONE),
+                hasPitch ? r.targetOctave : -1,
+                frame.processMicros);
+        });
+    }
+
+    if (csv != stdout) {
+        fclose(csv);
+    }
+
+    fprintf(stderr, "Processed %.2f s of audio in %.3f s (%.0fx real time)\n",
+        totalAudioSeconds, totalProcessSeconds, totalProcessSeconds > 0 ? totalAudioSeconds / totalProcessSeconds : 0.0);
+    return 0;
+}
@@ -0,0 +1,478 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// pluck_bench - Generates a reproducible corpus of labelled synthetic plucks
+// and measures how the firmware DSP chain tunes them.
+//
+// For every string it reports:
+//   - time-to-lock: time from the pluck until the first reading of the
+//     correct note that then stays correct for STABLE_FRAMES frames
+//   - settled cent error: mean and max |cents| of the readings after lock,
+//     measured against the true (detuned) frequency
+//   - wrong-note rate: readings that named the wrong note or octave
+//   - held: time from lock until the chain first reports no pitch (the
+//     string has died away or the noise gate closed), and how often the
+//     lock was dropped and picked up again during the pluck
+//
+// With --profiles it instead runs, for every instrument profile in
+// main/instrument_profiles.h, the corpus strings inside that profile's range
+// through the Chromatic profile and through the instrument's own profile
+// (rendered at its sample rate) and compares the lock times.
+//
+// With --presets it instead runs the strings of every tuning preset in
+// main/tuning_presets.h through the chromatic detector and through the
+// preset's resonator bank and compares lock times, settled cent error and
+// jitter (RMS change in cents from one reading to the next after lock).
+//
+// Usage: pluck_bench [-o plucks.csv] [--wav-dir <dir>] [--quick] [--profiles] [--presets]
+//
+//   -o <file>          Write one CSV row per pluck to <file>
+//   --wav-dir <dir>    Also write every pluck as a WAV file (the label is in
+//                      the file name) so it can be replayed with pitch_replay
+//   --quick            Only run the center of the variation grid
+//   --profiles         Compare the instrument profiles against Chromatic
+//   --presets          Compare the tuning presets against the chromatic detector
+//
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "defines.h"
+#include "instrument_profiles.h"
+#include "pluck_synth.h"
+#include "replay.h"
+#include "tuning_presets.h"
+#include "wav_file.h"
+
+#define STABLE_SECONDS              0.1     // 8 frames at 5 kHz / 64 samples
+#define PLUCK_SILENCE_SECONDS       0.25f
+#define PLUCK_DURATION_SECONDS      3.0f
+#define CORPUS_SEED                 0x5175  // Change this and the baseline changes
+#define RANGE_TOLERANCE             1.0006  // 1 cent, the profile ranges are rounded to 0.01 Hz
+
+typedef struct {
+    const char  *name;
+    int         midiNote;
+} BenchString;
+
+// 5-string bass, 6-string guitar and a few high harmonics up to the top of
+// the Chromatic range (C7), then the lowest and highest strings of the other
+// instrument profiles and the strings of the tuning presets that aren't in
+// standard tuning. New strings go at the end so the plucks of the ones before
+// them don't change.
+static const BenchString benchStrings[] = {
+    { "Bass B0",     23 },
+    { "Bass E1",     28 },
+    { "Bass A1",     33 },
+    { "Bass D2",     38 },
+    { "Bass G2",     43 },
+    { "Gtr E2",      40 },
+    { "Gtr A2",      45 },
+    { "Gtr D3",      50 },
+    { "Gtr G3",      55 },
+    { "Gtr B3",      59 },
+    { "Gtr E4",      64 },
+    { "Harm E5",     76 },
+    { "Harm B5",     83 },
+    { "Harm E6",     88 },
+    { "Harm C7",     96 },
+    { "Bari B1",     35 },
+    { "Cello C2",    36 },
+    { "Bass C3",     48 },
+    { "Uke G4",      67 },
+    { "Uke A4",      69 },
+    { "Gtr A3",      57 },
+    { "Gtr D4",      62 },
+};
+
+static const float detuneCents[] = { -25, -8, 0, 6, 20 };
+static const float noiseDbs[] = { -200, -45, -30 };
+static const float decaySeconds[] = { 1.5f, 6.0f };
+static const float levels[] = { 1.0f, 0.35f };
+
+typedef struct {
+    bool    locked;
+    double  lockSeconds;
+    double  meanAbsCents;
+    double  maxAbsCents;
+    double  jitterCents;        // RMS change from one reading to the next after lock
+    int     numReadings;
+    int     numWrongReadings;
+    double  heldSeconds;
+    int     numDropouts;
+    double  processSeconds;     // Wall-clock time spent in the chain
+} PluckResult;
+
+static double midi_to_frequency(int midiNote) {
+    return A4_FREQ * pow(2.0, (midiNote - 69) / 12.0);
+}
+
+static PluckResult measure_pluck(const std::vector<uint32_t> &words, const InstrumentProfile &profile, const TuningPreset &preset, int midiNote, double trueFrequency) {
+    const double frameSeconds = (double)profile.samplesPerFrame / profile.sampleRate;
+    const int stableFrames = (int)ceil(STABLE_SECONDS / frameSeconds);
+    TunerNoteName trueNote = (TunerNoteName)(midiNote % 12);
+    int trueOctave = midiNote / 12 - 1;
+
+    PluckResult result = {};
+    int correctRun = 0;
+    double candidateLock = 0;
+    double sumAbsCents = 0;
+    int settledReadings = 0;
+    double sumSquaredSteps = 0;
+    int steps = 0;
+    double lastCents = NAN;
+    bool held = false;
+
+    result.processSeconds = replay_adc_words(words, profile, preset, [&](const ReplayFrame &frame) {
+        double frameEnd = frame.timeSeconds + frameSeconds - PLUCK_SILENCE_SECONDS;
+        if (frameEnd <= 0) {
+            return; // Still in the silence before the pluck
+        }
+        const FrequencyInfo &r = frame.reading;
+        bool hasPitch = frame.hasReading && r.frequency > 0;
+        bool correct = hasPitch && r.targetNote == trueNote && r.targetOctave == trueOctave;
+
+        if (frame.numPublished > 0 && hasPitch) {
+            result.numReadings++;
+            if (!correct) {
+                result.numWrongReadings++;
+            }
+        }
+
+        if (!result.locked) {
+            if (correct) {
+                if (correctRun == 0) {
+                    candidateLock = frameEnd;
+                }
+                correctRun++;
+                if (correctRun >= stableFrames) {
+                    result.locked = true;
+                    result.lockSeconds = candidateLock;
+                }
+            } else {
+                correctRun = 0;
+            }
+            held = result.locked;
+        } else if (frame.numPublished > 0 && hasPitch) {
+            double cents = 1200 * log2(r.frequency / trueFrequency);
+            sumAbsCents += fabs(cents);
+            result.maxAbsCents = std::max(result.maxAbsCents, fabs(cents));
+            settledReadings++;
+            if (!std::isnan(lastCents)) {
+                sumSquaredSteps += (cents - lastCents) * (cents - lastCents);
+                steps++;
+            }
+            lastCents = cents;
+            held = true;
+        } else if (frame.numPublished > 0 && held) {
+            // No pitch. The first time ends the lock, every time after that
+            // it had been picked up again.
+            if (result.heldSeconds == 0) {
+                result.heldSeconds = frameEnd - result.lockSeconds;
+            } else {
+                result.numDropouts++;
+            }
+            held = false;
+            lastCents = NAN;
+        }
+    });
+
+    if (result.locked && result.heldSeconds == 0) {
+        result.heldSeconds = PLUCK_DURATION_SECONDS - result.lockSeconds; // Held to the end
+    }
+
+    result.meanAbsCents = settledReadings > 0 ? sumAbsCents / settledReadings : 0;
+    result.jitterCents = steps > 0 ? sqrt(sumSquaredSteps / steps) : 0;
+    return result;
+}
+
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return NAN;
+    }
+    std::sort(values.begin(), values.end());
+    size_t index = (size_t)std::min((double)values.size() - 1, floor(p * values.size()));
+    return values[index];
+}
+
+/// @brief Calls `onPluck` for every pluck of the variation grid of
+/// `benchStrings[stringIndex]`. Each pluck gets the same seed no matter
+/// which strings are run.
+static void for_each_pluck(size_t stringIndex, bool quick, const std::function<void(float detune, const PluckSpec &spec)> &onPluck) {
+    size_t numDetunes = quick ? 1 : sizeof(detuneCents) / sizeof(detuneCents[0]);
+    size_t numNoises = quick ? 1 : sizeof(noiseDbs) / sizeof(noiseDbs[0]);
+    size_t numDecays = quick ? 1 : sizeof(decaySeconds) / sizeof(decaySeconds[0]);
+    size_t numLevels = quick ? 1 : sizeof(levels) / sizeof(levels[0]);
+    uint32_t seed = CORPUS_SEED + (uint32_t)(stringIndex * numDetunes * numNoises * numDecays * numLevels);
+
+    for (size_t d = 0; d < numDetunes; d++) {
+        for (size_t n = 0; n < numNoises; n++) {
+            for (size_t t = 0; t < numDecays; t++) {
+                for (size_t l = 0; l < numLevels; l++) {
+                    float detune = quick ? 0 : detuneCents[d];
+                    PluckSpec spec = {
+                        .frequency = (float)(midi_to_frequency(benchStrings[stringIndex].midiNote) * pow(2.0, detune / 1200)),
+                        .decaySeconds = decaySeconds[t],
+                        .level = levels[l],
+                        .noiseDb = noiseDbs[n],
+                        .silenceSeconds = PLUCK_SILENCE_SECONDS,
+                        .durationSeconds = PLUCK_DURATION_SECONDS,
+                        .seed = seed++,
+                    };
+                    onPluck(detune, spec);
+                }
+            }
+        }
+    }
+}
+
+/// @brief Lock times and wrong readings of one profile over a set of plucks.
+typedef struct {
+    std::vector<double> lockTimes;  // ms, locked plucks only
+    double  sumAbsCents;            // Of the locked plucks' mean |cents|
+    double  maxAbsCents;
+    double  sumJitterCents;
+    int     plucks;
+    int     lockedPlucks;
+    int     readings;
+    int     wrongReadings;
+    double  processSeconds;
+    double  audioSeconds;
+} ProfileTally;
+
+static void tally_pluck(ProfileTally &tally, const PluckResult &result) {
+    tally.plucks++;
+    tally.readings += result.numReadings;
+    tally.wrongReadings += result.numWrongReadings;
+    tally.processSeconds += result.processSeconds;
+    tally.audioSeconds += PLUCK_SILENCE_SECONDS + PLUCK_DURATION_SECONDS;
+    if (result.locked) {
+        tally.lockedPlucks++;
+        tally.lockTimes.push_back(result.lockSeconds * 1000);
+        tally.sumAbsCents += result.meanAbsCents;
+        tally.maxAbsCents = std::max(tally.maxAbsCents, result.maxAbsCents);
+        tally.sumJitterCents += result.jitterCents;
+    }
+}
+
+/// @brief Runs every corpus string each instrument profile covers through
+/// the Chromatic profile and through the instrument's own profile and prints
+/// how much sooner the instrument profile locks.
+static void compare_profiles(bool quick) {
+    const InstrumentProfile &chromatic = instrument_profile(instrumentChromatic);
+
+    printf("%-16s %7s %6s %11s %18s %18s %8s %13s %13s\n", "profile", "strings", "plucks", "locked",
+        "lock p50", "lock p90", "p50 gain", "wrong", "host us/s");
+
+    for (int i = instrumentChromatic + 1; i < instrumentCount; i++) {
+        const InstrumentProfile &profile = instrument_profile((TunerInstrument)i);
+        ProfileTally before = {};
+        ProfileTally after = {};
+        int numStrings = 0;
+
+        for (size_t s = 0; s < sizeof(benchStrings) / sizeof(benchStrings[0]); s++) {
+            int midiNote = benchStrings[s].midiNote;
+            double frequency = midi_to_frequency(midiNote);
+            if (frequency * RANGE_TOLERANCE < profile.lowFrequency || frequency > profile.highFrequency * RANGE_TOLERANCE) {
+                continue;
+            }
+            numStrings++;
+
+            for_each_pluck(s, quick, [&](float, const PluckSpec &spec) {
+                std::vector<uint32_t> words = quantize_to_adc_words(render_pluck(spec, chromatic.sampleRate), 1.0f);
+                tally_pluck(before, measure_pluck(words, chromatic, tuning_presets[tuningPresetOff], midiNote, spec.frequency));
+
+                words = quantize_to_adc_words(render_pluck(spec, profile.sampleRate), 1.0f);
+                tally_pluck(after, measure_pluck(words, profile, tuning_presets[tuningPresetOff], midiNote, spec.frequency));
+            });
+        }
+
+        double p50Before = percentile(before.lockTimes, 0.5);
+        double p50After = percentile(after.lockTimes, 0.5);
+        printf("%-16s %7d %6d %5d/%-5d %6.0f -> %6.0fms %6.0f -> %6.0fms %7.0f%% %5.1f/%5.1f%% %6.0f/%-6.0f\n",
+            profile.name, numStrings, before.plucks, before.lockedPlucks, after.lockedPlucks,
+            p50Before, p50After,
+            percentile(before.lockTimes, 0.9), percentile(after.lockTimes, 0.9),
+            100 * (p50Before - p50After) / p50Before,
+            before.readings > 0 ? 100.0 * before.wrongReadings / before.readings : 0.0,
+            after.readings > 0 ? 100.0 * after.wrongReadings / after.readings : 0.0,
+            before.audioSeconds > 0 ? before.processSeconds / before.audioSeconds * 1e6 : 0.0,
+            after.audioSeconds > 0 ? after.processSeconds / after.audioSeconds * 1e6 : 0.0);
+    }
+    printf("(Chromatic -> instrument profile. \"locked\" and \"wrong\" are Chromatic/profile.)\n");
+}
+
+/// @brief Runs the strings of every tuning preset through the chromatic
+/// detector and through the preset's resonator bank and prints how much
+/// sooner and steadier the preset reads.
+static void compare_presets(bool quick) {
+    const InstrumentProfile &chromatic = instrument_profile(instrumentChromatic);
+    const size_t numBenchStrings = sizeof(benchStrings) / sizeof(benchStrings[0]);
+
+    printf("%-16s %6s %11s %18s %18s %16s %16s %16s %13s %13s\n", "preset", "plucks", "locked",
+        "lock p50", "lock p90", "|cents|", "max|c|", "jitter", "wrong", "host us/s");
+
+    for (int p = tuningPresetOff + 1; p < tuningPresetCount; p++) {
+        const TuningPreset &preset = tuning_preset((TunerTuningPreset)p);
+        ProfileTally before = {};
+        ProfileTally after = {};
+
+        for (size_t k = 0; k < preset.numStrings; k++) {
+            int midiNote = preset.midiNotes[k];
+            size_t s = 0;
+            while (s < numBenchStrings && benchStrings[s].midiNote != midiNote) {
+                s++;
+            }
+            if (s == numBenchStrings) {
+                fprintf(stderr, "MIDI note %d of %s is not in the corpus\n", midiNote, preset.name);
+                continue;
+            }
+
+            for_each_pluck(s, quick, [&](float, const PluckSpec &spec) {
+                std::vector<uint32_t> words = quantize_to_adc_words(render_pluck(spec, chromatic.sampleRate), 1.0f);
+                tally_pluck(before, measure_pluck(words, chromatic, tuning_presets[tuningPresetOff], midiNote, spec.frequency));
+                tally_pluck(after, measure_pluck(words, chromatic, preset, midiNote, spec.frequency));
+            });
+        }
+
+        printf("%-16s %6d %5d/%-5d %6.0f -> %6.0fms %6.0f -> %6.0fms %6.2f -> %6.2f %6.1f -> %6.1f %6.2f -> %6.2f %5.1f/%5.1f%% %6.0f/%-6.0f\n",
+            preset.name, before.plucks, before.lockedPlucks, after.lockedPlucks,
+            percentile(before.lockTimes, 0.5), percentile(after.lockTimes, 0.5),
+            percentile(before.lockTimes, 0.9), percentile(after.lockTimes, 0.9),
+            before.lockedPlucks > 0 ? before.sumAbsCents / before.lockedPlucks : NAN,
+            after.lockedPlucks > 0 ? after.sumAbsCents / after.lockedPlucks : NAN,
+            before.maxAbsCents, after.maxAbsCents,
+            before.lockedPlucks > 0 ? before.sumJitterCents / before.lockedPlucks : NAN,
+            after.lockedPlucks > 0 ? after.sumJitterCents / after.lockedPlucks : NAN,
+            before.readings > 0 ? 100.0 * before.wrongReadings / before.readings : 0.0,
+            after.readings > 0 ? 100.0 * after.wrongReadings / after.readings : 0.0,
+            before.audioSeconds > 0 ? before.processSeconds / before.audioSeconds * 1e6 : 0.0,
+            after.audioSeconds > 0 ? after.processSeconds / after.audioSeconds * 1e6 : 0.0);
+    }
+    printf("(Chromatic -> tuning preset. \"locked\" and \"wrong\" are chromatic/preset.)\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *outputPath = NULL;
+    const char *wavDir = NULL;
+    bool quick = false;
+    bool profiles = false;
+    bool presets = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (strcmp(argv[i], "--wav-dir") == 0 && i + 1 < argc) {
+            wavDir = argv[++i];
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else if (strcmp(argv[i], "--profiles") == 0) {
+            profiles = true;
+        } else if (strcmp(argv[i], "--presets") == 0) {
+            presets = true;
+        } else {
+            fprintf(stderr, "Usage: pluck_bench [-o plucks.csv] [--wav-dir <dir>] [--quick] [--profiles] [--presets]\n");
+            return 1;
+        }
+    }
+
+    if (profiles) {
+        compare_profiles(quick);
+        return 0;
+    }
+    if (presets) {
+        compare_presets(quick);
+        return 0;
+    }
+
+    FILE *csv = NULL;
+    if (outputPath != NULL) {
+        csv = fopen(outputPath, "w");
+        if (csv == NULL) {
+            fprintf(stderr, "Unable to open %s\n", outputPath);
+            return 1;
+        }
+        fprintf(csv, "string,midi,detune_cents,noise_db,decay_s,level,locked,lock_ms,mean_abs_cents,max_abs_cents,readings,wrong_readings,held_ms,dropouts\n");
+    }
+
+    printf("%-10s %6s %7s %9s %9s %10s %9s %8s %9s %5s\n", "string", "plucks", "locked", "lock p50", "lock p90", "|cents|", "max|c|", "wrong", "held p50", "drops");
+
+    const InstrumentProfile &chromatic = instrument_profile(instrumentChromatic);
+    for (size_t s = 0; s < sizeof(benchStrings) / sizeof(benchStrings[0]); s++) {
+        const BenchString &string = benchStrings[s];
+        std::vector<double> lockTimes;
+        std::vector<double> heldTimes;
+        int dropouts = 0;
+        double sumCents = 0;
+        double maxCents = 0;
+        int plucks = 0;
+        int lockedPlucks = 0;
+        int readings = 0;
+        int wrongReadings = 0;
+
+        for_each_pluck(s, quick, [&](float detune, const PluckSpec &spec) {
+            std::vector<float> samples = render_pluck(spec, chromatic.sampleRate);
+
+            if (wavDir != NULL) {
+                char path[512];
+                snprintf(path, sizeof(path), "%s/midi%d_%+.0fc_%.0fdB_%.1fs_%.2f.wav",
+                    wavDir, string.midiNote, detune, spec.noiseDb, spec.decaySeconds, spec.level);
+                write_wav_file(path, samples, chromatic.sampleRate);
+            }
+
+            PluckResult result = measure_pluck(quantize_to_adc_words(samples, 1.0f), chromatic, tuning_presets[tuningPresetOff], string.midiNote, spec.frequency);
+
+            plucks++;
+            readings += result.numReadings;
+            wrongReadings += result.numWrongReadings;
+            if (result.locked) {
+                lockedPlucks++;
+                lockTimes.push_back(result.lockSeconds * 1000);
+                heldTimes.push_back(result.heldSeconds * 1000);
+                dropouts += result.numDropouts;
+                sumCents += result.meanAbsCents;
+                maxCents = std::max(maxCents, result.maxAbsCents);
+            }
+
+            if (csv != NULL) {
+                fprintf(csv, "%s,%d,%.1f,%.0f,%.1f,%.2f,%d,%.1f,%.3f,%.3f,%d,%d,%.1f,%d\n",
+                    string.name, string.midiNote, detune, spec.noiseDb, spec.decaySeconds, spec.level,
+                    result.locked, result.locked ? result.lockSeconds * 1000 : -1.0,
+                    result.meanAbsCents, result.maxAbsCents, result.numReadings, result.numWrongReadings,
+                    result.locked ? result.heldSeconds * 1000 : -1.0, result.numDropouts);
+            }
+        });
+
+        printf("%-10s %6d %7d %7.0fms %7.0fms %10.2f %9.2f %7.1f%% %7.0fms %5d\n",
+            string.name, plucks, lockedPlucks,
+            percentile(lockTimes, 0.5), percentile(lockTimes, 0.9),
+            lockedPlucks > 0 ? sumCents / lockedPlucks : NAN, maxCents,
+            readings > 0 ? 100.0 * wrongReadings / readings : 0.0,
+            percentile(heldTimes, 0.5), dropouts);
+    }
+
+    if (csv != NULL) {
+        fclose(csv);
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "pluck_synth.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+
+#define DECIMATION_TAPS_PER_PHASE   16
+
+/// @brief Windowed-sinc low-pass for decimating by `factor`.
+static std::vector<float> decimation_filter(uint32_t factor) {
+    size_t numTaps = factor * DECIMATION_TAPS_PER_PHASE + 1;
+    std::vector<float> taps(numTaps);
+    double cutoff = 0.45 / factor; // just below the new Nyquist
+    double center = (numTaps - 1) / 2.0;
+    double sum = 0;
+    for (size_t i = 0; i < numTaps; i++) {
+        double x = i - center;
+        double sinc = x == 0 ? 2 * cutoff : sin(2 * M_PI * cutoff * x) / (M_PI * x);
+        double window = 0.42 - 0.5 * cos(2 * M_PI * i / (numTaps - 1)) + 0.08 * cos(4 * M_PI * i / (numTaps - 1)); // Blackman
+        taps[i] = (float)(sinc * window);
+        sum += taps[i];
+    }
+    for (float &tap : taps) {
+        tap /= sum;
+    }
+    return taps;
+}
+
+std::vector<float> render_pluck(const PluckSpec &spec, uint32_t sampleRate, uint32_t oversample) {
+    double fastRate = (double)sampleRate * oversample;
+    size_t numSilence = (size_t)(spec.silenceSeconds * sampleRate);
+    size_t numPluck = (size_t)(spec.durationSeconds * sampleRate);
+    size_t numFast = numPluck * oversample;
+
+    std::mt19937 rng(spec.seed);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+    // The loop delay is the integer delay line plus half a sample for the
+    // two-point averaging filter plus the allpass delay.
+    double period = fastRate / spec.frequency;
+    size_t delayLength = (size_t)floor(period - 0.5 - 0.1);
+    double allpassDelay = period - 0.5 - delayLength; // 0.1 ... 1.1 keeps the allpass well behaved
+    double allpassCoeff = (1 - allpassDelay) / (1 + allpassDelay);
+
+    // Per-period loss that gives the requested 60 dB decay time.
+    double loopGain = pow(10.0, -3.0 / (spec.decaySeconds * spec.frequency));
+
+    // Excite with a low-passed noise burst, like a pick hitting the string.
+    std::vector<float> line(delayLength, 0.0f);
+    float previous = 0;
+    for (size_t i = 0; i < delayLength; i++) {
+        previous = 0.5f * previous + 0.5f * uniform(rng);
+        line[i] = previous;
+    }
+
+    std::vector<float> fast(numFast);
+    size_t position = 0;
+    float lastOut = 0;
+    double allpassIn = 0;
+    double allpassOut = 0;
+    for (size_t n = 0; n < numFast; n++) {
+        float out = line[position];
+        double averaged = loopGain * 0.5 * (out + lastOut);
+        lastOut = out;
+        allpassOut = allpassCoeff * averaged + allpassIn - allpassCoeff * allpassOut;
+        allpassIn = averaged;
+        line[position] = (float)allpassOut;
+        position = (position + 1) % delayLength;
+        fast[n] = out;
+    }
+
+    // Low-pass and decimate to the ADC rate.
+    std::vector<float> taps = decimation_filter(oversample);
+    std::vector<float> out(numSilence + numPluck, 0.0f);
+    float peak = 0;
+    for (size_t i = 0; i < numPluck; i++) {
+        size_t center = i * oversample;
+        double acc = 0;
+        for (size_t t = 0; t < taps.size(); t++) {
+            std::ptrdiff_t index = (std::ptrdiff_t)center + (std::ptrdiff_t)t - (std::ptrdiff_t)(taps.size() / 2);
+            if (index >= 0 && index < (std::ptrdiff_t)numFast) {
+                acc += taps[t] * fast[index];
+            }
+        }
+        out[numSilence + i] = (float)acc;
+        peak = std::max(peak, std::fabs((float)acc));
+    }
+
+    float scale = peak > 0 ? spec.level / peak : 0;
+    float noiseLevel = spec.noiseDb > -120 ? powf(10.0f, spec.noiseDb / 20) : 0;
+    for (float &sample : out) {
+        sample = sample * scale + noiseLevel * uniform(rng);
+    }
+    return out;
+}
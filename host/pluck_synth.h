@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_HOST_PLUCK_SYNTH)
+#define TUNER_HOST_PLUCK_SYNTH
+
+#include <cstdint>
+#include <vector>
+
+/// @brief Describes one synthetic pluck.
+typedef struct {
+    float       frequency;      // Fundamental in Hz (already detuned)
+    float       decaySeconds;   // Time for the string to decay by 60 dB
+    float       level;          // Peak level relative to ADC full scale (0 - 1)
+    float       noiseDb;        // Broadband noise level relative to full scale (<= -120 for none)
+    float       silenceSeconds; // Silence before the pluck
+    float       durationSeconds;// Length of the pluck after the silence
+    uint32_t    seed;           // Seeds the excitation and noise so every run is identical
+} PluckSpec;
+
+/// @brief Renders a pluck with a Karplus-Strong string model.
+///
+/// The string runs at `sampleRate * oversample` with an allpass for
+/// fractional delay tuning and is then low-pass filtered and decimated to
+/// `sampleRate` so the result contains no aliased harmonics. The output is
+/// scaled so its peak is `spec.level`.
+std::vector<float> render_pluck(const PluckSpec &spec, uint32_t sampleRate, uint32_t oversample = 10);
+
+#endif
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// pluck_synth_test - Checks that the synthetic plucks pluck_bench and the
+// other benches are built on (host/pluck_synth.h) ring at the frequency they
+// were asked for. The benches measure cent errors against that frequency, so
+// any error here ends up in their numbers.
+//
+// Every note from B0 to C7, at a few detunes, is rendered at the ADC rate and
+// the fundamental is found with a fine DFT scan (a Hann-windowed DTFT whose
+// peak is searched for to well under 0.01 cents). Each has to be within
+// MAX_CENTS_ERROR of the requested frequency.
+//
+// Usage: pluck_synth_test
+//
+// Exits with 1 if any check fails.
+//
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "defines.h"
+#include "pluck_synth.h"
+
+#define LOWEST_NOTE         23      // B0
+#define HIGHEST_NOTE        96      // C7
+#define SKIP_SECONDS        0.1f    // Let the excitation settle
+#define WINDOW_SECONDS      2.0f
+#define SEARCH_CENTS        20.0
+#define MAX_CENTS_ERROR     0.15
+
+static const float detuneCents[] = { -37, 0, 13 };
+
+/// @brief Magnitude of the windowed signal's DTFT at `frequency`.
+static double dtft_magnitude(const std::vector<double> &windowed, double frequency, double sampleRate) {
+    double re = 0;
+    double im = 0;
+    double step = 2 * M_PI * frequency / sampleRate;
+    for (size_t n = 0; n < windowed.size(); n++) {
+        re += windowed[n] * cos(step * n);
+        im -= windowed[n] * sin(step * n);
+    }
+    return sqrt(re * re + im * im);
+}
+
+/// @brief Finds the peak of the fundamental within `SEARCH_CENTS` of
+/// `frequency` (golden section search, the main lobe is far wider than that
+/// down to B0).
+static double measure_frequency(const std::vector<float> &samples, double frequency, double sampleRate) {
+    size_t start = (size_t)(SKIP_SECONDS * sampleRate);
+    size_t length = (size_t)(WINDOW_SECONDS * sampleRate);
+    std::vector<double> windowed(length);
+    for (size_t n = 0; n < length; n++) {
+        windowed[n] = samples[start + n] * (0.5 - 0.5 * cos(2 * M_PI * n / (length - 1)));
+    }
+
+    const double golden = (sqrt(5.0) - 1) / 2;
+    double low = frequency * pow(2.0, -SEARCH_CENTS / 1200);
+    double high = frequency * pow(2.0, SEARCH_CENTS / 1200);
+    double a = high - golden * (high - low);
+    double b = low + golden * (high - low);
+    double magA = dtft_magnitude(windowed, a, sampleRate);
+    double magB = dtft_magnitude(windowed, b, sampleRate);
+    while (1200 * log2(high / low) > 0.001) {
+        if (magA > magB) {
+            high = b;
+            b = a;
+            magB = magA;
+            a = high - golden * (high - low);
+            magA = dtft_magnitude(windowed, a, sampleRate);
+        } else {
+            low = a;
+            a = b;
+            magA = magB;
+            b = low + golden * (high - low);
+            magB = dtft_magnitude(windowed, b, sampleRate);
+        }
+    }
+    return (low + high) / 2;
+}
+
+int main() {
+    int failures = 0;
+    int checks = 0;
+    double worstCents = 0;
+    int worstNote = 0;
+    for (int midiNote = LOWEST_NOTE; midiNote <= HIGHEST_NOTE; midiNote++) {
+        for (float detune : detuneCents) {
+            PluckSpec spec = {
+                .frequency = (float)(A4_FREQ * pow(2.0, (midiNote - 69) / 12.0) * pow(2.0, detune / 1200)),
+                .decaySeconds = 6.0f,
+                .level = 1.0f,
+                .noiseDb = -200,
+                .silenceSeconds = 0,
+                .durationSeconds = SKIP_SECONDS + WINDOW_SECONDS,
+                .seed = (uint32_t)midiNote,
+            };
+            std::vector<float> samples = render_pluck(spec, TUNER_ADC_SAMPLE_RATE);
+            double measured = measure_frequency(samples, spec.frequency, TUNER_ADC_SAMPLE_RATE);
+            double cents = 1200 * log2(measured / spec.frequency);
+            checks++;
+            if (fabs(cents) > fabs(worstCents)) {
+                worstCents = cents;
+                worstNote = midiNote;
+            }
+            if (fabs(cents) > MAX_CENTS_ERROR) {
+                fprintf(stderr, "FAIL: MIDI note %d %+.0f cents rings %+.3f cents off\n", midiNote, detune, cents);
+                failures++;
+            }
+        }
+    }
+
+    if (failures > 0) {
+        printf("%d of %d plucks failed\n", failures, checks);
+        return 1;
+    }
+    printf("OK (%d plucks, worst %+.3f cents at MIDI note %d)\n", checks, worstCents, worstNote);
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "png_writer.h"
+
+#include <cstdio>
+#include <vector>
+
+#define PNG_STORED_BLOCK_MAX    65535
+
+static uint32_t png_crc_table[256];
+
+static void png_init_crc_table() {
+    if (png_crc_table[1] != 0) {
+        return;
+    }
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        png_crc_table[n] = c;
+    }
+}
+
+static uint32_t png_crc(const uint8_t *data, size_t length, uint32_t crc = 0xFFFFFFFFu) {
+    for (size_t i = 0; i < length; i++) {
+        crc = png_crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static void png_put_u32(std::vector<uint8_t> &out, uint32_t value) {
+    out.push_back((uint8_t)(value >> 24));
+    out.push_back((uint8_t)(value >> 16));
+    out.push_back((uint8_t)(value >> 8));
+    out.push_back((uint8_t)value);
+}
+
+static void png_put_chunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data) {
+    png_put_u32(out, (uint32_t)data.size());
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    png_put_u32(out, png_crc(&out[start], out.size() - start) ^ 0xFFFFFFFFu);
+}
+
+bool png_write_rgb565(const char *path, const uint16_t *pixels, int width, int height) {
+    png_init_crc_table();
+
+    // Filter type 0 (none) in front of every row
+    std::vector<uint8_t> raw;
+    raw.reserve((size_t)height * (1 + width * 3));
+    for (int y = 0; y < height; y++) {
+        raw.push_back(0);
+        for (int x = 0; x < width; x++) {
+            uint16_t p = pixels[y * width + x];
+            uint8_t r = (p >> 11) & 0x1F;
+            uint8_t g = (p >> 5) & 0x3F;
+            uint8_t b = p & 0x1F;
+            raw.push_back((uint8_t)((r << 3) | (r >> 2)));
+            raw.push_back((uint8_t)((g << 2) | (g >> 4)));
+            raw.push_back((uint8_t)((b << 3) | (b >> 2)));
+        }
+    }
+
+    // zlib stream made of stored deflate blocks
+    std::vector<uint8_t> zlib = { 0x78, 0x01 };
+    uint32_t adlerA = 1, adlerB = 0;
+    for (size_t offset = 0; offset < raw.size() || offset == 0; offset += PNG_STORED_BLOCK_MAX) {
+        size_t length = raw.size() - offset < PNG_STORED_BLOCK_MAX ? raw.size() - offset : PNG_STORED_BLOCK_MAX;
+        bool last = offset + length >= raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back((uint8_t)length);
+        zlib.push_back((uint8_t)(length >> 8));
+        zlib.push_back((uint8_t)~length);
+        zlib.push_back((uint8_t)(~length >> 8));
+        for (size_t i = offset; i < offset + length; i++) {
+            zlib.push_back(raw[i]);
+            adlerA = (adlerA + raw[i]) % 65521;
+            adlerB = (adlerB + adlerA) % 65521;
+        }
+        if (last) {
+            break;
+        }
+    }
+    png_put_u32(zlib, (adlerB << 16) | adlerA);
+
+    std::vector<uint8_t> header;
+    png_put_u32(header, (uint32_t)width);
+    png_put_u32(header, (uint32_t)height);
+    header.push_back(8);    // bit depth
+    header.push_back(2);    // color type: RGB
+    header.push_back(0);    // compression
+    header.push_back(0);    // filter
+    header.push_back(0);    // interlace
+
+    std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    png_put_chunk(png, "IHDR", header);
+    png_put_chunk(png, "IDAT", zlib);
+    png_put_chunk(png, "IEND", {});
+
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = fwrite(png.data(), 1, png.size(), file) == png.size();
+    return fclose(file) == 0 && ok;
+}
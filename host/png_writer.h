@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_HOST_PNG_WRITER)
+#define TUNER_HOST_PNG_WRITER
+
+#include <cstdint>
+
+/// @brief Writes an RGB565 framebuffer as an 8-bit RGB PNG.
+///
+/// The image data is stored uncompressed (deflate "stored" blocks) so there
+/// is no zlib dependency. Files are about 3 bytes per pixel.
+/// @return false if the file couldn't be written.
+bool png_write_rgb565(const char *path, const uint16_t *pixels, int width, int height);
+
+#endif
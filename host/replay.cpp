@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "replay.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "adc_frame_kernel.h"
+#include "pitch_detector_chain.h"
+
+static void collect_reading(const FrequencyInfo *freqInfo, void *context) {
+    ReplayFrame *frame = (ReplayFrame *)context;
+    frame->reading = *freqInfo;
+    frame->hasReading = true;
+    frame->numPublished++;
+}
+
+double replay_adc_words(const std::vector<uint32_t> &words, const InstrumentProfile &profile, const TuningPreset &preset, const std::function<void(const ReplayFrame &)> &onFrame) {
+    PitchDetectorChain chain(profile, preset);
+    const uint32_t sampleRate = profile.sampleRate;
+    const size_t frameSize = profile.samplesPerFrame;
+
+    alignas(ADC_FRAME_KERNEL_ALIGNMENT) float samples[TUNER_ADC_SAMPLES_PER_FRAME];
+    ReplayFrame frame = {};
+    double totalSeconds = 0;
+
+    for (size_t start = 0; start < words.size(); start += frameSize) {
+        size_t numSamples = std::min(frameSize, words.size() - start);
+        int64_t frameTimeUs = (int64_t)start * 1000000 / sampleRate;
+
+        frame.index = start / frameSize;
+        frame.timeSeconds = (double)start / sampleRate;
+        frame.numPublished = 0;
+
+        auto begin = std::chrono::steady_clock::now();
+        float minVal, maxVal;
+        adc_frame_unpack(&words[start], numSamples, samples, &minVal, &maxVal);
+#if TUNER_STREAMING_NORMALIZER
+        chain.processFrame(samples, numSamples, frameTimeUs, collect_reading, &frame);
+#else
+        chain.processFrame(samples, numSamples, minVal, maxVal, frameTimeUs, collect_reading, &frame);
+#endif
+        auto end = std::chrono::steady_clock::now();
+
+        frame.processMicros = std::chrono::duration<double, std::micro>(end - begin).count();
+        totalSeconds += frame.processMicros / 1000000;
+        onFrame(frame);
+    }
+    return totalSeconds;
+}
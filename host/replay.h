@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_HOST_REPLAY)
+#define TUNER_HOST_REPLAY
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "defines.h"
+#include "instrument_profiles.h"
+#include "tuning_presets.h"
+
+/// @brief What the detection chain did with one ADC frame.
+typedef struct {
+    size_t          index;          // Frame number
+    double          timeSeconds;    // Time of the first sample in the frame
+    int             numPublished;   // Readings published during this frame (including "no frequency")
+    bool            hasReading;     // True if the chain has published a reading (at any point so far)
+    FrequencyInfo   reading;        // The latest published reading, like the GUI would see it
+    double          processMicros;  // Wall-clock time spent in the chain for this frame
+} ReplayFrame;
+
+/// @brief Streams raw ADC conversion words through the firmware's unpack
+/// kernel and a `PitchDetectorChain` set up for `profile` and `preset`, one
+/// `profile.samplesPerFrame` frame at a time, calling `onFrame` after each
+/// one. The words have to be sampled at `profile.sampleRate`.
+/// @return Returns the total wall-clock time spent in the chain in seconds.
+double replay_adc_words(const std::vector<uint32_t> &words, const InstrumentProfile &profile, const TuningPreset &preset, const std::function<void(const ReplayFrame &)> &onFrame);
+
+#endif
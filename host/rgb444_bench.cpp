@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// rgb444_bench - Times `rgb444_pack()` on full screens worth of LVGL draw
+// buffers, packed in place like the flush callback does, next to a plain
+// memcpy of the same RGB565 data as a floor.
+//
+// It also prints what each format costs on the SPI bus per full screen at
+// LCD_PIXEL_CLOCK_HZ, which is the time the packing is buying back. Compare
+// the pack time per screen with the SPI time saved; on the S3 measure the
+// pack time with TUNER_PROFILE_DISPLAY_FLUSH instead.
+//
+// Usage: rgb444_bench [--iterations <n>]
+//
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "defines.h"
+#include "rgb444_kernel.h"
+
+#define LCD_PIXEL_CLOCK_HZ      (80 * 1000 * 1000) // from waveshare/ST7789.h
+#define SCREEN_PIXELS           (LCD_H_RES * LCD_V_RES)
+#define BUFFERS_PER_SCREEN      (SCREEN_PIXELS / LCD_DRAWBUF_SIZE)
+
+template <typename Op>
+static double time_screens(int iterations, std::vector<uint16_t> &buffer, const std::vector<uint16_t> &source, Op op) {
+    double total = 0;
+    for (int i = 0; i < iterations; i++) {
+        for (int b = 0; b < BUFFERS_PER_SCREEN; b++) {
+            // LVGL renders a fresh buffer for every flush. Refill outside of
+            // the timed part so in-place packing never sees its own output.
+            memcpy(buffer.data(), source.data(), source.size() * sizeof(uint16_t));
+            auto start = std::chrono::steady_clock::now();
+            op();
+            total += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+    return total / iterations;
+}
+
+int main(int argc, char **argv) {
+    int iterations = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--iterations <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Mostly flat colours with some edges, like the tuner UIs.
+    std::vector<uint16_t> source(LCD_DRAWBUF_SIZE);
+    srand(444);
+    for (size_t i = 0; i < source.size(); i++) {
+        source[i] = (i % LCD_H_RES) < LCD_H_RES / 2 ? 0x0000 : (uint16_t)(rand() & 0xFFFF);
+    }
+    std::vector<uint16_t> buffer(LCD_DRAWBUF_SIZE);
+    std::vector<uint16_t> copy(LCD_DRAWBUF_SIZE);
+    volatile uint8_t sink = 0;
+
+    double copyUs = time_screens(iterations, buffer, source, [&]() {
+        memcpy(copy.data(), buffer.data(), buffer.size() * sizeof(uint16_t));
+        sink = sink + ((uint8_t *)copy.data())[copy.size() - 1];
+    });
+    double packUs = time_screens(iterations, buffer, source, [&]() {
+        rgb444_pack(buffer.data(), buffer.size(), (uint8_t *)buffer.data());
+        sink = sink + ((uint8_t *)buffer.data())[RGB444_PACKED_SIZE(buffer.size()) - 1];
+    });
+
+    double screenBytes565 = SCREEN_PIXELS * 2.0;
+    double screenBytes444 = RGB444_PACKED_SIZE(SCREEN_PIXELS);
+    double spiUs565 = screenBytes565 * 8 / LCD_PIXEL_CLOCK_HZ * 1e6;
+    double spiUs444 = screenBytes444 * 8 / LCD_PIXEL_CLOCK_HZ * 1e6;
+
+    printf("%dx%d screen in %d buffers of %d pixels, %d iterations\n", LCD_H_RES, LCD_V_RES, BUFFERS_PER_SCREEN, LCD_DRAWBUF_SIZE, iterations);
+    printf("  memcpy RGB565:        %8.1f us/screen (%7.1f MB/s)\n", copyUs, screenBytes565 / copyUs);
+    printf("  rgb444_pack in place: %8.1f us/screen (%7.1f MB/s of RGB565 in)\n", packUs, screenBytes565 / packUs);
+    printf("SPI at %d MHz per full screen\n", LCD_PIXEL_CLOCK_HZ / 1000000);
+    printf("  RGB565: %6.0f bytes %8.1f us\n", screenBytes565, spiUs565);
+    printf("  RGB444: %6.0f bytes %8.1f us (%.1f us saved)\n", screenBytes444, spiUs444, spiUs565 - spiUs444);
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// rgb444_test - Checks `rgb444_pack()` (the RGB565 -> 12-bit flush converter)
+// against a pixel-at-a-time reference, both into a separate buffer and in
+// place the way the flush callback calls it, for every even length up to a
+// few blocks and for a full LVGL draw buffer.
+//
+// Usage: rgb444_test
+//
+// Exits with 1 on the first mismatch.
+//
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "defines.h"
+#include "rgb444_kernel.h"
+
+// One nibble at a time, straight from the ST7789 datasheet's 12-bit layout.
+static void reference_pack(const uint16_t *src, size_t numPixels, uint8_t *dst) {
+    std::vector<uint8_t> nibbles;
+    for (size_t i = 0; i < numPixels; i++) {
+        nibbles.push_back((src[i] >> 12) & 0x0F);  // top 4 of 5 red bits
+        nibbles.push_back((src[i] >> 7) & 0x0F);   // top 4 of 6 green bits
+        nibbles.push_back((src[i] >> 1) & 0x0F);   // top 4 of 5 blue bits
+    }
+    for (size_t i = 0; i < nibbles.size(); i += 2) {
+        dst[i / 2] = (nibbles[i] << 4) | nibbles[i + 1];
+    }
+}
+
+static bool check(const std::vector<uint16_t> &pixels, const char *what) {
+    size_t numPixels = pixels.size();
+    size_t packedSize = RGB444_PACKED_SIZE(numPixels);
+
+    std::vector<uint8_t> expected(packedSize + 1, 0xA5);
+    reference_pack(pixels.data(), numPixels, expected.data());
+
+    // Separate output buffer. The extra byte catches writes past the end.
+    std::vector<uint8_t> out(packedSize + 1, 0xA5);
+    rgb444_pack(pixels.data(), numPixels, out.data());
+    if (out != expected) {
+        fprintf(stderr, "FAIL: %s, %zu pixels, separate buffer\n", what, numPixels);
+        return false;
+    }
+
+    // In place
+    std::vector<uint16_t> inPlace(pixels);
+    inPlace.push_back(0xA5A5);
+    rgb444_pack(inPlace.data(), numPixels, (uint8_t *)inPlace.data());
+    if (memcmp(inPlace.data(), expected.data(), packedSize) != 0) {
+        fprintf(stderr, "FAIL: %s, %zu pixels, in place\n", what, numPixels);
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    std::mt19937 rng(565);
+    int failures = 0;
+
+    // Known values: white, red and blue pairs.
+    struct {
+        uint16_t a, b;
+        uint8_t packed[3];
+    } known[] = {
+        { 0xFFFF, 0xFFFF, { 0xFF, 0xFF, 0xFF } },
+        { 0xF800, 0xF800, { 0xF0, 0x0F, 0x00 } },
+        { 0x001F, 0x0000, { 0x00, 0xF0, 0x00 } },
+        { 0x0000, 0x07E0, { 0x00, 0x00, 0xF0 } },
+    };
+    for (auto &k : known) {
+        uint16_t pixels[2] = { k.a, k.b };
+        uint8_t packed[3];
+        rgb444_pack(pixels, 2, packed);
+        if (memcmp(packed, k.packed, 3) != 0) {
+            fprintf(stderr, "FAIL: %04X %04X packed to %02X %02X %02X\n", k.a, k.b, packed[0], packed[1], packed[2]);
+            failures++;
+        }
+    }
+
+    // Every even length through a few 8-pixel blocks so the tail is covered.
+    for (size_t numPixels = 0; numPixels <= 64; numPixels += 2) {
+        std::vector<uint16_t> pixels(numPixels);
+        for (auto &p : pixels) {
+            p = (uint16_t)rng();
+        }
+        failures += check(pixels, "random") ? 0 : 1;
+    }
+
+    // A full LVGL draw buffer.
+    std::vector<uint16_t> pixels(LCD_DRAWBUF_SIZE);
+    for (auto &p : pixels) {
+        p = (uint16_t)rng();
+    }
+    failures += check(pixels, "draw buffer") ? 0 : 1;
+
+    if (failures > 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// tuning_bank_bench - Measures the tuning preset resonator bank
+// (main/utils/TuningBank.hpp) on synthetic plucks of every string of every
+// preset in main/tuning_presets.h.
+//
+// The plucks go through the noise gate, the streaming normalizer and the
+// bank frame by frame, just like in `PitchDetectorChain` with a preset
+// picked. For each string it reports:
+//   - time-to-lock: time from the pluck until the first reading of the
+//     correct string that then stays correct for STABLE_SECONDS
+//   - settled cent error: mean and max |cents| of the readings after lock,
+//     measured against the true (detuned) frequency
+//   - jitter: RMS change in cents from one reading to the next after lock
+//   - wrong-string rate: readings that named another string
+// Then it does the same for strings plucked while a lower string is still
+// ringing (the bank doesn't get a reset in between, so the lower string's
+// harmonics are all there), and then the time the bank takes per sample.
+//
+// Usage: tuning_bank_bench [--quick]
+//
+// The q pitch detector isn't part of this. To compare the preset mode with
+// the chromatic detector on the same plucks run `pluck_bench --presets`.
+//
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "adc_frame_kernel.h"
+#include "defines.h"
+#include "NoiseGate.hpp"
+#include "StreamingNormalizer.hpp"
+#include "TuningBank.hpp"
+#include "pluck_synth.h"
+#include "tuning_presets.h"
+#include "wav_file.h"
+
+#define STABLE_SECONDS              0.1
+#define PLUCK_SILENCE_SECONDS       0.25f
+#define PLUCK_DURATION_SECONDS      3.0f
+#define CORPUS_SEED                 0x7b4e
+#define TIMING_PASSES               20
+#define RINGING_SECONDS             0.5f    // How long the lower string rings before the next pluck
+#define RINGING_LEVEL               0.5f    // Both plucks at this level so the mix doesn't clip
+#define RINGING_DECAY_SECONDS       6.0f
+
+typedef TuningBank<TUNING_PRESET_MAX_STRINGS> PresetBank;
+
+static const float detuneCents[] = { -40, -12, 0, 7, 30 };
+static const float noiseDbs[] = { -200, -45, -30 };
+static const float decaySeconds[] = { 1.5f, 6.0f };
+static const float levels[] = { 1.0f, 0.35f };
+
+/// @brief A string plucked while a lower one is still ringing.
+typedef struct {
+    TunerTuningPreset   preset;
+    size_t              ringing;    // String index of the lower string
+    size_t              plucked;
+    const char          *name;
+} RingingCase;
+
+// Pairs where the plucked string's resonators sit within about a semitone of
+// a harmonic of the ringing one.
+static const RingingCase ringingCases[] = {
+    { tuningPresetStandard, 0, 3, "G3 over E2" },   // 2 x G3 is a semitone under E2's 5th
+    { tuningPresetBass5,    0, 3, "D2 over B0" },   // 2 x D2 is a semitone under B0's 5th
+    { tuningPresetBass5,    0, 4, "G2 over B0" },   // G2 is a semitone over B0's 3rd
+    { tuningPresetBass5,    1, 4, "G2 over E1" },   // 2 x G2 is a semitone under E1's 5th
+};
+
+typedef struct {
+    std::vector<double> lockTimes;  // ms
+    int     plucks = 0;
+    int     lockedPlucks = 0;
+    int     readings = 0;
+    int     wrongReadings = 0;
+    double  sumAbsCents = 0;
+    double  maxAbsCents = 0;
+    int     settledReadings = 0;
+    double  sumSquaredSteps = 0;
+    int     steps = 0;
+} Tally;
+
+static double midi_to_frequency(int midiNote) {
+    return A4_FREQ * pow(2.0, (midiNote - 69) / 12.0);
+}
+
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return NAN;
+    }
+    std::sort(values.begin(), values.end());
+    size_t index = (size_t)std::min((double)values.size() - 1, floor(p * values.size()));
+    return values[index];
+}
+
+static PresetBank make_bank(const TuningPreset &preset) {
+    float targets[TUNING_PRESET_MAX_STRINGS];
+    for (size_t k = 0; k < preset.numStrings; k++) {
+        targets[k] = (float)midi_to_frequency(preset.midiNotes[k]);
+    }
+    return PresetBank(TUNER_PRESET_CONFIG, targets, preset.numStrings, TUNER_ADC_SAMPLE_RATE);
+}
+
+/// @brief Runs one pluck through the gate, the normalizer and the bank.
+/// @param pluckSeconds When `string` is plucked in `words`. Readings before
+/// then aren't counted.
+static void measure_pluck(const std::vector<uint32_t> &words, const TuningPreset &preset, size_t string, double trueFrequency, double pluckSeconds, Tally &tally) {
+    const size_t frameSize = TUNER_ADC_SAMPLES_PER_FRAME;
+    const double frameSeconds = (double)frameSize / TUNER_ADC_SAMPLE_RATE;
+    const int stableFrames = (int)ceil(STABLE_SECONDS / frameSeconds);
+    const NoiseGateConfig gateConfig = TUNER_GATE_CONFIG;
+
+    NoiseGate gate(gateConfig);
+    StreamingNormalizer normalizer(TUNER_ADC_SAMPLE_RATE, TUNER_DC_BLOCKER_HZ, TUNER_AGC_RELEASE_MS / 1000.0f, TUNER_AGC_MIN_LEVEL);
+    PresetBank bank = make_bank(preset);
+    alignas(ADC_FRAME_KERNEL_ALIGNMENT) float samples[TUNER_ADC_SAMPLES_PER_FRAME];
+
+    bool locked = false;
+    int correctRun = 0;
+    double candidateLock = 0;
+    double lastCents = NAN;
+
+    for (size_t start = 0; start + frameSize <= words.size(); start += frameSize) {
+        double frameEnd = (double)(start + frameSize) / TUNER_ADC_SAMPLE_RATE - pluckSeconds;
+        float minVal, maxVal;
+        adc_frame_unpack(&words[start], frameSize, samples, &minVal, &maxVal);
+
+        bool hasReading = false;
+        TuningBankReading reading;
+        if (!gate.process(samples, frameSize, (float)frameSeconds)) {
+            if (gate.didJustClose()) {
+                bank.reset();
+            }
+        } else {
+            if (gate.didJustOpen()) {
+                normalizer.reset(gate.getDC(), gate.getEnvelope() * (float)M_SQRT2);
+            }
+            for (size_t i = 0; i < frameSize; i++) {
+                bank(normalizer(samples[i]));
+            }
+            hasReading = bank.endFrame(frameSize, &reading);
+        }
+        if (frameEnd <= 0) {
+            continue; // Still before the pluck
+        }
+
+        bool correct = hasReading && reading.string == string;
+        if (hasReading) {
+            tally.readings++;
+            if (!correct) {
+                tally.wrongReadings++;
+            }
+        }
+
+        if (!locked) {
+            if (correct) {
+                if (correctRun == 0) {
+                    candidateLock = frameEnd;
+                }
+                if (++correctRun >= stableFrames) {
+                    locked = true;
+                    tally.lockedPlucks++;
+                    tally.lockTimes.push_back(candidateLock * 1000);
+                }
+            } else {
+                correctRun = 0;
+            }
+        } else if (correct) {
+            double cents = 1200 * log2(reading.frequency / trueFrequency);
+            tally.sumAbsCents += fabs(cents);
+            tally.maxAbsCents = std::max(tally.maxAbsCents, fabs(cents));
+            tally.settledReadings++;
+            if (!std::isnan(lastCents)) {
+                tally.sumSquaredSteps += (cents - lastCents) * (cents - lastCents);
+                tally.steps++;
+            }
+            lastCents = cents;
+        } else if (!hasReading) {
+            lastCents = NAN;
+        }
+    }
+    tally.plucks++;
+}
+
+static void add(Tally &total, const Tally &t) {
+    total.lockTimes.insert(total.lockTimes.end(), t.lockTimes.begin(), t.lockTimes.end());
+    total.plucks += t.plucks;
+    total.lockedPlucks += t.lockedPlucks;
+    total.readings += t.readings;
+    total.wrongReadings += t.wrongReadings;
+    total.sumAbsCents += t.sumAbsCents;
+    total.maxAbsCents = std::max(total.maxAbsCents, t.maxAbsCents);
+    total.settledReadings += t.settledReadings;
+    total.sumSquaredSteps += t.sumSquaredSteps;
+    total.steps += t.steps;
+}
+
+static void print_tally(const char *name, const Tally &t) {
+    printf("%-22s %6d %7d %7.0fms %7.0fms %8.2f %8.2f %8.3f %7.1f%%\n",
+        name, t.plucks, t.lockedPlucks,
+        percentile(t.lockTimes, 0.5), percentile(t.lockTimes, 0.9),
+        t.settledReadings > 0 ? t.sumAbsCents / t.settledReadings : NAN, t.maxAbsCents,
+        t.steps > 0 ? sqrt(t.sumSquaredSteps / t.steps) : NAN,
+        t.readings > 0 ? 100.0 * t.wrongReadings / t.readings : 0.0);
+}
+
+int main(int argc, char *argv[]) {
+    bool quick = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else {
+            fprintf(stderr, "Usage: tuning_bank_bench [--quick]\n");
+            return 1;
+        }
+    }
+
+    size_t numDetunes = quick ? 1 : sizeof(detuneCents) / sizeof(detuneCents[0]);
+    size_t numNoises = quick ? 1 : sizeof(noiseDbs) / sizeof(noiseDbs[0]);
+    size_t numDecays = quick ? 1 : sizeof(decaySeconds) / sizeof(decaySeconds[0]);
+    size_t numLevels = quick ? 1 : sizeof(levels) / sizeof(levels[0]);
+
+    printf("%-22s %6s %7s %9s %9s %8s %8s %8s %8s\n", "string", "plucks", "locked", "lock p50", "lock p90", "|cents|", "max|c|", "jitter", "wrong");
+
+    Tally total;
+    uint32_t seed = CORPUS_SEED;
+    for (int p = tuningPresetOff + 1; p < tuningPresetCount; p++) {
+        const TuningPreset &preset = tuning_preset((TunerTuningPreset)p);
+        for (size_t k = 0; k < preset.numStrings; k++) {
+            Tally tally;
+            for (size_t d = 0; d < numDetunes; d++) {
+                for (size_t n = 0; n < numNoises; n++) {
+                    for (size_t t = 0; t < numDecays; t++) {
+                        for (size_t l = 0; l < numLevels; l++) {
+                            float detune = quick ? 0 : detuneCents[d];
+                            PluckSpec spec = {
+                                .frequency = (float)(midi_to_frequency(preset.midiNotes[k]) * pow(2.0, detune / 1200)),
+                                .decaySeconds = decaySeconds[t],
+                                .level = levels[l],
+                                .noiseDb = noiseDbs[n],
+                                .silenceSeconds = PLUCK_SILENCE_SECONDS,
+                                .durationSeconds = PLUCK_DURATION_SECONDS,
+                                .seed = seed++,
+                            };
+                            std::vector<uint32_t> words = quantize_to_adc_words(render_pluck(spec, TUNER_ADC_SAMPLE_RATE), 1.0f);
+                            measure_pluck(words, preset, k, spec.frequency, PLUCK_SILENCE_SECONDS, tally);
+                        }
+                    }
+                }
+            }
+            char name[64];
+            snprintf(name, sizeof(name), "%s %d", preset.name, (int)k + 1);
+            print_tally(name, tally);
+            add(total, tally);
+        }
+    }
+    print_tally("all", total);
+
+    printf("\n%-22s %6s %7s %9s %9s %8s %8s %8s %8s\n", "over a ringing string", "plucks", "locked", "lock p50", "lock p90", "|cents|", "max|c|", "jitter", "wrong");
+    Tally ringingTotal;
+    for (const RingingCase &ringingCase : ringingCases) {
+        const TuningPreset &preset = tuning_preset(ringingCase.preset);
+        Tally tally;
+        for (size_t d = 0; d < numDetunes; d++) {
+            for (size_t n = 0; n < numNoises; n++) {
+                float detune = quick ? 0 : detuneCents[d];
+                PluckSpec lower = {
+                    .frequency = (float)midi_to_frequency(preset.midiNotes[ringingCase.ringing]),
+                    .decaySeconds = RINGING_DECAY_SECONDS,
+                    .level = RINGING_LEVEL,
+                    .noiseDb = noiseDbs[n],
+                    .silenceSeconds = PLUCK_SILENCE_SECONDS,
+                    .durationSeconds = RINGING_SECONDS + PLUCK_DURATION_SECONDS,
+                    .seed = seed++,
+                };
+                PluckSpec upper = {
+                    .frequency = (float)(midi_to_frequency(preset.midiNotes[ringingCase.plucked]) * pow(2.0, detune / 1200)),
+                    .decaySeconds = RINGING_DECAY_SECONDS,
+                    .level = RINGING_LEVEL,
+                    .noiseDb = -200, // Already in the lower pluck
+                    .silenceSeconds = PLUCK_SILENCE_SECONDS + RINGING_SECONDS,
+                    .durationSeconds = PLUCK_DURATION_SECONDS,
+                    .seed = seed++,
+                };
+                std::vector<float> mix = render_pluck(lower, TUNER_ADC_SAMPLE_RATE);
+                std::vector<float> pluck = render_pluck(upper, TUNER_ADC_SAMPLE_RATE);
+                for (size_t i = 0; i < mix.size() && i < pluck.size(); i++) {
+                    mix[i] += pluck[i];
+                }
+                std::vector<uint32_t> words = quantize_to_adc_words(mix, 1.0f);
+                measure_pluck(words, preset, ringingCase.plucked, upper.frequency, upper.silenceSeconds, tally);
+            }
+        }
+        print_tally(ringingCase.name, tally);
+        add(ringingTotal, tally);
+    }
+    print_tally("all", ringingTotal);
+
+    // CPU cost of the bank alone on a guitar tuning (6 strings, 12
+    // resonators), as the chain runs it inside its per-sample loop.
+    PluckSpec spec = {
+        .frequency = (float)midi_to_frequency(45),
+        .decaySeconds = 6.0f,
+        .level = 1.0f,
+        .noiseDb = -45,
+        .silenceSeconds = 0,
+        .durationSeconds = PLUCK_DURATION_SECONDS,
+        .seed = CORPUS_SEED,
+    };
+    std::vector<float> samples = render_pluck(spec, TUNER_ADC_SAMPLE_RATE);
+    const size_t frameSize = TUNER_ADC_SAMPLES_PER_FRAME;
+    PresetBank bank = make_bank(tuning_preset(tuningPresetStandard));
+    TuningBankReading reading;
+    volatile float sink = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < TIMING_PASSES; pass++) {
+        bank.reset();
+        for (size_t start = 0; start + frameSize <= samples.size(); start += frameSize) {
+            for (size_t i = 0; i < frameSize; i++) {
+                bank(samples[start + i]);
+            }
+            if (bank.endFrame(frameSize, &reading)) {
+                sink = sink + reading.cents;
+            }
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    double numSamples = (double)samples.size() * TIMING_PASSES;
+    printf("\nper sample: %.2f ns for %zu resonators (%.3f%% of real time at %d Hz)\n",
+        seconds / numSamples * 1e9, 2 * bank.getNumStrings(), seconds / numSamples * TUNER_ADC_SAMPLE_RATE * 100, TUNER_ADC_SAMPLE_RATE);
+    return 0;
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "wav_file.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "adc_frame_kernel.h"
+
+#define WAV_FORMAT_PCM          1
+#define WAV_FORMAT_IEEE_FLOAT   3
+#define WAV_FORMAT_EXTENSIBLE   0xFFFE
+
+static uint32_t read_le(const uint8_t *p, int numBytes) {
+    uint32_t value = 0;
+    for (int i = 0; i < numBytes; i++) {
+        value |= (uint32_t)p[i] << (8 * i);
+    }
+    return value;
+}
+
+static bool read_file(const std::string &path, std::vector<uint8_t> &bytes, std::string &error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "Unable to open " + path;
+        return false;
+    }
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool read_wav_file(const std::string &path, std::vector<float> &samples, uint32_t &sampleRate, std::string &error) {
+    std::vector<uint8_t> bytes;
+    if (!read_file(path, bytes, error)) {
+        return false;
+    }
+    if (bytes.size() < 12 || memcmp(&bytes[0], "RIFF", 4) != 0 || memcmp(&bytes[8], "WAVE", 4) != 0) {
+        error = path + " is not a WAV file";
+        return false;
+    }
+
+    uint16_t format = 0;
+    uint16_t numChannels = 0;
+    uint16_t bitsPerSample = 0;
+    const uint8_t *data = NULL;
+    size_t dataSize = 0;
+
+    // Walk the chunks looking for "fmt " and "data".
+    size_t pos = 12;
+    while (pos + 8 <= bytes.size()) {
+        const uint8_t *chunk = &bytes[pos];
+        size_t chunkSize = read_le(chunk + 4, 4);
+        size_t available = std::min(chunkSize, bytes.size() - pos - 8);
+        if (memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+            format = read_le(chunk + 8, 2);
+            numChannels = read_le(chunk + 10, 2);
+            sampleRate = read_le(chunk + 12, 4);
+            bitsPerSample = read_le(chunk + 22, 2);
+            if (format == WAV_FORMAT_EXTENSIBLE && available >= 26) {
+                format = read_le(chunk + 32, 2); // first two bytes of the sub-format GUID
+            }
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            data = chunk + 8;
+            dataSize = available;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1); // chunks are padded to an even size
+    }
+
+    if (data == NULL || numChannels == 0) {
+        error = path + " is missing its fmt or data chunk";
+        return false;
+    }
+
+    bool isFloat = format == WAV_FORMAT_IEEE_FLOAT && bitsPerSample == 32;
+    bool isPCM = format == WAV_FORMAT_PCM && (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+    if (!isFloat && !isPCM) {
+        error = path + ": only 16/24/32-bit PCM and 32-bit float WAV files are supported";
+        return false;
+    }
+
+    int bytesPerSample = bitsPerSample / 8;
+    size_t frameBytes = (size_t)bytesPerSample * numChannels;
+    size_t numFrames = dataSize / frameBytes;
+    samples.resize(numFrames);
+    for (size_t i = 0; i < numFrames; i++) {
+        const uint8_t *p = data + i * frameBytes; // first channel only
+        uint32_t raw = read_le(p, bytesPerSample);
+        if (isFloat) {
+            float value;
+            memcpy(&value, &raw, sizeof(value));
+            samples[i] = value;
+        } else {
+            // Sign extend and scale to -1.0 ... +1.0
+            int shift = 32 - bitsPerSample;
+            int32_t value = (int32_t)(raw << shift) >> shift;
+            samples[i] = (float)value / (float)(1u << (bitsPerSample - 1));
+        }
+    }
+    return true;
+}
+
+static void write_le(std::ofstream &file, uint32_t value, int numBytes) {
+    for (int i = 0; i < numBytes; i++) {
+        file.put((char)((value >> (8 * i)) & 0xFF));
+    }
+}
+
+bool write_wav_file(const std::string &path, const std::vector<float> &samples, uint32_t sampleRate) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    uint32_t dataSize = (uint32_t)samples.size() * 2;
+    file.write("RIFF", 4);
+    write_le(file, 36 + dataSize, 4);
+    file.write("WAVE", 4);
+    file.write("fmt ", 4);
+    write_le(file, 16, 4);
+    write_le(file, WAV_FORMAT_PCM, 2);
+    write_le(file, 1, 2);                   // mono
+    write_le(file, sampleRate, 4);
+    write_le(file, sampleRate * 2, 4);      // byte rate
+    write_le(file, 2, 2);                   // block align
+    write_le(file, 16, 2);                  // bits per sample
+    file.write("data", 4);
+    write_le(file, dataSize, 4);
+    for (float sample : samples) {
+        int32_t value = (int32_t)std::lround(std::clamp(sample, -1.0f, 1.0f) * 32767);
+        write_le(file, (uint32_t)value, 2);
+    }
+    return (bool)file;
+}
+
+bool read_raw_adc_capture(const std::string &path, std::vector<uint32_t> &words, std::string &error) {
+    std::vector<uint8_t> bytes;
+    if (!read_file(path, bytes, error)) {
+        return false;
+    }
+    words.resize(bytes.size() / 4);
+    for (size_t i = 0; i < words.size(); i++) {
+        words[i] = read_le(&bytes[i * 4], 4);
+    }
+    return true;
+}
+
+std::vector<float> resample_linear(const std::vector<float> &samples, uint32_t fromRate, uint32_t toRate) {
+    if (fromRate == toRate || samples.empty()) {
+        return samples;
+    }
+    size_t numOut = (size_t)((double)samples.size() * toRate / fromRate);
+    std::vector<float> out(numOut);
+    double step = (double)fromRate / toRate;
+    for (size_t i = 0; i < numOut; i++) {
+        double position = i * step;
+        size_t index = (size_t)position;
+        double fraction = position - index;
+        float a = samples[std::min(index, samples.size() - 1)];
+        float b = samples[std::min(index + 1, samples.size() - 1)];
+        out[i] = (float)(a + (b - a) * fraction);
+    }
+    return out;
+}
+
+std::vector<uint32_t> quantize_to_adc_words(const std::vector<float> &samples, float gain) {
+    const float midScale = (ADC_FRAME_KERNEL_DATA_MASK + 1) / 2;
+    std::vector<uint32_t> words(samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        float value = std::round(midScale + samples[i] * gain * (midScale - 1));
+        words[i] = (uint32_t)std::clamp(value, 0.0f, (float)ADC_FRAME_KERNEL_DATA_MASK);
+    }
+    return words;
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_HOST_WAV_FILE)
+#define TUNER_HOST_WAV_FILE
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Reads the first channel of a PCM (16/24/32-bit integer) or 32-bit
+/// float WAV file into samples between -1.0 and +1.0.
+/// @return Returns false and fills in `error` if the file can't be read.
+bool read_wav_file(const std::string &path, std::vector<float> &samples, uint32_t &sampleRate, std::string &error);
+
+/// @brief Writes mono samples between -1.0 and +1.0 as a 16-bit PCM WAV file.
+bool write_wav_file(const std::string &path, const std::vector<float> &samples, uint32_t sampleRate);
+
+/// @brief Reads a raw ADC capture: little-endian 32-bit TYPE2 conversion
+/// words exactly as `adc_continuous_read()` returns them.
+bool read_raw_adc_capture(const std::string &path, std::vector<uint32_t> &words, std::string &error);
+
+/// @brief Linearly resamples `samples` from `fromRate` to `toRate`.
+std::vector<float> resample_linear(const std::vector<float> &samples, uint32_t fromRate, uint32_t toRate);
+
+/// @brief Quantizes samples between -1.0 and +1.0 to 12-bit ADC conversion
+/// words centered on mid-scale, like the tuner's input stage produces.
+std::vector<uint32_t> quantize_to_adc_words(const std::vector<float> &samples, float gain);
+
+#endif
@@ -19,8 +19,16 @@
 #if !defined(TUNER_GLOBAL_DEFINES)
 #define TUNER_GLOBAL_DEFINES
 
+#if defined(ESP_PLATFORM)
 #include "driver/gpio.h"
 #include "hal/adc_types.h"
+#else
+// Host builds (see host/) only use the DSP related defines. These mirror the
+// ESP32-S3 values so frame sizes match the firmware.
+#include <cstdint>
+#define SOC_ADC_DIGI_RESULT_BYTES           4
+#define SOC_ADC_DIGI_DATA_BYTES_PER_CONV    4
+#endif
 
 typedef enum {
     NOTE_C = 0,
@@ -77,6 +85,12 @@ typedef struct {
     float targetFrequency;
     TunerNoteName targetNote;
     int targetOctave;
+    int64_t timestampUs; // When the reading was published (0 if unknown)
+
+    // Only filled in when TUNER_PROFILE_LATENCY is on (see latency_trace.h)
+    int64_t adcIsrUs;   // Conversion done interrupt for the frame the reading came from
+    int64_t adcReadUs;  // When that frame was read from the ADC driver
+    int64_t detectUs;   // When the pitch detector returned the reading
 } FrequencyInfo;
 
 typedef enum : uint8_t {
@@ -88,13 +102,6 @@ typedef enum : uint8_t {
 // RTOS Queues
 //
 
-// The pitch detector task will always write the latest value of detection on
-// the queue. Use a length of 1 so we can use xQueueOverwrite and xQueuePeek so
-// the very latest frequency info is always available to anywhere.
-
-#define FREQUENCY_QUEUE_LENGTH 1
-#define FREQUENCY_QUEUE_ITEM_SIZE sizeof(FrequencyInfo)
-
 #define TUNER_STATE_QUEUE_LENGTH 1
 #define TUNER_STATE_QUEUE_ITEM_SIZE sizeof(uint8_t)
 
@@ -120,6 +127,13 @@ typedef enum : uint8_t {
 #define LCD_DRAWBUF_SIZE                (LCD_H_RES * LCD_BUF_LINES)
 #define LCD_MIRROR_X                    (true)
 #define LCD_MIRROR_Y                    (false)
+// Set to 1 to rotate the screen in LVGL (every flush gets rotated in software)
+// instead of in the panel. Only useful to compare flush times against.
+#define LCD_SOFTWARE_ROTATION           0
+// Set to 1 to drive the panel in 12-bit (RGB444) mode. LVGL still renders
+// RGB565 and the flush packs it down, which sends 25% fewer bytes over SPI
+// per frame at the cost of 4 bits per channel. Needs panel rotation.
+#define LCD_RGB444                      0
 
 //
 // Default User Settings
@@ -138,6 +152,8 @@ typedef enum : uint8_t {
 #define DEFAULT_USE_1EU_FILTER_FIRST    (true)
 // #define DEFAULT_MOVING_AVG_WINDOW       ((float) 100)
 #define DEFAULT_DISPLAY_BRIGHTNESS      ((uint8_t) 7) // equates to 80% brightness because we're storing the value as a 0-based integer (0 - 10%, 1 - 20%, etc.)
+#define DEFAULT_INSTRUMENT              ((TunerInstrument) instrumentChromatic)
+#define DEFAULT_TUNING_PRESET           ((TunerTuningPreset) tuningPresetOff)
 
 //
 // Pitch Detector Related
@@ -172,11 +188,42 @@ typedef enum : uint8_t {
 // #define TUNER_ADC_BUFFER_POOL_SIZE      (TUNER_ADC_FRAME_SIZE * 4)
 // #define TUNER_ADC_SAMPLE_RATE           (5 * 1000) // 5kHz 
 
+// Oversampling. Set to 4 or 8 (20kHz or 40kHz for Chromatic) to run the ADC
+// that many times faster than the detector's sample rate and bring it back
+// down with a FIR decimator (main/utils/Decimator.hpp) that removes
+// everything that would alias into the detector range. The pitch detector
+// still sees the instrument profile's sample rate and frame length. The
+// hardware IIR filter stays on, so its corner moves up by the same factor.
+// 1 turns it off and leaves the IIR filter as the only anti-alias filter.
+#if !defined(TUNER_ADC_DECIMATION)
+#define TUNER_ADC_DECIMATION            1
+#endif
+
 // EBD2 @ 5kHz
-#define TUNER_ADC_FRAME_SIZE            (SOC_ADC_DIGI_DATA_BYTES_PER_CONV * 64)
+//
+// These are the Chromatic instrument profile. The other profiles in
+// main/instrument_profiles.h pick their own sample rate and frame size (the
+// ADC converts at the profile's rate times TUNER_ADC_DECIMATION, at most
+// 83.3kHz on the S3), but never more samples per frame than this.
+#define TUNER_ADC_FRAME_SIZE            (SOC_ADC_DIGI_DATA_BYTES_PER_CONV * 64 * TUNER_ADC_DECIMATION)
 #define TUNER_ADC_BUFFER_POOL_SIZE      (TUNER_ADC_FRAME_SIZE * 4)
 #define TUNER_ADC_SAMPLE_RATE           (5 * 1000) // 5kHz
 
+// Number of 12-bit conversions that fit into a single ADC conversion frame.
+#define TUNER_ADC_CONVERSIONS_PER_FRAME (TUNER_ADC_FRAME_SIZE / SOC_ADC_DIGI_RESULT_BYTES)
+
+// Number of samples at TUNER_ADC_SAMPLE_RATE a conversion frame turns into.
+#define TUNER_ADC_SAMPLES_PER_FRAME     (TUNER_ADC_CONVERSIONS_PER_FRAME / TUNER_ADC_DECIMATION)
+
+// Number of preallocated sample frames handed between the ADC ingest stage
+// and the pitch detection stage. Must be a power of two.
+#define TUNER_ADC_FRAME_POOL_SIZE       4
+
+// Set to 1 to periodically log how long each stage of the pitch detector
+// takes per frame (min/avg/max in microseconds).
+#define TUNER_PROFILE_PITCH_DETECTOR    0
+#define TUNER_PROFILE_REPORT_FRAMES     1000 // frames between profile reports
+
 /*
     ADC_DIGI_IIR_FILTER_COEFF_2,     ///< The filter coefficient is 2
     ADC_DIGI_IIR_FILTER_COEFF_4,     ///< The filter coefficient is 4
@@ -206,14 +253,80 @@ typedef enum : uint8_t {
 // #define TUNER_ADC_BUFFER_POOL_SIZE      (TUNER_ADC_FRAME_SIZE * 4)
 // #define TUNER_ADC_SAMPLE_RATE           (5 * 1000) // 5kHz
 
-// If the difference between the minimum and maximum input values
-// is less than this value, discard the reading and do not evaluate
-// the frequency. This should help cut down on the noise from the
-// OLED and only attempt to read frequency information when an
-// actual input signal is being read.
-// #define TUNER_READING_DIFF_MINIMUM      80
-// #define TUNER_READING_DIFF_MINIMUM      100
-#define TUNER_READING_DIFF_MINIMUM      600
+//
+// Noise Gate
+//
+// Frames are only run through the pitch detector while the gate is open.
+// This cuts out the noise from the display and the rest of the board so
+// frequency information is only read when there is an actual input signal.
+// The gate measures the RMS of each frame (in ADC counts), learns the noise
+// floor while it is closed and opens and closes relative to that floor
+// (see main/utils/NoiseGate.hpp). It replaces a fixed 600 count minimum
+// between the smallest and largest sample of a frame, which a decaying low
+// string kept crossing.
+//
+#define TUNER_GATE_INITIAL_FLOOR        50      // RMS. Opens at ~200 RMS (~570 peak-to-peak) until the floor is learned
+#define TUNER_GATE_MIN_FLOOR            15
+#define TUNER_GATE_MAX_FLOOR            75
+#define TUNER_GATE_OPEN_RATIO           4.0f    // +12 dB over the floor to open
+#define TUNER_GATE_CLOSE_RATIO          2.0f    // +6 dB over the floor to stay open
+#define TUNER_GATE_HOLD_MS              150     // How long it has to be below the close level to close
+#define TUNER_GATE_RELEASE_MS           50      // Envelope decay time constant
+#define TUNER_GATE_FLOOR_RISE_MS        2000    // The floor creeps up slowly so a soft note isn't learned as noise...
+#define TUNER_GATE_FLOOR_FALL_MS        200     // ...and drops quickly after a loud burst
+#define TUNER_GATE_DC_MS                1000    // Tracks the input bias
+
+// Initializer for the `NoiseGateConfig` built from the values above.
+#define TUNER_GATE_CONFIG { \
+    .initialFloor = TUNER_GATE_INITIAL_FLOOR, \
+    .minFloor = TUNER_GATE_MIN_FLOOR, \
+    .maxFloor = TUNER_GATE_MAX_FLOOR, \
+    .openRatio = TUNER_GATE_OPEN_RATIO, \
+    .closeRatio = TUNER_GATE_CLOSE_RATIO, \
+    .holdSeconds = TUNER_GATE_HOLD_MS / 1000.0f, \
+    .releaseSeconds = TUNER_GATE_RELEASE_MS / 1000.0f, \
+    .floorRiseSeconds = TUNER_GATE_FLOOR_RISE_MS / 1000.0f, \
+    .floorFallSeconds = TUNER_GATE_FLOOR_FALL_MS / 1000.0f, \
+    .dcSeconds = TUNER_GATE_DC_MS / 1000.0f, \
+}
+
+//
+// Input Normalization
+//
+// Set to 1 to bring the samples to -1.0 to +1.0 with a DC blocker and a slow
+// AGC that run continuously across frames (main/utils/StreamingNormalizer.hpp).
+// Set to 0 to normalize every frame by its own min and max, which makes the
+// offset and scale jump at every frame boundary.
+#if !defined(TUNER_STREAMING_NORMALIZER)
+#define TUNER_STREAMING_NORMALIZER      1
+#endif
+#define TUNER_DC_BLOCKER_HZ             5       // Well below the low B on a 5-string bass (31 Hz)
+#define TUNER_AGC_RELEASE_MS            200     // Level decay time constant
+#define TUNER_AGC_MIN_LEVEL             30      // ADC counts
+
+//
+// Tuning Presets
+//
+// With a tuning preset picked (main/tuning_presets.h) the q pitch detector
+// is not used. A bank of resonators on the strings of the tuning
+// (main/utils/TuningBank.hpp) tells which string is ringing and how far off
+// it is. A string more than TUNER_PRESET_MAX_CENTS off shows nothing, so
+// tune way-off strings with the preset off first.
+//
+#define TUNER_PRESET_BANDWIDTH          0.03f   // Resonator corner, about half a semitone either side
+#define TUNER_PRESET_OCTAVE_RATIO       0.01f   // -20 dB
+#define TUNER_PRESET_MIN_SHARE          0.25f
+#define TUNER_PRESET_MAX_CENTS          100
+#define TUNER_PRESET_STABLE_FRAMES      2
+
+// Initializer for the `TuningBankConfig` built from the values above.
+#define TUNER_PRESET_CONFIG { \
+    .bandwidth = TUNER_PRESET_BANDWIDTH, \
+    .octaveRatio = TUNER_PRESET_OCTAVE_RATIO, \
+    .minShare = TUNER_PRESET_MIN_SHARE, \
+    .maxCents = TUNER_PRESET_MAX_CENTS, \
+    .stableFrames = TUNER_PRESET_STABLE_FRAMES, \
+}
 
 //
 // Smoothing
@@ -230,6 +343,11 @@ typedef enum : uint8_t {
 #define EU_FILTER_BETA_2                ((float) 0.05)
 #define EU_FILTER_DERIVATIVE_CUTOFF_2   1.0
 
+// Rolling median of the raw detector output, applied before the 1EU filters
+// to knock out single-period octave jumps. Set to an odd window size
+// (MIN_MEDIAN_WINDOW_SIZE - MAX_MEDIAN_WINDOW_SIZE) to enable or 0 to disable.
+#define TUNER_MEDIAN_PREFILTER_WINDOW   0
+
 // Exponential Smoothing
 #define EXP_SMOOTHING                  ((float) 0.5)
 
@@ -244,6 +362,54 @@ typedef enum : uint8_t {
 
 #define GEAR_SYMBOL "\xEF\x80\x93"
 
+//
+// GUI frame pacing. The GUI task sleeps until the pitch detector publishes a
+// new reading (or the tuner state changes) and renders right away, but never
+// more often than every TUNER_GUI_MIN_FRAME_INTERVAL_MS. While a note is
+// showing it also renders every TUNER_GUI_ANIMATION_FRAME_INTERVAL_MS without
+// a new reading because the strobe and record UIs advance their animation on
+// every frame (so changing this changes how fast they spin). When no note is
+// showing nothing is drawn, but the task still wakes for LVGL's own timers
+// (fade-outs, animations) on their deadlines.
+//
+#define TUNER_GUI_MIN_FRAME_INTERVAL_MS         33
+#define TUNER_GUI_ANIMATION_FRAME_INTERVAL_MS   33
+#define TUNER_GUI_IDLE_WAIT_MS                  500 // Longest the GUI task sleeps without a notification or LVGL timer
+
+// Set to 1 to periodically log frames rendered/skipped and the time from
+// a reading being published to it being rendered.
+#define TUNER_PROFILE_GUI                       0
+#define TUNER_PROFILE_GUI_REPORT_FRAMES         300 // frames between profile reports
+
+// Set to 1 to periodically log how long LVGL spends in the flush callback and
+// in the whole refresh per frame, along with the current screen rotation.
+#define TUNER_PROFILE_DISPLAY_FLUSH             0
+#define TUNER_PROFILE_DISPLAY_REPORT_FRAMES     300 // frames between profile reports
+
+// Set to 1 to periodically log how many times each tuner UI changed a label's
+// text or visibility and how many updates were skipped because the text on
+// the screen would have been the same.
+#define TUNER_PROFILE_LABELS                    0
+#define TUNER_PROFILE_LABELS_REPORT_FRAMES      300 // frames between profile reports
+
+// Set to 1 to trace readings from the ADC interrupt all the way to the last
+// pixel of the frame that shows them leaving over SPI. Latency histograms for
+// each stage are logged periodically and can be viewed in Settings > Advanced.
+// The trace hasn't been run on a pedal yet, so neither the stamps nor the
+// histograms have been checked against a real reading.
+#define TUNER_PROFILE_LATENCY                   0
+#define TUNER_PROFILE_LATENCY_REPORT_READINGS   500 // traced readings between reports
+
+// Set to 1 to log how long after the foot switch edge the bypass relay was
+// switched for every single press.
+#define TUNER_PROFILE_FOOTSWITCH                0
+
+// Set to 1 to log how long after a TunerController state change gpio_task
+// switched the bypass relay, along with the running min/avg/max. No numbers
+// have been recorded yet. gpio_task shares core 0 with adc_ingest_task, which
+// has the higher priority, so a switch can wait behind a frame being drained.
+#define TUNER_PROFILE_RELAY                     0
+
 //
 // When the pitch stops being detected, the note can fade out. This is how long
 // that animation is set to run for.
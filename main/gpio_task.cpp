@@ -21,6 +21,9 @@
 #include "defines.h"
 #include "tuner_controller.h"
 #include "user_settings.h"
+#include "FootswitchGestures.hpp"
+#include "SPSCRing.hpp"
+#include "StageProfiler.hpp"
 
 #include "lvgl.h"
 // #include "esp_lvgl_port.h"
@@ -28,6 +31,10 @@
 #include "freertos/FreeRTOS.h"
 #include "esp_timer.h"
 
+#include <algorithm>
+#include <climits>
+#include <inttypes.h>
+
 // #include "multi_button.h"
 
 static const char *TAG = "GPIO";
@@ -41,12 +48,22 @@ extern QueueHandle_t bypassTypeSettingsScreenQeuue;
 uint32_t current_bypass_relay_level = 0; // Off at launch
 uint32_t current_bypass_type_relay_level = 0; // Off at launch
 
-int footswitch_last_state = 1; // Assume initial state is open (active-high logic and conveniently matches the physical position of the footswitch)
-int footswitch_press_count = 0;
-int64_t footswitch_start_time = 0;
-int64_t footswitch_last_press_time = 0;
-bool footswitch_long_press_triggered = false;
-esp_timer_handle_t single_press_timer;
+/// @brief A foot switch level change seen by the GPIO interrupt.
+typedef struct {
+    int64_t timeUs;
+    bool pressed;
+} FootswitchEdge;
+
+#define FOOTSWITCH_EDGE_RING_SIZE   32
+
+static SPSCRing<FootswitchEdge, FOOTSWITCH_EDGE_RING_SIZE> footswitch_edges; // GPIO interrupt -> gpio_task
+static FootswitchGestures footswitch_gestures(DEBOUNCE_TIME_MS * 1000, DOUBLE_PRESS_TIME_MS * 1000, LONG_PRESS_TIME_MS * 1000);
+static esp_timer_handle_t footswitch_timer = NULL; // Wakes gpio_task for the next footswitch_gestures deadline
+static TaskHandle_t gpio_task_handle = NULL;
+
+#if TUNER_PROFILE_RELAY
+static StageProfiler relay_profiler("state change -> relay");
+#endif
 
 // struct Button footswitchButton;
 // PressEvent footswitch_btn_state;
@@ -55,24 +72,47 @@ esp_timer_handle_t single_press_timer;
 // Local Function Declarations
 //
 void configure_gpio_pins();
-void handle_button_press();
-void ensure_relay_state();
-void handle_single_press(void *param);
+static void footswitch_isr_handler(void *arg);
+static void footswitch_timer_callback(void *arg);
+void handle_footswitch();
+void handle_footswitch_gesture(FootswitchGesture gesture, int64_t edge_time_us);
+int64_t apply_relay_state();
+void handle_single_press(int64_t edge_time_us);
+void handle_settings_single_press(void *param);
 void handle_double_press(void *param);
 void handle_long_press(void *param);
-void single_press_timer_callback(void* arg);
-void start_single_press_timer();
-void cancel_single_press_timer();
 
 void gpio_task(void *pvParameter) {
     ESP_LOGI(TAG, "GPIO task started");
+    gpio_task_handle = xTaskGetCurrentTaskHandle();
     configure_gpio_pins();
+    tunerController->addStateSubscriber(gpio_task_handle, GPIO_NOTIFY_TUNER_STATE);
+    apply_relay_state(); // In case the state or settings changed before subscribing
 
     // double last_time = 0.0;
 
     while(1) {
-        handle_button_press();
-        ensure_relay_state();
+        // Nothing to do until the foot switch, the tuner state or the bypass
+        // settings change.
+        uint32_t notifications = 0;
+        xTaskNotifyWait(0, ULONG_MAX, &notifications, portMAX_DELAY);
+
+        if (notifications & GPIO_NOTIFY_FOOTSWITCH) {
+            handle_footswitch();
+        }
+        if (notifications & (GPIO_NOTIFY_TUNER_STATE | GPIO_NOTIFY_RELAY_SETTINGS)) {
+            int64_t relay_switched_us = apply_relay_state();
+#if TUNER_PROFILE_RELAY
+            if (relay_switched_us != 0 && (notifications & GPIO_NOTIFY_TUNER_STATE)) {
+                relay_profiler.addSample(relay_switched_us - tunerController->getLastStateChangeUs());
+                ESP_LOGI(TAG, "%s: %" PRId64 " us (min %" PRId64 " us, avg %" PRId64 " us, max %" PRId64 " us over %" PRIu32 ")",
+                    relay_profiler.getName(), relay_switched_us - tunerController->getLastStateChangeUs(),
+                    relay_profiler.getMin(), relay_profiler.getAverage(), relay_profiler.getMax(), relay_profiler.getCount());
+            }
+#else
+            (void)relay_switched_us;
+#endif
+        }
 
         // int64_t time_us = esp_timer_get_time(); // Get time in microseconds
         // double time_ms = time_us / 1000; // Convert to milliseconds
@@ -84,8 +124,6 @@ void gpio_task(void *pvParameter) {
         //     int current_footswitch_state = gpio_get_level(FOOT_SWITCH_GPIO);
         //     ESP_LOGI(TAG, "Footswitch State: %d", current_footswitch_state);
         // }
-
-        vTaskDelay(pdMS_TO_TICKS(50)); // Small delay for debouncing
     }
     vTaskDelay(portMAX_DELAY);
 }
@@ -98,11 +136,23 @@ void configure_gpio_pins() {
         .mode = GPIO_MODE_INPUT,
         .pull_up_en = GPIO_PULLUP_ENABLE,   // Enable internal pull-up resistor
         .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE      // Disable interrupt for this pin
+        .intr_type = GPIO_INTR_ANYEDGE      // Both edges, footswitch_gestures does the debouncing
     };
 
     gpio_config(&foot_switch_gpio_conf);
 
+    const esp_timer_create_args_t footswitch_timer_args = {
+        .callback = &footswitch_timer_callback,
+        .name = "footswitch_timer"
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&footswitch_timer_args, &footswitch_timer));
+
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_ERR_INVALID_STATE) { // Already installed is fine
+        ESP_ERROR_CHECK(err);
+    }
+    ESP_ERROR_CHECK(gpio_isr_handler_add(FOOT_SWITCH_GPIO, footswitch_isr_handler, NULL));
+
     // Configure the bypass relay GPIO as an output pin
     gpio_reset_pin(BYPASS_RELAY_GPIO);
     gpio_config_t relay_gpio_conf = {
@@ -138,69 +188,80 @@ void configure_gpio_pins() {
     ESP_LOGI(TAG, "GPIO Pins Configured");
 }
 
-void handle_button_press() {
-    // Detect press, double-press, and long press.
-    int current_footswitch_state = gpio_get_level(FOOT_SWITCH_GPIO);
+/// @brief Timestamps every foot switch edge and wakes up gpio_task.
+static void footswitch_isr_handler(void *arg) {
+    // Active low: the switch pulls the pin to ground when pressed.
+    FootswitchEdge edge = {
+        .timeUs = esp_timer_get_time(),
+        .pressed = gpio_get_level(FOOT_SWITCH_GPIO) == 0,
+    };
+    footswitch_edges.push(edge); // If the ring is full the switch is bouncing, which gets ignored anyway
 
-    if (current_footswitch_state == 0 && footswitch_last_state == 1) {
-        // Button pressed
-        footswitch_start_time = esp_timer_get_time() / 1000; // Get time in ms
-        int64_t now = footswitch_start_time;
+    BaseType_t mustYield = pdFALSE;
+    xTaskNotifyFromISR(gpio_task_handle, GPIO_NOTIFY_FOOTSWITCH, eSetBits, &mustYield);
+    portYIELD_FROM_ISR(mustYield);
+}
 
-        if ((now - footswitch_last_press_time) <= DOUBLE_PRESS_TIME_MS) {
-            footswitch_press_count++;
-        } else {
-            footswitch_press_count = 1;
-        }
+static void footswitch_timer_callback(void *arg) {
+    xTaskNotify(gpio_task_handle, GPIO_NOTIFY_FOOTSWITCH, eSetBits);
+}
 
-        footswitch_last_press_time = now;
-        footswitch_long_press_triggered = false; // Reset long press trigger when pressed
+void gpio_relay_settings_changed() {
+    if (gpio_task_handle != NULL) {
+        xTaskNotify(gpio_task_handle, GPIO_NOTIFY_RELAY_SETTINGS, eSetBits);
     }
+}
 
-    if (current_footswitch_state == 0) {
-        // Button is being held down
-        int64_t press_duration = (esp_timer_get_time() / 1000) - footswitch_start_time;
+/// Runs the foot switch edges and any deadlines that have passed through
+/// footswitch_gestures, then sets the timer for the next deadline.
+void handle_footswitch() {
+    footswitch_gestures.setWaitsForDoublePress(tunerController->getState() == tunerStateSettings);
 
-        if (press_duration >= LONG_PRESS_TIME_MS && !footswitch_long_press_triggered) {
-            lv_async_call(handle_long_press, NULL);
-            footswitch_long_press_triggered = true; // Ensure long press is only triggered once
-            footswitch_press_count = 0; // Reset press count after a long press
-            vTaskDelay(pdMS_TO_TICKS(200)); // Small delay for visual feedback
-        }
+    FootswitchEdge edge;
+    while (footswitch_edges.pop(edge)) {
+        handle_footswitch_gesture(footswitch_gestures.edge(edge.pressed, edge.timeUs), edge.timeUs);
     }
 
-    if (current_footswitch_state == 1 && footswitch_last_state == 0) {
-        // Button released
-        if (!footswitch_long_press_triggered) {
-            int64_t press_duration = (esp_timer_get_time() / 1000) - footswitch_start_time;
-
-            if (footswitch_press_count == 2) {
-                cancel_single_press_timer(); // kill the timer if it's running
-                lv_async_call(handle_double_press, NULL);
-                footswitch_press_count = 0; // Reset press count after double press
-                vTaskDelay(pdMS_TO_TICKS(200)); // Small delay for visual feedback
-            } else if (press_duration < LONG_PRESS_TIME_MS && footswitch_press_count == 1) {
-                if (tunerController->getState() == tunerStateSettings) {
-                    start_single_press_timer();
-                } else {
-                    // Fire a single press right away
-                    single_press_timer_callback(NULL);
-                }
-            } else {
-                footswitch_press_count = 0; // Reset press count if it ever hits this condition
-            }
-        }
+    int64_t now = esp_timer_get_time();
+    while (footswitch_gestures.nextDeadlineUs() <= now) {
+        bool pressed = gpio_get_level(FOOT_SWITCH_GPIO) == 0;
+        handle_footswitch_gesture(footswitch_gestures.timeout(pressed, now), now);
     }
 
-    footswitch_last_state = current_footswitch_state;    
+    esp_timer_stop(footswitch_timer); // Fails harmlessly if it isn't running
+    int64_t deadline = footswitch_gestures.nextDeadlineUs();
+    if (deadline != FOOTSWITCH_NO_DEADLINE) {
+        esp_timer_start_once(footswitch_timer, std::max(deadline - esp_timer_get_time(), (int64_t)1));
+    }
+}
+
+/// @param edge_time_us When the edge (or deadline) that completed the gesture happened.
+void handle_footswitch_gesture(FootswitchGesture gesture, int64_t edge_time_us) {
+    switch (gesture) {
+    case footswitchGestureSingle:
+        handle_single_press(edge_time_us);
+        break;
+    case footswitchGestureDouble:
+        lv_async_call(handle_double_press, NULL);
+        break;
+    case footswitchGestureLong:
+        lv_async_call(handle_long_press, NULL);
+        break;
+    default:
+        break;
+    }
 }
 
-/// The purpose of this function is to make sure the relay is in the correct
-/// state according to the tuner's current state. This is really only needed
-/// for initial startup. We want to keep the controlling of the relay all done
-/// here in gpio_task but if the user has tuning set as their initial startup
-/// screen, we need to make sure to turn the relay on.
-void ensure_relay_state() {
+/// Puts the relays in the state the tuner state and bypass settings call for.
+/// Runs whenever TunerController changes state (including the initial state
+/// at startup) or the bypass settings change. Single presses in standby and
+/// tuning switch the relay themselves before changing the state so this
+/// finds it already set.
+///
+/// @return When the bypass relay was switched, or 0 if it was already set.
+int64_t apply_relay_state() {
+    int64_t relay_switched_us = 0;
+
     // Make sure the main bypass/tuning relay is in the correct state
 
     bool is_showing_bypass_type_settings_screen = false;
@@ -208,10 +269,12 @@ void ensure_relay_state() {
     if (current_state == tunerStateStandby && current_bypass_relay_level != 0) {
         gpio_set_level(BYPASS_RELAY_GPIO, 0); // Turn off relay
         current_bypass_relay_level = 0;
+        relay_switched_us = esp_timer_get_time();
         ESP_LOGI(TAG, "Turning OFF the bypass relay (going to standby mode)");
     } else if (current_state == tunerStateTuning && current_bypass_relay_level != 1) {
         gpio_set_level(BYPASS_RELAY_GPIO, 1); // Turn on relay
         current_bypass_relay_level = 1;
+        relay_switched_us = esp_timer_get_time();
         ESP_LOGI(TAG, "Turning ON the bypass relay (going to tuning mode)");
     } else if (current_state == tunerStateSettings && xQueuePeek(bypassTypeSettingsScreenQeuue, &is_showing_bypass_type_settings_screen, 0) == pdTRUE) {
         if (is_showing_bypass_type_settings_screen) {
@@ -220,6 +283,7 @@ void ensure_relay_state() {
             if (current_bypass_relay_level != 0) {
                 gpio_set_level(BYPASS_RELAY_GPIO, 0); // Turn off relay
                 current_bypass_relay_level = 0;
+                relay_switched_us = esp_timer_get_time();
                 ESP_LOGI(TAG, "Turning OFF the bypass relay (bypass type settings screen active)");
             }
         } else {
@@ -228,6 +292,7 @@ void ensure_relay_state() {
             if (current_bypass_relay_level != 1) {
                 gpio_set_level(BYPASS_RELAY_GPIO, 1); // Turn on relay
                 current_bypass_relay_level = 1;
+                relay_switched_us = esp_timer_get_time();
                 ESP_LOGI(TAG, "Turning ON the bypass relay (bypass type settings screen NOT active)");
             }
         }
@@ -246,40 +311,53 @@ void ensure_relay_state() {
             ESP_LOGI(TAG, "Turning ON the bypass type relay (going to buffered bypass mode)");
         }
     }
-}
 
-// Called on the LVGL task thread (tuner_gui_task).
-void handle_single_press(void *param) {
-    ESP_LOGI(TAG, "NORMAL PRESS detected");
+    return relay_switched_us;
+}
 
+// Called on gpio_task so the relay switches without waiting for LVGL.
+void handle_single_press(int64_t edge_time_us) {
+    // Log only after the relay is switched, logging can take milliseconds.
     TunerState state = tunerController->getState();
     switch (state) {
     case tunerStateStandby:
-        ESP_LOGI(TAG, "Turning ON the relay and going to tuning mode");
         // Turn on the relay which should mute the output
         gpio_set_level(BYPASS_RELAY_GPIO, 1); // Turn on relay
         current_bypass_relay_level = 1;
-        
+#if TUNER_PROFILE_FOOTSWITCH
+        ESP_LOGI(TAG, "Relay ON %" PRId64 " us after the foot switch edge", esp_timer_get_time() - edge_time_us);
+#endif
+        ESP_LOGI(TAG, "Turned ON the relay, going to tuning mode");
+
         // Go to tuning mode
         tunerController->setState(tunerStateTuning);
         break;
     case tunerStateTuning:
-        ESP_LOGI(TAG, "Turning OFF the relay and going to standby mode");
         // Turn off the relay which should unmute the output
         gpio_set_level(BYPASS_RELAY_GPIO, 0); // Turn off relay
         current_bypass_relay_level = 0;
+#if TUNER_PROFILE_FOOTSWITCH
+        ESP_LOGI(TAG, "Relay OFF %" PRId64 " us after the foot switch edge", esp_timer_get_time() - edge_time_us);
+#endif
+        ESP_LOGI(TAG, "Turned OFF the relay, going to standby mode");
 
         // Go to standby mode
         tunerController->setState(tunerStateStandby);
         break;
     case tunerStateSettings:
-        tunerController->footswitchPressed(footswitchSinglePress);
+        ESP_LOGI(TAG, "NORMAL PRESS detected");
+        lv_async_call(handle_settings_single_press, NULL);
         break;
     default:
         break;
     }
 }
 
+// Called on the LVGL task thread (tuner_gui_task).
+void handle_settings_single_press(void *param) {
+    tunerController->footswitchPressed(footswitchSinglePress);
+}
+
 // Called on the LVGL task thread (tuner_gui_task).
 void handle_double_press(void *param) {
     ESP_LOGI(TAG, "DOUBLE PRESS detected");
@@ -291,32 +369,3 @@ void handle_long_press(void *param) {
     ESP_LOGI(TAG, "LONG PRESS detected");
     tunerController->footswitchPressed(footswitchLongPress);
 }
-
-void single_press_timer_callback(void* arg) {
-    lv_async_call(handle_single_press, NULL);
-    footswitch_press_count = 0; // Reset press count after single press
-    vTaskDelay(pdMS_TO_TICKS(200)); // Small delay for visual feedback
-}
-
-void start_single_press_timer() {
-    if (single_press_timer != NULL) {
-        esp_timer_stop(single_press_timer);
-        esp_timer_delete(single_press_timer);
-    }
-
-    const esp_timer_create_args_t single_press_timer_args = {
-        .callback = &single_press_timer_callback,
-        .name = "single_press_timer"
-    };
-
-    esp_timer_create(&single_press_timer_args, &single_press_timer);
-    esp_timer_start_once(single_press_timer, DOUBLE_PRESS_TIME_MS * 1000); // Convert ms to us
-}
-
-void cancel_single_press_timer() {
-    if (single_press_timer != NULL) {
-        esp_timer_stop(single_press_timer);
-        esp_timer_delete(single_press_timer);
-        single_press_timer = NULL;
-    }
-}
@@ -19,4 +19,19 @@
 #if !defined(GPIO_TASK)
 #define GPIO_TASK
 
+#include <cstdint>
+
+//
+// Task notification bits that wake gpio_task. It sleeps until one of these
+// is set.
+//
+#define GPIO_NOTIFY_FOOTSWITCH          (1UL << 0)  // Foot switch edge or gesture deadline
+#define GPIO_NOTIFY_TUNER_STATE         (1UL << 1)  // TunerController changed state
+#define GPIO_NOTIFY_RELAY_SETTINGS      (1UL << 2)  // bypassTypeQueue or bypassTypeSettingsScreenQeuue changed
+
+/// @brief Tells gpio_task to set the relays again after writing to
+/// `bypassTypeQueue` or `bypassTypeSettingsScreenQeuue`. Safe to call before
+/// gpio_task has started.
+void gpio_relay_settings_changed();
+
 #endif
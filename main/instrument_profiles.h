@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_INSTRUMENT_PROFILES)
+#define TUNER_INSTRUMENT_PROFILES
+
+#include <cstddef>
+#include <cstdint>
+
+#include "defines.h"
+
+/// @brief The instruments the pitch detector can be specialized for. This is
+/// the index into `instrument_profiles` and it is stored in NVS, so only ever
+/// add new instruments right before `instrumentCount`.
+typedef enum : uint8_t {
+    instrumentChromatic = 0,
+    instrumentGuitar,
+    instrumentBass4,
+    instrumentBass5,
+    instrumentBass6,
+    instrumentBaritone,
+    instrumentUkulele,
+    instrumentViolinFamily,
+    instrumentCount,
+} TunerInstrument;
+
+/// @brief How the ADC and the pitch detector are set up for an instrument.
+///
+/// The pitch detector's analysis window has to hold a couple of periods of
+/// `lowFrequency`, so raising it is what makes a profile lock faster. The
+/// sample rate only has to leave room above `highFrequency`, and frames are
+/// kept to about half a period of the lowest string so a reading isn't held
+/// back waiting for the rest of the frame.
+typedef struct {
+    const char  *name;
+    float       lowFrequency;       // Hz. Lowest pitch the detector looks for
+    float       highFrequency;      // Hz. Highest pitch (or harmonic) it looks for
+    uint32_t    sampleRate;         // Hz, as seen by the detector (after TUNER_ADC_DECIMATION)
+    size_t      samplesPerFrame;    // At most TUNER_ADC_SAMPLES_PER_FRAME
+} InstrumentProfile;
+
+static constexpr InstrumentProfile instrument_profiles[instrumentCount] = {
+    // B0 - C7. Everything the tuner can do (and what it always did before
+    // there were profiles).
+    { "Chromatic",          30.87f,     2093.0f,    TUNER_ADC_SAMPLE_RATE,  TUNER_ADC_SAMPLES_PER_FRAME },
+    // C2 (drop C) - C7, 6.4 ms frames
+    { "Guitar",             65.41f,     2093.0f,    5000,                   32 },
+    // D1 (drop D) - G5. Half the rate for half the CPU, 12.8 ms frames
+    { "Bass (4-String)",    36.71f,     783.99f,    2500,                   32 },
+    // B0 - G5
+    { "Bass (5-String)",    30.87f,     783.99f,    2500,                   32 },
+    // B0 - C6, three octaves over the high C string. 2500 Hz leaves the same
+    // room above it that Guitar leaves above C7
+    { "Bass (6-String)",    30.87f,     1046.5f,    2500,                   32 },
+    // A1 - C7, 6.4 ms frames
+    { "Baritone Guitar",    55.00f,     2093.0f,    5000,                   32 },
+    // F3 (low G) - C7, 3.2 ms frames
+    { "Ukulele",            174.61f,    2093.0f,    5000,                   16 },
+    // B1 (cello C2) - C8. Violin harmonics go past what 5 kHz can hold,
+    // 6.4 ms frames
+    { "Violin Family",      61.74f,     4186.0f,    10000,                  64 },
+};
+
+/// @brief The longest frame any profile uses. Frame buffers are sized for
+/// `TUNER_ADC_SAMPLES_PER_FRAME`.
+constexpr size_t instrument_profiles_max_samples_per_frame() {
+    size_t maxSamples = 0;
+    for (const InstrumentProfile &profile : instrument_profiles) {
+        maxSamples = profile.samplesPerFrame > maxSamples ? profile.samplesPerFrame : maxSamples;
+    }
+    return maxSamples;
+}
+
+static_assert(instrument_profiles_max_samples_per_frame() <= TUNER_ADC_SAMPLES_PER_FRAME,
+    "An instrument profile uses longer frames than TUNER_ADC_SAMPLES_PER_FRAME");
+
+/// @brief Returns the profile for `instrument` (Chromatic if it's out of range).
+inline const InstrumentProfile &instrument_profile(TunerInstrument instrument) {
+    return instrument_profiles[instrument < instrumentCount ? instrument : instrumentChromatic];
+}
+
+#endif
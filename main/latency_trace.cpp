@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "latency_trace.h"
+
+#include "defines.h"
+
+#if TUNER_PROFILE_LATENCY
+
+#include "SPSCRing.hpp"
+
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include <atomic>
+#include <cstdio>
+#include <inttypes.h>
+
+#define LATENCY_TRACE_RING_SIZE     8
+
+static const char *TAG = "Latency";
+
+/// @brief Where the one reading being traced is.
+///
+/// `displayed` and `flushing` are only entered from code running with the
+/// LVGL lock held. The DMA done interrupt only reads `pending` and moves the
+/// state from `flushing` back to `idle`.
+typedef enum : uint8_t {
+    traceStateIdle = 0,
+    traceStateDisplayed,    // Handed to the tuner UI, waiting for LVGL to draw it
+    traceStateFlushing,     // The last area of its refresh is on its way to the panel
+} TraceState;
+
+static std::atomic<uint32_t> s_adc_isr_us_low(0);
+static std::atomic<uint8_t> s_state(traceStateIdle);
+static LatencyTraceRecord s_pending;
+static SPSCRing<LatencyTraceRecord, LATENCY_TRACE_RING_SIZE> s_finished; // DMA done interrupt -> GUI task
+static std::atomic<uint32_t> s_dropped(0);
+
+static LatencyHistogram s_histograms[latencyStageCount];
+static uint32_t s_since_report = 0;
+
+static const char *s_stage_names[latencyStageCount] = {
+    "adc read",
+    "detect",
+    "publish",
+    "gui wake",
+    "render",
+    "total",
+};
+
+void IRAM_ATTR latency_trace_adc_isr(void) {
+    s_adc_isr_us_low.store((uint32_t)esp_timer_get_time(), std::memory_order_relaxed);
+}
+
+int64_t latency_trace_last_adc_isr_us(int64_t nowUs) {
+    uint32_t elapsed = (uint32_t)nowUs - s_adc_isr_us_low.load(std::memory_order_relaxed);
+    return nowUs - elapsed;
+}
+
+void latency_trace_reading_displayed(const LatencyTraceRecord *record) {
+    if (s_state.load(std::memory_order_acquire) == traceStateFlushing) {
+        return; // Still waiting on the DMA for the previous reading
+    }
+    s_pending = *record;
+    s_state.store(traceStateDisplayed, std::memory_order_release);
+}
+
+void latency_trace_flush_started(bool isLast) {
+    if (isLast && s_state.load(std::memory_order_relaxed) == traceStateDisplayed) {
+        s_state.store(traceStateFlushing, std::memory_order_release);
+    }
+}
+
+void latency_trace_refresh_finished(void) {
+    uint8_t expected = traceStateDisplayed;
+    s_state.compare_exchange_strong(expected, traceStateIdle);
+}
+
+void IRAM_ATTR latency_trace_flush_done(void) {
+    if (s_state.load(std::memory_order_acquire) != traceStateFlushing) {
+        return;
+    }
+    LatencyTraceRecord record = s_pending;
+    record.glassUs = esp_timer_get_time();
+    if (!s_finished.push(record)) {
+        s_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    s_state.store(traceStateIdle, std::memory_order_release);
+}
+
+static void add_sample(LatencyHistogram *histogram, int64_t durationUs) {
+    if (durationUs < 0) {
+        durationUs = 0; // The stamps come from different cores
+    }
+    size_t bucket = durationUs < 2 ? 0 : 63 - __builtin_clzll((uint64_t)durationUs);
+    if (bucket >= LATENCY_TRACE_NUM_BUCKETS) {
+        bucket = LATENCY_TRACE_NUM_BUCKETS - 1;
+    }
+    histogram->buckets[bucket]++;
+    if (histogram->count == 0 || durationUs < histogram->minUs) {
+        histogram->minUs = durationUs;
+    }
+    if (durationUs > histogram->maxUs) {
+        histogram->maxUs = durationUs;
+    }
+    histogram->totalUs += durationUs;
+    histogram->count++;
+}
+
+void latency_trace_collect(void) {
+    LatencyTraceRecord record;
+    while (s_finished.pop(record)) {
+        add_sample(&s_histograms[latencyStageAdcRead], record.adcReadUs - record.adcIsrUs);
+        add_sample(&s_histograms[latencyStageDetect], record.detectUs - record.adcReadUs);
+        add_sample(&s_histograms[latencyStagePublish], record.publishUs - record.detectUs);
+        add_sample(&s_histograms[latencyStageGUIWake], record.displayUs - record.publishUs);
+        add_sample(&s_histograms[latencyStageRender], record.glassUs - record.displayUs);
+        add_sample(&s_histograms[latencyStageTotal], record.glassUs - record.adcIsrUs);
+
+        if (++s_since_report >= TUNER_PROFILE_LATENCY_REPORT_READINGS) {
+            s_since_report = 0;
+            latency_trace_log();
+        }
+    }
+}
+
+const LatencyHistogram *latency_trace_get_histogram(LatencyStage stage) {
+    return &s_histograms[stage];
+}
+
+const char *latency_trace_stage_name(LatencyStage stage) {
+    return s_stage_names[stage];
+}
+
+int64_t latency_histogram_percentile(const LatencyHistogram *histogram, uint32_t percent) {
+    if (histogram->count == 0) {
+        return 0;
+    }
+    uint32_t target = (histogram->count * percent + 99) / 100;
+    uint32_t seen = 0;
+    for (size_t i = 0; i < LATENCY_TRACE_NUM_BUCKETS - 1; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= target) {
+            return (int64_t)1 << (i + 1);
+        }
+    }
+    return histogram->maxUs;
+}
+
+void latency_trace_log(void) {
+    ESP_LOGI(TAG, "%" PRIu32 " readings traced, %" PRIu32 " dropped",
+        s_histograms[latencyStageTotal].count, s_dropped.load(std::memory_order_relaxed));
+    for (int stage = 0; stage < latencyStageCount; stage++) {
+        const LatencyHistogram *histogram = &s_histograms[stage];
+        if (histogram->count == 0) {
+            continue;
+        }
+        ESP_LOGI(TAG, "%-8s min %" PRId64 " us, avg %" PRId64 " us, max %" PRId64 " us, p50 <%" PRId64 " us, p99 <%" PRId64 " us",
+            s_stage_names[stage], histogram->minUs, histogram->totalUs / histogram->count, histogram->maxUs,
+            latency_histogram_percentile(histogram, 50), latency_histogram_percentile(histogram, 99));
+
+        // Only the buckets that have something in them, e.g. "<512:3 <1024:40"
+        char line[256];
+        size_t used = 0;
+        for (size_t i = 0; i < LATENCY_TRACE_NUM_BUCKETS && used < sizeof(line); i++) {
+            if (histogram->buckets[i] == 0) {
+                continue;
+            }
+            used += snprintf(line + used, sizeof(line) - used, " %s%" PRIu32 ":%" PRIu32,
+                i == LATENCY_TRACE_NUM_BUCKETS - 1 ? ">=" : "<",
+                i == LATENCY_TRACE_NUM_BUCKETS - 1 ? (uint32_t)1 << i : (uint32_t)1 << (i + 1),
+                histogram->buckets[i]);
+        }
+        ESP_LOGI(TAG, "%-8s%s", "", line);
+    }
+}
+
+void latency_trace_reset(void) {
+    for (int stage = 0; stage < latencyStageCount; stage++) {
+        s_histograms[stage] = {};
+    }
+    s_since_report = 0;
+    s_dropped.store(0, std::memory_order_relaxed);
+}
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_LATENCY_TRACE)
+#define TUNER_LATENCY_TRACE
+
+// Called from the C display driver so stick to C headers here.
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// End-to-end latency tracing (TUNER_PROFILE_LATENCY).
+//
+// A reading picks up timestamps as it moves through the tuner:
+//
+//   ADC interrupt -> frame read -> pitch detected -> published -> handed to
+//   the tuner UI -> last pixel of the frame that shows it sent to the panel
+//
+// Only readings the GUI actually shows are traced and only one is in flight
+// at a time. The display's DMA done interrupt finishes the record and pushes
+// it on a lock-free ring, which the GUI task drains into one histogram per
+// stage.
+//
+
+/// @brief Stages between two timestamps of a traced reading.
+typedef enum {
+    latencyStageAdcRead = 0,    // ADC interrupt -> frame read from the driver
+    latencyStageDetect,         // Frame read -> pitch detector returned the reading
+    latencyStagePublish,        // Detected -> published (filters, note debouncing)
+    latencyStageGUIWake,        // Published -> handed to the tuner UI
+    latencyStageRender,         // Handed to the tuner UI -> last pixel sent
+    latencyStageTotal,          // ADC interrupt -> last pixel sent
+    latencyStageCount,
+} LatencyStage;
+
+/// @brief Timestamps of one traced reading (esp_timer microseconds).
+typedef struct {
+    int64_t adcIsrUs;
+    int64_t adcReadUs;
+    int64_t detectUs;
+    int64_t publishUs;
+    int64_t displayUs;
+    int64_t glassUs;
+} LatencyTraceRecord;
+
+/// @brief Bucket `i` counts durations below `2^(i+1)` microseconds (and at
+/// least `2^i` for every bucket but the first). The last bucket also counts
+/// everything longer.
+#define LATENCY_TRACE_NUM_BUCKETS   21
+
+typedef struct {
+    uint32_t buckets[LATENCY_TRACE_NUM_BUCKETS];
+    uint32_t count;
+    int64_t minUs;
+    int64_t maxUs;
+    int64_t totalUs;
+} LatencyHistogram;
+
+/// @brief Remembers when the ADC last finished a conversion frame. Safe to
+/// call from the ADC interrupt.
+void latency_trace_adc_isr(void);
+
+/// @brief Returns the time of the last `latency_trace_adc_isr()` call.
+/// @param nowUs The current time. The interrupt only keeps the low 32 bits
+/// (so the store is atomic) and this is what they're extended against.
+int64_t latency_trace_last_adc_isr_us(int64_t nowUs);
+
+/// @brief Starts tracking a reading that was just handed to the tuner UI.
+/// Ignored if the previous reading is still on its way to the panel. Call
+/// with the LVGL lock held.
+void latency_trace_reading_displayed(const LatencyTraceRecord *record);
+
+/// @brief Called for every LVGL flush (LV_EVENT_FLUSH_START).
+/// @param isLast True for the last area of the refresh.
+void latency_trace_flush_started(bool isLast);
+
+/// @brief Called when LVGL finishes a refresh (LV_EVENT_REFR_READY). Stops
+/// tracking a reading whose refresh had nothing to draw.
+void latency_trace_refresh_finished(void);
+
+/// @brief Called from the display's DMA done interrupt.
+void latency_trace_flush_done(void);
+
+/// @brief Moves finished records into the histograms and logs them every
+/// `TUNER_PROFILE_LATENCY_REPORT_READINGS` readings. Call with the LVGL lock
+/// held.
+void latency_trace_collect(void);
+
+/// @brief Returns the histogram for a stage. Call with the LVGL lock held.
+const LatencyHistogram *latency_trace_get_histogram(LatencyStage stage);
+
+/// @brief Returns a short name for a stage ("adc read", "detect", ...).
+const char *latency_trace_stage_name(LatencyStage stage);
+
+/// @brief Returns the upper bound (in microseconds) of the bucket holding the
+/// given percentile, or 0 if the histogram is empty.
+int64_t latency_histogram_percentile(const LatencyHistogram *histogram, uint32_t percent);
+
+/// @brief Logs every histogram to the serial console.
+void latency_trace_log(void);
+
+/// @brief Clears the histograms. Call with the LVGL lock held.
+void latency_trace_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
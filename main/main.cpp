@@ -26,6 +26,7 @@
 #include "user_settings.h"
 #include "tuner_controller.h"
 #include "tuner_gui_task.h"
+#include "LatestValue.hpp"
 
 extern "C" { // because these files are C and not C++
     #include "I2C_Driver.h"
@@ -34,14 +35,19 @@ extern "C" { // because these files are C and not C++
 extern void gpio_task(void *pvParameter);
 extern void tuner_gui_task(void *pvParameter);
 extern void pitch_detector_task(void *pvParameter);
+extern void adc_ingest_task(void *pvParameter);
 
 TunerController *tunerController;
 UserSettings *userSettings;
 
 TaskHandle_t gpioTaskHandle;
+TaskHandle_t guiTaskHandle;
 TaskHandle_t detectorTaskHandle;
+TaskHandle_t adcIngestTaskHandle;
 
-QueueHandle_t frequencyQueue;
+/// The latest reading from the pitch detector. The detector task is the only
+/// writer and any task can read it.
+LatestValue<FrequencyInfo> latestFrequencyInfo;
 
 /// Queue to keep track of the bypass type state.
 QueueHandle_t bypassTypeQueue;
@@ -75,18 +81,27 @@ void tuner_state_will_change_cb(TunerState old_state, TunerState new_state) {
 }
 
 void tuner_state_did_change_cb(TunerState old_state, TunerState new_state) {
-    // Suspend and resume tasks as needed.
+    // Wake the GUI so it switches UIs right away.
+    if (guiTaskHandle != NULL) {
+        xTaskNotifyGive(guiTaskHandle);
+    }
+
+    // Suspend and resume tasks as needed. Both stages of the pitch detector
+    // pipeline are suspended and resumed together.
     switch (new_state) {
     case tunerStateSettings:
+        vTaskSuspend(adcIngestTaskHandle);
         vTaskSuspend(detectorTaskHandle);
         break;
     case tunerStateStandby:
         if (!userSettings->monitoringMode) {
+            vTaskSuspend(adcIngestTaskHandle);
             vTaskSuspend(detectorTaskHandle);
         }
         break;
     case tunerStateTuning:
         vTaskResume(detectorTaskHandle);
+        vTaskResume(adcIngestTaskHandle);
         break;
     case tunerStateBooting:
         break;
@@ -126,13 +141,6 @@ extern "C" void app_main() {
     
     // Create the info-passing queues before loading settings so they can be used
     
-    frequencyQueue = xQueueCreate(FREQUENCY_QUEUE_LENGTH, FREQUENCY_QUEUE_ITEM_SIZE);
-    if (frequencyQueue == NULL) {
-        ESP_LOGE(TAG, "Frequency Queue creation failed!");
-    } else {
-        ESP_LOGI(TAG, "Frequency Queue created successfully!");
-    }
-
     bypassTypeQueue = xQueueCreate(1, sizeof(TunerBypassType));
     if (bypassTypeQueue == NULL) {
         ESP_LOGE(TAG, "Bypass Type Queue creation failed!");
@@ -161,7 +169,7 @@ extern "C" void app_main() {
         "gpio",             // debug name of the task
         4096,               // stack depth (no idea what this should be)
         NULL,               // params to pass to the callback function
-        0,                  // ux priority - higher value is higher priority
+        5,                  // Above tuner_gui and LVGL (but below adc_ingest) so the relay switches soon after the foot switch is pressed. It sleeps otherwise.
         &gpioTaskHandle,    // handle to the created task - we don't need it
         0                   // Core ID - since we're not using Bluetooth/Wi-Fi, this can be 0 (the protocol CPU)
     );
@@ -174,11 +182,12 @@ extern "C" void app_main() {
         32768,              // stack depth (no idea what this should be)
         NULL,               // params to pass to the callback function
         1,                  // ux priority - higher value is higher priority
-        NULL,               // handle to the created task - we don't need it
+        &guiTaskHandle,     // handle to the created task - used to wake the GUI up
         0                   // Core ID - since we're not using Bluetooth/Wi-Fi, this can be 0 (the protocol CPU)
     );
 
-    // Start the Pitch Reading & Detection Task
+    // Start the Pitch Detection Task. This runs the DSP chain on frames
+    // handed over by the ADC ingest task and has core 1 to itself.
     xTaskCreatePinnedToCore(
         pitch_detector_task,    // callback function
         "pitch_detector",       // debug name of the task
@@ -188,4 +197,16 @@ extern "C" void app_main() {
         &detectorTaskHandle,    // handle to the created task - we don't need it
         1                       // Core ID
     );
+
+    // Start the ADC Ingest Task. This drains the ADC DMA pool on core 0 while
+    // the detector processes the previous frame on core 1.
+    xTaskCreatePinnedToCore(
+        adc_ingest_task,        // callback function
+        "adc_ingest",           // debug name of the task
+        4096,                   // stack depth
+        NULL,                   // params to pass to the callback function
+        10,                     // Higher than gpio and tuner_gui so the ADC pool never backs up
+        &adcIngestTaskHandle,   // handle to the created task
+        0                       // Core ID
+    );
 }
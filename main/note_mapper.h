@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_NOTE_MAPPER)
+#define TUNER_NOTE_MAPPER
+
+#include <cstddef>
+
+#include "defines.h"
+
+// The table covers MIDI notes 0 (C-1, 8.18 Hz) through 127 (G9, 12.5 kHz).
+#define NOTE_MAPPER_NUM_NOTES   128
+#define NOTE_MAPPER_A4_MIDI     69
+
+#define SEMITONE_RATIO          1.0594630943592952646   // 2^(1/12)
+#define QUARTER_TONE_RATIO      1.0293022366434920288   // 2^(1/24)
+#define CENTS_PER_NATURAL_LOG   1731.2340490667560888   // 1200 / ln(2)
+
+/// @brief Target frequencies and note boundaries for every MIDI note.
+///
+/// `lowerBounds[n]` is the frequency exactly half way (in cents) between note
+/// `n - 1` and note `n`, so a frequency belongs to the note `n` where
+/// `lowerBounds[n] <= f < lowerBounds[n + 1]`.
+typedef struct {
+    float targetFrequencies[NOTE_MAPPER_NUM_NOTES];
+    float lowerBounds[NOTE_MAPPER_NUM_NOTES + 1];
+} NoteTable;
+
+/// @brief Builds a `NoteTable` for the given A4 reference at compile time.
+///
+/// This walks out from A4 one semitone at a time in double precision so it
+/// doesn't need a constexpr `pow()`.
+constexpr NoteTable make_note_table(double a4Freq) {
+    NoteTable table = {};
+    double frequencies[NOTE_MAPPER_NUM_NOTES] = {};
+    frequencies[NOTE_MAPPER_A4_MIDI] = a4Freq;
+    for (int n = NOTE_MAPPER_A4_MIDI + 1; n < NOTE_MAPPER_NUM_NOTES; n++) {
+        frequencies[n] = frequencies[n - 1] * SEMITONE_RATIO;
+    }
+    for (int n = NOTE_MAPPER_A4_MIDI - 1; n >= 0; n--) {
+        frequencies[n] = frequencies[n + 1] / SEMITONE_RATIO;
+    }
+    for (int n = 0; n < NOTE_MAPPER_NUM_NOTES; n++) {
+        table.targetFrequencies[n] = (float)frequencies[n];
+        table.lowerBounds[n] = (float)(frequencies[n] / QUARTER_TONE_RATIO);
+    }
+    table.lowerBounds[NOTE_MAPPER_NUM_NOTES] = (float)(frequencies[NOTE_MAPPER_NUM_NOTES - 1] * QUARTER_TONE_RATIO);
+    return table;
+}
+
+/// @brief Fast cents between two frequencies that are within about a quarter
+/// tone of each other.
+///
+/// Uses ln(r) = 2 * atanh((r - 1) / (r + 1)). For |cents| <= 50 the series
+/// argument is below 0.015 so two terms are accurate to better than 0.0001
+/// cents, all in single precision.
+inline float cents_between(float frequency, float reference) {
+    float z = (frequency - reference) / (frequency + reference);
+    float z2 = z * z;
+    return (float)(2 * CENTS_PER_NATURAL_LOG) * z * (1.0f + z2 * (1.0f / 3.0f));
+}
+
+/// @brief Finds the nearest note for a frequency with a binary search of the
+/// note boundaries (7 float compares, no libm calls).
+/// @return Returns the MIDI note number or -1 if the frequency is out of range.
+inline int note_mapper_find_note(const NoteTable &table, float frequency) {
+    if (!(frequency >= table.lowerBounds[0]) || frequency >= table.lowerBounds[NOTE_MAPPER_NUM_NOTES]) {
+        return -1; // Also catches NaN
+    }
+    int low = 0;
+    int high = NOTE_MAPPER_NUM_NOTES; // lowerBounds[low] <= frequency < lowerBounds[high]
+    while (high - low > 1) {
+        int mid = (low + high) / 2;
+        if (frequency >= table.lowerBounds[mid]) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/// @brief Fills in the target note, octave, target frequency and cents for a
+/// detected frequency.
+/// @return Returns false if the frequency is outside of the table.
+inline bool note_mapper_map(const NoteTable &table, float frequency, FrequencyInfo *freqInfo) {
+    int midiNote = note_mapper_find_note(table, frequency);
+    if (midiNote < 0) {
+        return false;
+    }
+    float target = table.targetFrequencies[midiNote];
+    freqInfo->frequency = frequency;
+    freqInfo->targetFrequency = target;
+    freqInfo->cents = cents_between(frequency, target);
+    freqInfo->targetNote = (TunerNoteName)(midiNote % 12);
+    freqInfo->targetOctave = midiNote / 12 - 1; // MIDI note 0 is C-1
+    return true;
+}
+
+#endif
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "pitch_detector_chain.h"
+
+#include <array>
+
+#include <q/support/decibel.hpp>
+#include <q/support/literals.hpp>
+
+#include "adc_frame_kernel.h"
+#include "note_mapper.h"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+static const FrequencyInfo noFreq = {
+    .frequency = -1,
+    .cents = -1,
+    .targetFrequency = -1,
+    .targetNote = NOTE_NONE,
+    .targetOctave = -1,
+    .timestampUs = 0,
+    .adcIsrUs = 0,
+    .adcReadUs = 0,
+    .detectUs = 0,
+};
+
+static constexpr NoteTable noteTable = make_note_table(A4_FREQ);
+
+bool get_frequency_info(float input_freq, FrequencyInfo *freqInfo) {
+    return note_mapper_map(noteTable, input_freq, freqInfo);
+}
+
+/// @brief The target frequencies of a preset's strings.
+static std::array<float, TUNING_PRESET_MAX_STRINGS> preset_frequencies(const TuningPreset &preset) {
+    std::array<float, TUNING_PRESET_MAX_STRINGS> frequencies = {};
+    for (size_t k = 0; k < preset.numStrings; k++) {
+        frequencies[k] = noteTable.targetFrequencies[preset.midiNotes[k]];
+    }
+    return frequencies;
+}
+
+PitchDetectorChain::PitchDetectorChain(const InstrumentProfile &profile, const TuningPreset &preset)
+    : sampleRate(profile.sampleRate),
+      gate(TUNER_GATE_CONFIG),
+#if TUNER_STREAMING_NORMALIZER
+      normalizer(profile.sampleRate, TUNER_DC_BLOCKER_HZ, TUNER_AGC_RELEASE_MS / 1000.0f, TUNER_AGC_MIN_LEVEL),
+#endif
+      pd(q::frequency(profile.lowFrequency), q::frequency(profile.highFrequency), profile.sampleRate, -40_dB),
+      sigCond(q::signal_conditioner::config{}, q::frequency(profile.lowFrequency), q::frequency(profile.highFrequency), profile.sampleRate),
+#if TUNER_MEDIAN_PREFILTER_WINDOW > 0
+      medianPrefilter(TUNER_MEDIAN_PREFILTER_WINDOW, true),
+#endif
+      oneEUFilter(EU_FILTER_ESTIMATED_FREQ, EU_FILTER_MIN_CUTOFF, EU_FILTER_BETA, EU_FILTER_DERIVATIVE_CUTOFF),
+      oneEUFilter2(EU_FILTER_ESTIMATED_FREQ, EU_FILTER_MIN_CUTOFF_2, EU_FILTER_BETA_2, EU_FILTER_DERIVATIVE_CUTOFF_2),
+      preset(preset),
+      tuningBank(TUNER_PRESET_CONFIG, preset_frequencies(preset).data(), preset.numStrings, profile.sampleRate),
+      lastSeenNote(NOTE_NONE),
+      sameNoteSeenCount(0),
+      detectClock(NULL) {
+}
+
+void PitchDetectorChain::reset() {
+    oneEUFilter.reset(); // Reset the 1EU filter so the next frequency it detects will be as fast as possible
+    oneEUFilter2.reset();
+#if TUNER_MEDIAN_PREFILTER_WINDOW > 0
+    medianPrefilter.reset();
+#endif
+    pd.reset();
+    tuningBank.reset();
+
+    lastSeenNote = NOTE_NONE;
+    sameNoteSeenCount = 0;
+}
+
+#if TUNER_STREAMING_NORMALIZER
+void PitchDetectorChain::processFrame(const float *samples, size_t numSamples, int64_t frameTimeUs, pitch_chain_publish_cb_t publish, void *context) {
+#else
+void PitchDetectorChain::processFrame(const float *samples, size_t numSamples, float minVal, float maxVal, int64_t frameTimeUs, pitch_chain_publish_cb_t publish, void *context) {
+#endif
+    // Bail out while the gate is closed. The detector and filters only start
+    // over when it closes so a note that is dying away doesn't lose its lock
+    // (and its settled filters) every time one frame is a little quieter.
+    if (!gate.process(samples, numSamples, numSamples / sampleRate)) {
+        publish(&noFreq, context); // Indicate to the UI that there's no frequency available
+        if (gate.didJustClose()) {
+            reset();
+        }
+        return;
+    }
+
+    // Normalize the values between -1.0 and +1.0 while feeding them to qlib
+    // so the frame is only walked once.
+#if TUNER_STREAMING_NORMALIZER
+    if (gate.didJustOpen()) {
+        // Pick up from the bias and level the gate measured (RMS -> peak)
+        // instead of whatever was left from the last note.
+        normalizer.reset(gate.getDC(), gate.getEnvelope() * (float)M_SQRT2);
+    }
+#else
+    float scale, offset;
+    adc_frame_normalizer(minVal, maxVal, &scale, &offset);
+#endif
+    bool usePreset = preset.numStrings > 0;
+    float microsPerSample = 1000000.0f / sampleRate;
+    for (size_t i = 0; i < numSamples; i++) {
+#if TUNER_STREAMING_NORMALIZER
+        float s = normalizer(samples[i]);
+#else
+        float s = samples[i] * scale + offset;
+#endif
+
+        if (usePreset) {
+            tuningBank(s);
+            continue;
+        }
+
+        // s = medianMovingFilter.addValue(s);
+
+        // I've got the signal conditioning commented out right now
+        // because it actually is making the frequency readings
+        // NOT work. They probably just need to be tweaked a little.
+
+        // Signal Conditioner
+        s = sigCond(s);
+        // s = s * 2.5;
+
+        // // Bandpass filter
+        // s = lp(s);
+        // s -= lp2(s);
+
+        // // Envelope
+        // auto e = env(std::abs(static_cast<int>(s)));
+        // auto e_db = q::lin_to_db(e);
+
+        // if (e > threshold) {
+        //     // Compressor + make-up gain + hard clip
+        //     auto gain = cycfi::q::lin_float(comp(e_db)) * makeup_gain;
+        //     s = clip(s * gain);
+        //     threshold = release_threshold;
+        // } else {
+        //     s = 0.0f;
+        //     threshold = onset_threshold;
+        // }
+
+        // Pitch Detect
+        // Send in each value into the pitch detector
+        if (pd(s) == true) { // calculated a frequency
+#if TUNER_PROFILE_LATENCY
+            int64_t detectUs = detectClock != NULL ? detectClock() : 0;
+#endif
+            auto f = pd.get_frequency();
+
+#if TUNER_MEDIAN_PREFILTER_WINDOW > 0
+            f = medianPrefilter.addValue(f);
+#endif
+
+            [[maybe_unused]] bool use1EUFilterFirst = true; // TODO: This may never be needed. Need to test which "feels" better for tuning
+            // if (use1EUFilterFirst) {
+
+            // Simple Exponential Smoothing
+            // f = smoother.smooth(f);
+
+            // 1EU Filtering
+            TimeStamp timestamp = frameTimeUs + (TimeStamp)(i * microsPerSample);
+            oneEUFilter.setFrequency(f);
+            f = oneEUFilter.filter(f, timestamp);
+
+            // f = movingAverage.addValue(f);
+            // f = smoother.smooth(f);
+
+            oneEUFilter2.setFrequency(f);
+            f = oneEUFilter2.filter(f, timestamp);
+
+            // } else {
+            //     // Simple Expoential Smoothing
+            //     f = smoother.smooth(f);
+
+            //     // 1EU Filtering
+            //     f = (float)oneEUFilter.filter((double)f, (TimeStamp)time_seconds);
+            // }
+
+            // f = f / WEIRD_ESP32_WROOM_32_FREQ_FIX_FACTOR; // Use the weird factor only on ESP32-WROOM-32 (which the CYD is)
+
+            FrequencyInfo freqInfo;
+            if (f != -1.0f && get_frequency_info(f, &freqInfo)) {
+                // Only show frequency info if we've seen the same target note
+                // more than once in a row. Doing this seems to help prevent
+                // sporadic notes from appearing right as you pluck a string.
+                if (lastSeenNote == freqInfo.targetNote) {
+                    sameNoteSeenCount++;
+                } else {
+                    sameNoteSeenCount = 0;
+                }
+                lastSeenNote = freqInfo.targetNote;
+
+                if (sameNoteSeenCount > 1) {
+#if TUNER_PROFILE_LATENCY
+                    freqInfo.detectUs = detectUs;
+#endif
+                    publish(&freqInfo, context);
+                }
+            }
+        }
+    }
+
+    if (usePreset) {
+        publishPresetReading(numSamples, publish, context);
+    }
+}
+
+void PitchDetectorChain::publishPresetReading(size_t numSamples, pitch_chain_publish_cb_t publish, void *context) {
+    // The bank does its own debouncing and its readings are already smooth,
+    // so they skip the median and 1EU filters.
+    TuningBankReading reading;
+    if (!tuningBank.endFrame(numSamples, &reading)) {
+        publish(&noFreq, context); // No string picked this frame
+        return;
+    }
+#if TUNER_PROFILE_LATENCY
+    int64_t detectUs = detectClock != NULL ? detectClock() : 0;
+#endif
+    int midiNote = preset.midiNotes[reading.string];
+    FrequencyInfo freqInfo = {
+        .frequency = reading.frequency,
+        .cents = reading.cents,
+        .targetFrequency = noteTable.targetFrequencies[midiNote],
+        .targetNote = (TunerNoteName)(midiNote % 12),
+        .targetOctave = midiNote / 12 - 1, // MIDI note 0 is C-1
+        .timestampUs = 0, // Stamped when it's published
+        .adcIsrUs = 0, // The ADC stamps are copied from the frame when it's published
+        .adcReadUs = 0,
+        .detectUs = 0,
+    };
+#if TUNER_PROFILE_LATENCY
+    freqInfo.detectUs = detectUs;
+#endif
+    publish(&freqInfo, context);
+}
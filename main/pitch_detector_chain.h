@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_PITCH_DETECTOR_CHAIN)
+#define TUNER_PITCH_DETECTOR_CHAIN
+
+#include <cstddef>
+#include <cstdint>
+
+#include "defines.h"
+#include "instrument_profiles.h"
+#include "tuning_presets.h"
+
+//
+// Q DSP Library for Pitch Detection
+//
+#include <q/pitch/pitch_detector.hpp>
+#include <q/fx/signal_conditioner.hpp>
+
+//
+// Smoothing Filters
+//
+#include "NoiseGate.hpp"
+#include "OneEuroFilter.hpp"
+#if TUNER_STREAMING_NORMALIZER
+#include "StreamingNormalizer.hpp"
+#endif
+#if TUNER_MEDIAN_PREFILTER_WINDOW > 0
+#include "MedianFilter.hpp"
+#endif
+#include "TuningBank.hpp"
+
+/// @brief Called whenever the chain has a new reading to publish. A reading
+/// with a negative frequency means that no pitch is being detected.
+typedef void (*pitch_chain_publish_cb_t)(const FrequencyInfo *freqInfo, void *context);
+
+/// @brief Returns the current time in microseconds.
+typedef int64_t (*pitch_chain_clock_cb_t)();
+
+/// @brief Computes the closest note and cent deviation for a frequency.
+/// @return Returns false if the frequency is not valid.
+bool get_frequency_info(float input_freq, FrequencyInfo *freqInfo);
+
+/// @brief The DSP side of the pitch detector.
+///
+/// This is everything that happens to a frame of ADC samples after it has
+/// been unpacked: the noise gate (`TUNER_GATE_*`), normalization
+/// (`TUNER_STREAMING_NORMALIZER`), the
+/// qlib signal conditioner and pitch detector, the optional median prefilter
+/// (`TUNER_MEDIAN_PREFILTER_WINDOW`), both 1EU filters and the note
+/// debouncing. It has no ESP-IDF dependencies so the exact same chain runs in
+/// `pitch_detector_task` and in the host tools (see host/).
+///
+/// The detector range and sample rate come from an `InstrumentProfile`. With
+/// a `TuningPreset` the qlib detector and everything after it are skipped and
+/// a `TuningBank` on the preset's strings reports the string and its cents
+/// once per frame instead. To switch instruments or presets, build a new
+/// chain.
+class PitchDetectorChain {
+
+    float                           sampleRate;
+    NoiseGate                       gate;
+#if TUNER_STREAMING_NORMALIZER
+    StreamingNormalizer             normalizer;
+#endif
+    cycfi::q::pitch_detector        pd;
+    cycfi::q::signal_conditioner    sigCond;
+
+#if TUNER_MEDIAN_PREFILTER_WINDOW > 0
+    MedianFilter<>          medianPrefilter;
+#endif
+    OneEuroFilter<float>    oneEUFilter;
+    OneEuroFilter<float>    oneEUFilter2;
+
+    const TuningPreset                      &preset;
+    TuningBank<TUNING_PRESET_MAX_STRINGS>   tuningBank;
+
+    TunerNoteName   lastSeenNote;
+    int             sameNoteSeenCount;
+
+    pitch_chain_clock_cb_t  detectClock;
+
+public:
+
+    /// @param profile The detector range and sample rate to use.
+    /// @param preset The strings to listen for, or Off for the chromatic
+    /// detector.
+    PitchDetectorChain(const InstrumentProfile &profile, const TuningPreset &preset = tuning_presets[tuningPresetOff]);
+
+    /// @brief Runs one frame of unpacked ADC samples through the chain.
+    /// @param samples Raw ADC samples (0 - 4095).
+    /// @param numSamples Number of samples in the frame.
+    /// @param minVal The smallest sample in the frame. Only used to
+    /// normalize the frame when TUNER_STREAMING_NORMALIZER is off.
+    /// @param maxVal The largest sample in the frame.
+    /// @param frameTimeUs Time of the first sample in microseconds. Sample
+    /// times used by the 1EU filters are derived from this and the sample rate.
+    /// @param publish Called for every reading the chain decides to publish.
+    /// @param context Passed through to `publish`.
+#if TUNER_STREAMING_NORMALIZER
+    void processFrame(const float *samples, size_t numSamples, int64_t frameTimeUs, pitch_chain_publish_cb_t publish, void *context);
+#else
+    void processFrame(const float *samples, size_t numSamples, float minVal, float maxVal, int64_t frameTimeUs, pitch_chain_publish_cb_t publish, void *context);
+#endif
+
+    /// @brief Sets the clock used to stamp `FrequencyInfo::detectUs` the moment
+    /// the pitch detector returns a reading. Only used when
+    /// `TUNER_PROFILE_LATENCY` is on.
+    void setDetectClock(pitch_chain_clock_cb_t clock) { detectClock = clock; }
+
+    /// @brief Forgets all history so the next note is detected as quickly as possible.
+    void reset();
+
+private:
+    /// @brief Publishes the string the tuning bank picked for the frame (if any).
+    void publishPresetReading(size_t numSamples, pitch_chain_publish_cb_t publish, void *context);
+};
+
+#endif
@@ -29,81 +29,93 @@
 // #include "esp_adc/adc_cali_scheme.h"
 #include "esp_adc/adc_filter.h"
 #include "esp_timer.h"
-
-//
-// Q DSP Library for Pitch Detection
-//
-#include <q/pitch/pitch_detector.hpp>
-#include <q/fx/dynamic.hpp>
-#include <q/fx/clip.hpp>
-#include <q/fx/signal_conditioner.hpp>
-#include <q/support/decibel.hpp>
-#include <q/support/duration.hpp>
-#include <q/support/literals.hpp>
-#include <q/support/pitch_names.hpp>
-#include <q/support/pitch.hpp>
-
-//
-// Smoothing Filters
-//
-// #include "exponential_smoother.hpp"
-#include "OneEuroFilter.h"
-// #include "MovingAverage.hpp"
-// #include "MedianFilter.hpp"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+
+#include <algorithm>
+
+#include "pitch_detector_chain.h"
+#include "instrument_profiles.h"
+#include "tuning_presets.h"
+#include "LatestValue.hpp"
+#include "SPSCRing.hpp"
+#include "StageProfiler.hpp"
+#include "adc_frame_kernel.h"
+#include "latency_trace.h"
+#if TUNER_ADC_DECIMATION > 1
+#include "Decimator.hpp"
+#endif
 
 static const char *TAG = "PitchDetector";
 
-namespace q = cycfi::q;
-using namespace q::literals;
-using std::fixed;
-
-using namespace cycfi::q::pitch_names;
-using frequency = cycfi::q::frequency;
-using pitch = cycfi::q::pitch;
-CONSTEXPR frequency low_fs = cycfi::q::pitch_names::B[0]; // Lowest string on a 5-string bass
-CONSTEXPR frequency high_fs = cycfi::q::pitch_names::C[7]; // Setting this higher helps to catch the high harmonics
-
 // static adc_channel_t channel[1] = {ADC_CHANNEL_7}; // ESP32-WROOM-32 CYD - GPIO 35 (ADC1_CH7)
 // static adc_channel_t channel[1] = {ADC_CHANNEL_3}; // ESP32-S3 EBD4 - GPIO 4 (ADC1_CH3)
 static adc_channel_t channel[1] = {TUNER_ADC_CHANNEL}; // ESP32-S3 EBD2 - GPIO 10 (ADC1_CH9)
 
 // adc_cali_handle_t cali_handle = NULL;
 
-// ExponentialSmoother smoother(EXP_SMOOTHING);
-OneEuroFilter oneEUFilter(
-    EU_FILTER_ESTIMATED_FREQ,
-    EU_FILTER_MIN_CUTOFF,
-    EU_FILTER_BETA,
-    EU_FILTER_DERIVATIVE_CUTOFF);
-OneEuroFilter oneEUFilter2(
-    EU_FILTER_ESTIMATED_FREQ,
-    EU_FILTER_MIN_CUTOFF_2,
-    EU_FILTER_BETA_2,
-    EU_FILTER_DERIVATIVE_CUTOFF_2);
-// MovingAverage movingAverage(5);
-// MedianFilter medianMovingFilter(3, true);
-// MedianFilter medianFilter(5, false);
-
 extern UserSettings *userSettings;
-extern QueueHandle_t frequencyQueue;
+extern LatestValue<FrequencyInfo> latestFrequencyInfo;
+extern TaskHandle_t guiTaskHandle;
+
+/// @brief A frame of unpacked ADC samples.
+///
+/// Frames live in a fixed pool and are handed between the ingest stage and the
+/// detection stage by pointer so the samples are never reallocated or copied.
+typedef struct {
+    alignas(ADC_FRAME_KERNEL_ALIGNMENT) float samples[TUNER_ADC_SAMPLES_PER_FRAME];
+    size_t numSamples;
+#if !TUNER_STREAMING_NORMALIZER
+    float minVal;
+    float maxVal;
+#endif
+    int64_t timestampUs; // Time of the first sample
+    const InstrumentProfile *profile; // How the ADC was set up when the frame was read
+#if TUNER_PROFILE_LATENCY
+    int64_t adcIsrUs;    // Last conversion done interrupt before the frame was read
+    int64_t adcReadUs;   // When the frame was read from the driver
+#endif
+} AdcFrame;
+
+static AdcFrame s_frame_pool[TUNER_ADC_FRAME_POOL_SIZE];
+static SPSCRing<AdcFrame *, TUNER_ADC_FRAME_POOL_SIZE> s_free_frames;    // detection stage -> ingest stage
+static SPSCRing<AdcFrame *, TUNER_ADC_FRAME_POOL_SIZE> s_ready_frames;   // ingest stage -> detection stage
+
+static uint32_t s_dropped_frames = 0; // Frames discarded because the detection stage fell behind
+
+static TaskHandle_t s_ingest_task_handle = NULL;
+static TaskHandle_t s_detector_task_handle = NULL;
+
+#if TUNER_ADC_DECIMATION > 1
+static Decimator<TUNER_ADC_DECIMATION, TUNER_ADC_SAMPLES_PER_FRAME> s_decimator;
+#endif
 
-static TaskHandle_t s_task_handle;
 static bool IRAM_ATTR s_conv_done_cb(adc_continuous_handle_t handle, const adc_continuous_evt_data_t *edata, void *user_data)
 {
     BaseType_t mustYield = pdFALSE;
+#if TUNER_PROFILE_LATENCY
+    latency_trace_adc_isr();
+#endif
     //Notify that ADC continuous driver has done enough number of conversions
-    vTaskNotifyGiveFromISR(s_task_handle, &mustYield);
+    vTaskNotifyGiveFromISR(s_ingest_task_handle, &mustYield);
 
     return (mustYield == pdTRUE);
 }
 
-static void continuous_adc_init(adc_channel_t *channel, uint8_t channel_count, adc_continuous_handle_t *out_handle, adc_iir_filter_handle_t *out_filter_handle)
+/// @brief Size in bytes of one ADC conversion frame for `profile`.
+static uint32_t adc_frame_size(const InstrumentProfile &profile) {
+    return SOC_ADC_DIGI_DATA_BYTES_PER_CONV * profile.samplesPerFrame * TUNER_ADC_DECIMATION;
+}
+
+static void continuous_adc_init(adc_channel_t *channel, uint8_t channel_count, const InstrumentProfile &profile, adc_continuous_handle_t *out_handle, adc_iir_filter_handle_t *out_filter_handle)
 {
     adc_continuous_handle_t handle = NULL;
 
+    ESP_LOGI(TAG, "ADC set up for %s: %" PRIu32 " Hz, %d samples per frame", profile.name, profile.sampleRate, (int)profile.samplesPerFrame);
+
     adc_continuous_handle_cfg_t adc_config = {
         .max_store_buf_size = TUNER_ADC_BUFFER_POOL_SIZE,
-        .conv_frame_size = TUNER_ADC_FRAME_SIZE,
+        .conv_frame_size = adc_frame_size(profile),
         .flags = {
             // .flush_pool = false,
             .flush_pool = true,
@@ -131,7 +143,7 @@ static void continuous_adc_init(adc_channel_t *channel, uint8_t channel_count, a
     adc_continuous_config_t dig_cfg = {
         .pattern_num = channel_count,
         .adc_pattern = adc_pattern,
-        .sample_freq_hz = TUNER_ADC_SAMPLE_RATE,
+        .sample_freq_hz = profile.sampleRate * TUNER_ADC_DECIMATION,
         .conv_mode = TUNER_ADC_CONV_MODE,
         .format = TUNER_ADC_OUTPUT_TYPE,
     };
@@ -157,78 +169,194 @@ static void continuous_adc_init(adc_channel_t *channel, uint8_t channel_count, a
     *out_handle = handle;
 }
 
-/// @brief Function to compute the closest note and cent deviation
-inline esp_err_t get_frequency_info(float input_freq, FrequencyInfo *freqInfo) { //float *target_frequency, TunerNoteName *target_note, int *target_octave, float *cents_off) {
-    if (input_freq <= 0) {
-        return ESP_FAIL;
+/// @brief Stops the ADC and frees everything `continuous_adc_init()` set up.
+static void continuous_adc_deinit(adc_continuous_handle_t handle, adc_iir_filter_handle_t filter_handle) {
+    ESP_ERROR_CHECK(adc_continuous_stop(handle));
+    ESP_ERROR_CHECK(adc_del_continuous_iir_filter(filter_handle));
+    ESP_ERROR_CHECK(adc_continuous_deinit(handle));
+}
+
+#if TUNER_PROFILE_PITCH_DETECTOR
+static void log_stage_profile(StageProfiler &profiler, const char *units = "us") {
+    ESP_LOGI(TAG, "%s: min %" PRId64 " %s, avg %" PRId64 " %s, max %" PRId64 " %s (%" PRIu32 " frames, %" PRIu32 " dropped)",
+        profiler.getName(), profiler.getMin(), units, profiler.getAverage(), units, profiler.getMax(), units, profiler.getCount(), s_dropped_frames);
+    profiler.reset();
+}
+
+#if TUNER_ADC_DECIMATION > 1
+static StageProfiler s_scalar_kernel_profiler("decimate scalar");
+#if ADC_FRAME_KERNEL_HAS_PIE
+static StageProfiler s_pie_kernel_profiler("decimate PIE");
+#endif
+
+/// @brief Runs a second, scalar-only decimator on the same conversions as
+/// `s_decimator`, checks that both produce the same samples bit-for-bit and
+/// records how many CPU cycles each one takes. This is the CPU budget of the
+/// decimation factor.
+static size_t decimate_and_verify(const uint32_t *words, size_t numWords, float *out, float *outMin, float *outMax) {
+    static Decimator<TUNER_ADC_DECIMATION, TUNER_ADC_SAMPLES_PER_FRAME> s_scalar_decimator(decimator_dot_scalar);
+    static float reference[TUNER_ADC_SAMPLES_PER_FRAME];
+    float refMin, refMax;
+    uint32_t start = esp_cpu_get_cycle_count();
+    size_t numReference = s_scalar_decimator.process(words, numWords, reference, &refMin, &refMax);
+    s_scalar_kernel_profiler.addSample(esp_cpu_get_cycle_count() - start);
+
+    start = esp_cpu_get_cycle_count();
+    size_t numSamples = s_decimator.process(words, numWords, out, outMin, outMax);
+#if ADC_FRAME_KERNEL_HAS_PIE
+    s_pie_kernel_profiler.addSample(esp_cpu_get_cycle_count() - start);
+#endif
+
+    if (numSamples != numReference || memcmp(reference, out, numSamples * sizeof(float)) != 0) {
+        ESP_LOGE(TAG, "Decimator does not match the scalar decimator");
     }
-    
-    // Calculate the number of semitones away from A4
-    float semitone_offset = 12 * log2(input_freq / A4_FREQ);
-    int closest_semitone = (int)round(semitone_offset);
-    
-    // Compute the closest note index (modulo 12 for chromatic scale)
-    int note_index = (closest_semitone + 9) % 12;
-    if (note_index < 0) {
-        note_index += 12; // Ensure positive index
+
+    if (s_scalar_kernel_profiler.getCount() >= TUNER_PROFILE_REPORT_FRAMES) {
+        log_stage_profile(s_scalar_kernel_profiler, "cycles");
+#if ADC_FRAME_KERNEL_HAS_PIE
+        log_stage_profile(s_pie_kernel_profiler, "cycles");
+#endif
     }
-    int octave = 4 + ((closest_semitone + 9) / 12); // Determine octave number
-    
-    // Compute the frequency of the closest note
-    float closest_note_freq = A4_FREQ * pow(2.0, closest_semitone / 12.0);
-    freqInfo->frequency = input_freq;
-    freqInfo->targetFrequency = closest_note_freq;
-    
-    // Calculate the cent deviation
-    // *cents_off = (int)round(1200 * log2(input_freq / closest_note_freq));
-    freqInfo->cents = 1200 * log2(input_freq / closest_note_freq);
-
-    freqInfo->targetNote = (TunerNoteName)note_index;
-
-    freqInfo->targetOctave = octave;
-    return ESP_OK;
+    return numSamples;
 }
+#else
+static StageProfiler s_scalar_kernel_profiler("unpack scalar");
+#if ADC_FRAME_KERNEL_HAS_PIE
+static StageProfiler s_pie_kernel_profiler("unpack PIE");
+#endif
+
+/// @brief Runs every unpack path on the same ADC frame, checks that they agree
+/// bit-for-bit and records how many CPU cycles each one takes.
+static void verify_adc_frame_kernel(const uint32_t *words, size_t numWords, float *out) {
+    static float reference[TUNER_ADC_SAMPLES_PER_FRAME];
+    float refMin, refMax;
+    uint32_t start = esp_cpu_get_cycle_count();
+    adc_frame_unpack_scalar(words, numWords, reference, &refMin, &refMax);
+    s_scalar_kernel_profiler.addSample(esp_cpu_get_cycle_count() - start);
+
+#if ADC_FRAME_KERNEL_HAS_PIE
+    float pieMin, pieMax;
+    start = esp_cpu_get_cycle_count();
+    adc_frame_unpack_pie(words, numWords, out, &pieMin, &pieMax);
+    s_pie_kernel_profiler.addSample(esp_cpu_get_cycle_count() - start);
+
+    if (memcmp(reference, out, numWords * sizeof(float)) != 0 || refMin != pieMin || refMax != pieMax) {
+        ESP_LOGE(TAG, "PIE unpack kernel does not match the scalar kernel");
+    }
+#endif
 
-void pitch_detector_task(void *pvParameter) {
-    // Prep ADC
-    esp_err_t ret;
+    if (s_scalar_kernel_profiler.getCount() >= TUNER_PROFILE_REPORT_FRAMES) {
+        log_stage_profile(s_scalar_kernel_profiler, "cycles");
+#if ADC_FRAME_KERNEL_HAS_PIE
+        log_stage_profile(s_pie_kernel_profiler, "cycles");
+#endif
+    }
+}
+#endif // TUNER_ADC_DECIMATION > 1
+#endif
+
+/// @brief Reads one conversion frame from the ADC and unpacks it into a pooled
+/// frame, tracking the min and max values in the same pass. With
+/// `TUNER_ADC_DECIMATION` the conversions are decimated into the frame
+/// instead.
+///
+/// On success the frame is handed to the detection stage on `s_ready_frames`.
+/// If the detection stage is holding every frame, the conversion frame is
+/// still drained from the ADC pool (so the driver never overflows) but its
+/// samples are discarded.
+///
+/// @param profile The profile the ADC is currently set up for.
+static esp_err_t ingest_adc_frame(adc_continuous_handle_t handle, uint8_t *adc_buffer, const InstrumentProfile &profile) {
     uint32_t num_of_bytes_read = 0;
-    uint8_t *adc_buffer = (uint8_t *)malloc(TUNER_ADC_FRAME_SIZE);
+    esp_err_t ret = adc_continuous_read(handle, adc_buffer, adc_frame_size(profile), &num_of_bytes_read, 0);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    // ESP_LOGI(TAG, "ret is %x, num_of_bytes_read is %"PRIu32" bytes", ret, num_of_bytes_read);
+
+    AdcFrame *frame;
+    if (!s_free_frames.pop(frame)) {
+        s_dropped_frames++;
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Get the data out of the ADC Conversion Result.
+    // ESP_LOGI(TAG, "Bytes read: %ld", num_of_bytes_read);
+
+    // int calibratedValue;
+    // esp_err_t r = adc_cali_raw_to_voltage(cali_handle, value, &calibratedValue);
+    // if (r == ESP_OK) {
+    //     value = calibratedValue;
+    // }
+
+    // Unpack, convert and find the min/max in one pass.
+    size_t numConversions = std::min((size_t)(num_of_bytes_read / SOC_ADC_DIGI_RESULT_BYTES), profile.samplesPerFrame * TUNER_ADC_DECIMATION);
+    float minVal, maxVal;
+#if TUNER_ADC_DECIMATION > 1
+#if TUNER_PROFILE_PITCH_DETECTOR
+    size_t valuesStored = decimate_and_verify((const uint32_t *)adc_buffer, numConversions, frame->samples, &minVal, &maxVal);
+#else
+    size_t valuesStored = s_decimator.process((const uint32_t *)adc_buffer, numConversions, frame->samples, &minVal, &maxVal);
+#endif
+#else
+    size_t valuesStored = numConversions;
+#if TUNER_PROFILE_PITCH_DETECTOR
+    verify_adc_frame_kernel((const uint32_t *)adc_buffer, valuesStored, frame->samples);
+#endif
+    adc_frame_unpack((const uint32_t *)adc_buffer, valuesStored, frame->samples, &minVal, &maxVal);
+#endif
+    frame->numSamples = valuesStored;
+#if !TUNER_STREAMING_NORMALIZER
+    frame->minVal = minVal;
+    frame->maxVal = maxVal;
+#endif
+    frame->timestampUs = esp_timer_get_time() - (int64_t)numConversions * 1000000 / (profile.sampleRate * TUNER_ADC_DECIMATION);
+    frame->profile = &profile;
+#if TUNER_PROFILE_LATENCY
+    frame->adcReadUs = esp_timer_get_time();
+    frame->adcIsrUs = latency_trace_last_adc_isr_us(frame->adcReadUs);
+#endif
+
+    // The pool holds exactly as many frames as the ring can so this never fails.
+    s_ready_frames.push(frame);
+    return ESP_OK;
+}
+
+/// @brief The ADC ingest stage of the pitch detector pipeline.
+///
+/// Drains the ADC DMA pool as soon as the driver signals a finished conversion
+/// frame and hands the unpacked samples to `pitch_detector_task`. This runs on
+/// the other core so the ADC keeps getting serviced while detection runs on
+/// the previous frame.
+///
+/// When a different instrument is picked in the settings the ADC is set up
+/// again with that instrument's sample rate and frame size.
+///
+/// This is declared as an extern in main.cpp.
+void adc_ingest_task(void *pvParameter) {
+    static_assert(SOC_ADC_DIGI_RESULT_BYTES == sizeof(uint32_t), "The unpack kernel expects 32-bit TYPE2 conversion results");
+
+    // The SIMD unpack kernel needs the conversion words 16-byte aligned.
+    uint8_t *adc_buffer = (uint8_t *)heap_caps_aligned_alloc(ADC_FRAME_KERNEL_ALIGNMENT, TUNER_ADC_FRAME_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
     if (adc_buffer == NULL) {
         ESP_LOGI(TAG, "Failed to allocate memory for buffer");
+        vTaskDelete(NULL);
         return;
     }
     memset(adc_buffer, 0xcc, TUNER_ADC_FRAME_SIZE);
 
-    // Get the pitch detector ready
-    q::pitch_detector   pd(low_fs, high_fs, TUNER_ADC_SAMPLE_RATE, -40_dB);
-
-    // auto const&                 bits = pd.bits();
-    // auto const&                 edges = pd.edges();
-    // q::bitstream_acf<>          bacf{ bits };
-    // auto                        min_period = as_float(high_fs.period()) * TUNER_ADC_SAMPLE_RATE;
-    
-    // q::peak_envelope_follower   env{ 30_ms, TUNER_ADC_SAMPLE_RATE };
-    // q::one_pole_lowpass         lp{high_fs, TUNER_ADC_SAMPLE_RATE};
-    // q::one_pole_lowpass         lp2(low_fs, TUNER_ADC_SAMPLE_RATE);
-
-    // constexpr float             slope = 1.0f/2;
-    // constexpr float             makeup_gain = 2;
-    // q::compressor               comp{ -18_dB, slope };
-    // q::clip                     clip;
-
-    // float                       onset_threshold = lin_float(-28_dB);
-    // float                       release_threshold = lin_float(-60_dB);
-    // float                       threshold = onset_threshold;
+    // Every frame starts out free for the ingest stage to fill. This happens
+    // before the ADC starts so the detection stage can't be pushing yet.
+    for (size_t i = 0; i < TUNER_ADC_FRAME_POOL_SIZE; i++) {
+        s_free_frames.push(&s_frame_pool[i]);
+    }
 
-    auto sc_conf = q::signal_conditioner::config{};
-    auto sig_cond = q::signal_conditioner{sc_conf, low_fs, high_fs, TUNER_ADC_SAMPLE_RATE};
+    s_ingest_task_handle = xTaskGetCurrentTaskHandle();
 
-    s_task_handle = xTaskGetCurrentTaskHandle();
-    
+    TunerInstrument instrument = userSettings != NULL ? userSettings->instrument : DEFAULT_INSTRUMENT;
     adc_continuous_handle_t handle = NULL;
     adc_iir_filter_handle_t adc_filter = NULL;
-    continuous_adc_init(channel, sizeof(channel) / sizeof(adc_channel_t), &handle, &adc_filter);
+    continuous_adc_init(channel, sizeof(channel) / sizeof(adc_channel_t), instrument_profile(instrument), &handle, &adc_filter);
 
     adc_continuous_evt_cbs_t cbs = {
         .on_conv_done = s_conv_done_cb,
@@ -236,203 +364,144 @@ void pitch_detector_task(void *pvParameter) {
     ESP_ERROR_CHECK(adc_continuous_register_event_callbacks(handle, &cbs, NULL));
     ESP_ERROR_CHECK(adc_continuous_start(handle));
 
-    TunerNoteName lastSeenNote = NOTE_NONE;
-    int sameNoteSeenCount = 0;
-    FrequencyInfo freqInfo;
-    FrequencyInfo noFreq = {
-        .frequency = -1,
-        .cents = -1,
-        .targetFrequency = -1,
-        .targetNote = NOTE_NONE,
-        .targetOctave = -1,
-    };
-
-    TickType_t ticksBetweenFreqDetection = pdMS_TO_TICKS(5);
+#if TUNER_PROFILE_PITCH_DETECTOR
+    StageProfiler ingestProfiler("ingest");
+#endif
 
     while (1) {
-        /**
-         * This is to show you the way to use the ADC continuous mode driver event callback.
-         * This `ulTaskNotifyTake` will block when the data processing in the task is fast.
-         * However in this example, the data processing (print) is slow, so you barely block here.
-         *
-         * Without using this event callback (to notify this task), you can still just call
-         * `adc_continuous_read()` here in a loop, with/without a certain block timeout.
-         */
         ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
 
+        if (userSettings != NULL && userSettings->instrument != instrument) {
+            // Frames already handed over keep the old profile so the
+            // detection stage knows they're from before the switch.
+            instrument = userSettings->instrument;
+            continuous_adc_deinit(handle, adc_filter);
+#if TUNER_ADC_DECIMATION > 1
+            s_decimator.reset();
+#endif
+            continuous_adc_init(channel, sizeof(channel) / sizeof(adc_channel_t), instrument_profile(instrument), &handle, &adc_filter);
+            ESP_ERROR_CHECK(adc_continuous_register_event_callbacks(handle, &cbs, NULL));
+            ESP_ERROR_CHECK(adc_continuous_start(handle));
+            continue;
+        }
+
+        // Read until the driver has nothing left so the pool never backs up.
         while (1) {
-            if (userSettings == NULL) {
-                // Things aren't yet initialized. Do nothing.
-                vTaskDelay(pdMS_TO_TICKS(500));
-                continue;
+#if TUNER_PROFILE_PITCH_DETECTOR
+            int64_t ingestStart = esp_timer_get_time();
+#endif
+            esp_err_t ret = ingest_adc_frame(handle, adc_buffer, instrument_profile(instrument));
+            if (ret == ESP_ERR_TIMEOUT) {
+                break; // No more data available
             }
-
-            std::vector<float> in(TUNER_ADC_FRAME_SIZE); // a vector of values to pass into qlib
-
-            ret = adc_continuous_read(handle, adc_buffer, TUNER_ADC_FRAME_SIZE, &num_of_bytes_read, portMAX_DELAY);
+            if (ret == ESP_OK && s_detector_task_handle != NULL) {
+                xTaskNotifyGive(s_detector_task_handle);
+            }
+#if TUNER_PROFILE_PITCH_DETECTOR
             if (ret == ESP_OK) {
-                // ESP_LOGI(TAG, "ret is %x, num_of_bytes_read is %"PRIu32" bytes", ret, num_of_bytes_read);
-
-                // Get the data out of the ADC Conversion Result.
-                int valuesStored = 0;
-                float maxVal = 0;
-                float minVal = MAXFLOAT;
-                // ESP_LOGI(TAG, "Bytes read: %ld", num_of_bytes_read);
-                for (int i = 0; i < num_of_bytes_read; i += SOC_ADC_DIGI_RESULT_BYTES, valuesStored++) {
-                    adc_digi_output_data_t *p = (adc_digi_output_data_t*)&adc_buffer[i];
-                    // if (i == 20) {
-                    //     ESP_LOGI(TAG, "read value is: %d", TUNER_ADC_GET_DATA(p));
-                    // }
-
-                    int value = TUNER_ADC_GET_DATA(p);
-                    // int calibratedValue;
-                    // esp_err_t r = adc_cali_raw_to_voltage(cali_handle, value, &calibratedValue);
-                    // if (r == ESP_OK) {
-                    //     value = calibratedValue;
-                    // }
-
-                    // Do a first pass by just storing the raw values into the float array
-                    in[valuesStored] = value;
-
-                    // Track the min and max values we see so we can convert to values between -1.0f and +1.0f
-                    if (in[valuesStored] > maxVal) {
-                        maxVal = in[valuesStored];
-                    }
-                    if (in[valuesStored] < minVal) {
-                        minVal = in[valuesStored];
-                    }
-                }
-
-                // Bail out if the input does not meet the minimum criteria
-                float range = maxVal - minVal;
-                if (range < TUNER_READING_DIFF_MINIMUM) {
-                    xQueueOverwrite(frequencyQueue, &noFreq);
-                    // set_current_frequency(-1); // Indicate to the UI that there's no frequency available
-                    oneEUFilter.reset(); // Reset the 1EU filter so the next frequency it detects will be as fast as possible
-                    oneEUFilter2.reset();
-                    // smoother.reset();
-                    // movingAverage.reset();
-                    // medianMovingFilter.reset();
-                    // medianFilter.reset();
-                    pd.reset();
-
-                    lastSeenNote = NOTE_NONE;
-                    sameNoteSeenCount = 0;
-
-                    vTaskDelay(ticksBetweenFreqDetection);
-                    continue;
-                }
-
-                // oneEUFilter.setBeta(userSettings->oneEUBeta);
-                // smoother.setAmount(userSettings->expSmoothing);
-
-                // Normalize the values between -1.0 and +1.0 before processing with qlib.
-                float midVal = range / 2;
-                // ESP_LOGI(TAG, "min: %f  max: %f  range: %f  mid: %f", minVal, maxVal, range, midVal);
-                for (auto i = 0; i < valuesStored; i++) {
-                    // ESP_LOGI("adc", "%f", in[i]);
-                    float newPosition = in[i] - midVal - minVal;
-                    float normalizedValue = newPosition / midVal;
-                    // ESP_LOGI("norm-val", "%f is now %f", in[i], normalizedValue);
-                    // in[i] = normalizedValue;
-                    // float s = in[i]; // input signal
-                    float s = normalizedValue;
-
-                    // s = medianMovingFilter.addValue(s);
-
-                    // I've got the signal conditioning commented out right now
-                    // because it actually is making the frequency readings
-                    // NOT work. They probably just need to be tweaked a little.
-
-                    // Signal Conditioner
-                    s = sig_cond(s);
-                    // s = s * 2.5;
-
-                    // // Bandpass filter
-                    // s = lp(s);
-                    // s -= lp2(s);
-
-                    // // Envelope
-                    // auto e = env(std::abs(static_cast<int>(s)));
-                    // auto e_db = q::lin_to_db(e);
-
-                    // if (e > threshold) {
-                    //     // Compressor + make-up gain + hard clip
-                    //     auto gain = cycfi::q::lin_float(comp(e_db)) * makeup_gain;
-                    //     s = clip(s * gain);
-                    //     threshold = release_threshold;
-                    // } else {
-                    //     s = 0.0f;
-                    //     threshold = onset_threshold;
-                    // }
-
-                    // Pitch Detect
-                    // Send in each value into the pitch detector
-                    if (pd(s) == true) { // calculated a frequency
-                        auto f = pd.get_frequency();
-
-                        bool use1EUFilterFirst = true; // TODO: This may never be needed. Need to test which "feels" better for tuning
-                        // if (use1EUFilterFirst) {
-                            
-                        // Simple Exponential Smoothing
-                        // f = smoother.smooth(f);
-                        
-                        // 1EU Filtering
-                        double time_seconds;
-                        oneEUFilter.setFrequency(f);
-                        time_seconds = (double)esp_timer_get_time() / 1000000;    // Convert to seconds
-                        f = (float)oneEUFilter.filter((double)f, (TimeStamp)time_seconds);
-
-                        // f = movingAverage.addValue(f);
-                        // f = smoother.smooth(f);
-                        
-                        oneEUFilter2.setFrequency(f);
-                        time_seconds = (double)esp_timer_get_time() / 1000000;
-                        f = (float)oneEUFilter2.filter((double)f, (TimeStamp)time_seconds);
-                        
-                        // } else {
-                        //     // Simple Expoential Smoothing
-                        //     f = smoother.smooth(f);
-
-                        //     // 1EU Filtering
-                        //     f = (float)oneEUFilter.filter((double)f, (TimeStamp)time_seconds);
-                        // }
-
-                        // f = f / WEIRD_ESP32_WROOM_32_FREQ_FIX_FACTOR; // Use the weird factor only on ESP32-WROOM-32 (which the CYD is)
-
-                        if (f != -1.0f) {
-                            if (get_frequency_info(f, &freqInfo) == ESP_OK) {
-                                // Only show frequency info if we've seen the
-                                // same target note more than once in a row.
-                                // Doing this seems to help prevent sporadic
-                                // notes from appearing right as you pluck a
-                                // string.
-
-                                if (lastSeenNote == freqInfo.targetNote) {
-                                    sameNoteSeenCount++;
-                                } else {
-                                    sameNoteSeenCount = 0;
-                                }
-                                lastSeenNote = freqInfo.targetNote;
-
-                                if (sameNoteSeenCount > 1) {
-                                    xQueueOverwrite(frequencyQueue, &freqInfo);
-                                }
-                            }
-                        }
-                    }
-                }
-
-                vTaskDelay(pdMS_TO_TICKS(ticksBetweenFreqDetection));
-            } else if (ret == ESP_ERR_TIMEOUT) {
-                //We try to read `EXAMPLE_READ_LEN` until API returns timeout, which means there's no available data
-                break;
+                ingestProfiler.addSample(esp_timer_get_time() - ingestStart);
             }
+            if (ingestProfiler.getCount() >= TUNER_PROFILE_REPORT_FRAMES) {
+                log_stage_profile(ingestProfiler);
+            }
+#endif
         }
     }
 
-    free(adc_buffer);
+    heap_caps_free(adc_buffer);
 
-    ESP_ERROR_CHECK(adc_continuous_stop(handle));
-    ESP_ERROR_CHECK(adc_continuous_deinit(handle));
-}
\ No newline at end of file
+    continuous_adc_deinit(handle, adc_filter);
+}
+
+/// @brief Publishes a reading from the detection chain to the rest of the tuner
+/// and wakes up the GUI to show it.
+///
+/// The chain reports "no frequency" on every gated frame. Only the first one
+/// in a row is published so the GUI can stay idle while there's no signal.
+///
+/// @param context The `AdcFrame` the reading came from.
+static void publish_frequency_info(const FrequencyInfo *freqInfo, void *context) {
+    static bool lastWasNoFrequency = false;
+    bool isNoFrequency = freqInfo->frequency <= 0;
+    if (isNoFrequency && lastWasNoFrequency) {
+        return;
+    }
+    lastWasNoFrequency = isNoFrequency;
+
+    FrequencyInfo reading = *freqInfo;
+    reading.timestampUs = esp_timer_get_time();
+#if TUNER_PROFILE_LATENCY
+    const AdcFrame *frame = (const AdcFrame *)context;
+    reading.adcIsrUs = frame->adcIsrUs;
+    reading.adcReadUs = frame->adcReadUs;
+#endif
+    latestFrequencyInfo.publish(reading);
+
+    if (guiTaskHandle != NULL) {
+        xTaskNotifyGive(guiTaskHandle);
+    }
+}
+
+/// @brief The detection stage of the pitch detector pipeline.
+///
+/// Runs the qlib chain on frames produced by `adc_ingest_task` and publishes
+/// the results to `latestFrequencyInfo`. The chain is built for the
+/// instrument profile of the frames and the tuning preset in the settings and
+/// is rebuilt when either changes.
+///
+/// This is declared as an extern in main.cpp.
+void pitch_detector_task(void *pvParameter) {
+    // The pitch detector is set up once the first frame shows which
+    // instrument profile the ADC is running.
+    PitchDetectorChain *chain = NULL;
+    const InstrumentProfile *chainProfile = NULL;
+    TunerTuningPreset chainPreset = tuningPresetOff;
+
+    s_detector_task_handle = xTaskGetCurrentTaskHandle();
+
+#if TUNER_PROFILE_PITCH_DETECTOR
+    StageProfiler detectProfiler("detect");
+#endif
+
+    while (1) {
+        // Block until the ingest stage has handed over at least one frame.
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        if (userSettings == NULL) {
+            // Things aren't yet initialized. Do nothing.
+            continue;
+        }
+
+        AdcFrame *frame;
+        while (s_ready_frames.pop(frame)) {
+#if TUNER_PROFILE_PITCH_DETECTOR
+            int64_t detectStart = esp_timer_get_time();
+#endif
+            TunerTuningPreset preset = userSettings->tuningPreset;
+            if (frame->profile != chainProfile || preset != chainPreset) {
+                ESP_LOGI(TAG, "Pitch detector set up for %s, tuning preset %s", frame->profile->name, tuning_preset(preset).name);
+                delete chain;
+                chain = new PitchDetectorChain(*frame->profile, tuning_preset(preset));
+#if TUNER_PROFILE_LATENCY
+                chain->setDetectClock(esp_timer_get_time);
+#endif
+                chainProfile = frame->profile;
+                chainPreset = preset;
+            }
+#if TUNER_STREAMING_NORMALIZER
+            chain->processFrame(frame->samples, frame->numSamples, frame->timestampUs, publish_frequency_info, frame);
+#else
+            chain->processFrame(frame->samples, frame->numSamples, frame->minVal, frame->maxVal, frame->timestampUs, publish_frequency_info, frame);
+#endif
+
+            // Hand the frame back to the ingest stage.
+            s_free_frames.push(frame);
+#if TUNER_PROFILE_PITCH_DETECTOR
+            detectProfiler.addSample(esp_timer_get_time() - detectStart);
+            if (detectProfiler.getCount() >= TUNER_PROFILE_REPORT_FRAMES) {
+                log_stage_profile(detectProfiler);
+            }
+#endif
+        }
+    }
+}
@@ -20,6 +20,7 @@
 #include "defines.h"
 
 #include "esp_log.h"
+#include "esp_timer.h"
 
 static const char *TAG = "CONTROLLER";
 
@@ -29,6 +30,8 @@ TunerController::TunerController(tuner_state_will_change_cb_t willChange,
     stateWillChangeCallback = willChange;
     stateDidChangeCallback = didChange;
     footswitchPressedCallback = footswitchPressed;
+    numOfStateSubscribers = 0;
+    lastStateChangeUs = 0;
 
     TunerState initialState = tunerStateBooting;
     tunerStateQueue = xQueueCreate(TUNER_STATE_QUEUE_LENGTH, TUNER_STATE_QUEUE_ITEM_SIZE);
@@ -47,9 +50,27 @@ void TunerController::setState(TunerState new_state) {
     TunerState old_state = getState();
     stateWillChangeCallback(old_state, new_state);
     xQueueOverwrite(tunerStateQueue, &new_state);
+    lastStateChangeUs = esp_timer_get_time();
+
+    int numOfSubscribers = numOfStateSubscribers.load(std::memory_order_acquire);
+    for (int i = 0; i < numOfSubscribers; i++) {
+        xTaskNotify(stateSubscribers[i].task, stateSubscribers[i].notifyBits, eSetBits);
+    }
+
     stateDidChangeCallback(old_state, new_state);
 }
 
+bool TunerController::addStateSubscriber(TaskHandle_t task, uint32_t notifyBits) {
+    int index = numOfStateSubscribers.load();
+    if (index >= TUNER_STATE_MAX_SUBSCRIBERS) {
+        ESP_LOGE(TAG, "Too many state subscribers");
+        return false;
+    }
+    stateSubscribers[index] = { task, notifyBits };
+    numOfStateSubscribers.store(index + 1, std::memory_order_release);
+    return true;
+}
+
 void TunerController::footswitchPressed(FootswitchPress press) {
     footswitchPressedCallback(press);
 }
\ No newline at end of file
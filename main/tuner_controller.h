@@ -21,6 +21,9 @@
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "freertos/task.h"
+
+#include <atomic>
 
 enum TunerState: uint8_t {
     tunerStateBooting = 0,
@@ -47,10 +50,20 @@ typedef void (*tuner_state_did_change_cb_t)(TunerState old_state, TunerState new
 /// @param press Indicates the type of press.
 typedef void (*tuner_footswitch_pressed_cb_t)(FootswitchPress press);
 
+#define TUNER_STATE_MAX_SUBSCRIBERS 4
+
 class TunerController {
 
     QueueHandle_t tunerStateQueue;
 
+    struct StateSubscriber {
+        TaskHandle_t task;
+        uint32_t notifyBits;
+    };
+    StateSubscriber stateSubscribers[TUNER_STATE_MAX_SUBSCRIBERS];
+    std::atomic<int> numOfStateSubscribers;
+    std::atomic<int64_t> lastStateChangeUs;
+
     tuner_state_will_change_cb_t    stateWillChangeCallback;
     tuner_state_did_change_cb_t     stateDidChangeCallback;
     tuner_footswitch_pressed_cb_t   footswitchPressedCallback;
@@ -67,6 +80,16 @@ public:
     /// @param new_state The new state.
     void setState(TunerState new_state);
 
+    /// @brief Sets `notifyBits` in a task's notification value (eSetBits)
+    /// every time the state changes, right after `getState()` starts
+    /// returning the new state. Subscribe before the state starts changing
+    /// (at task startup).
+    /// @return Returns false if there are already `TUNER_STATE_MAX_SUBSCRIBERS`.
+    bool addStateSubscriber(TaskHandle_t task, uint32_t notifyBits);
+
+    /// @brief When the state last changed (`esp_timer_get_time()`), or 0.
+    int64_t getLastStateChangeUs() { return lastStateChangeUs.load(); }
+
     /// @brief Called when the momentary foot switch is pressed.
     /// @param press Indicates the type of press.
     void footswitchPressed(FootswitchPress press);
@@ -23,6 +23,9 @@
 #include "tuner_standby_ui_interface.h"
 #include "tuner_ui_interface.h"
 #include "user_settings.h"
+#include "LatestValue.hpp"
+#include "StageProfiler.hpp"
+#include "latency_trace.h"
 
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
@@ -33,16 +36,14 @@
 
 #include "waveshare.h"
 
+#include <algorithm>
 #include <cmath> // for log2()
+#include <inttypes.h>
 
 //
-// These are the tuner UIs available.
+// The tuner UIs available (see tuning-ui/tuner_ui_list.cpp).
 //
-#include "tuner_ui_attitude.h"
-#include "tuner_ui_needle.h"
-#include "tuner_ui_note_quiz.h"
-#include "tuner_ui_record_time.h"
-#include "tuner_ui_strobe.h"
+#include "tuner_ui_list.h"
 
 //
 // LVGL Support
@@ -55,7 +56,7 @@ static const char *TAG = "GUI";
 extern TunerController *tunerController;
 extern UserSettings *userSettings;
 extern "C" const lv_font_t fontawesome_48;
-extern QueueHandle_t frequencyQueue;
+extern LatestValue<FrequencyInfo> latestFrequencyInfo;
 
 // Local Function Declarations
 void update_ui(TunerState old_state, TunerState new_state);
@@ -82,6 +83,20 @@ bool is_gui_loaded = false;
 
 FrequencyInfo freqInfo;
 
+static TunerGUIFrameStats frame_stats = {};
+static StageProfiler render_latency_profiler("render latency");
+
+#if TUNER_PROFILE_DISPLAY_FLUSH
+static StageProfiler flush_profiler("flush");           // Time in the flush callback per frame (all chunks)
+static StageProfiler flush_wait_profiler("flush wait"); // Time waiting on the DMA per frame
+static StageProfiler refresh_profiler("refresh");       // Render + flush per frame
+static int64_t refresh_start_us = 0;
+static int64_t flush_start_us = 0;
+static int64_t flush_wait_start_us = 0;
+static int64_t frame_flush_us = 0;
+static int64_t frame_flush_wait_us = 0;
+#endif
+
 ///
 /// Add Standby GUIs here.
 ///
@@ -98,63 +113,6 @@ TunerStandbyGUIInterface available_standby_guis[] = {
 
 size_t num_of_available_standby_guis = 1;
 
-///
-/// Add Tuning GUIs here.
-///
-TunerGUIInterface needle_gui = {
-    .get_id = needle_gui_get_id,
-    .get_name = needle_gui_get_name,
-    .init = needle_gui_init,
-    .display_frequency = needle_gui_display_frequency,
-    .cleanup = needle_gui_cleanup
-};
-
-TunerGUIInterface strobe_gui = {
-    .get_id = strobe_gui_get_id,
-    .get_name = strobe_gui_get_name,
-    .init = strobe_gui_init,
-    .display_frequency = strobe_gui_display_frequency,
-    .cleanup = strobe_gui_cleanup
-};
-
-TunerGUIInterface attitude_gui = {
-    .get_id = attitude_gui_get_id,
-    .get_name = attitude_gui_get_name,
-    .init = attitude_gui_init,
-    .display_frequency = attitude_gui_display_frequency,
-    .cleanup = attitude_gui_cleanup
-};
-
-TunerGUIInterface record_time_ui = {
-    .get_id = record_time_gui_get_id,
-    .get_name = record_time_gui_get_name,
-    .init = record_time_gui_init,
-    .display_frequency = record_time_gui_display_frequency,
-    .cleanup = record_time_gui_cleanup
-};
-
-TunerGUIInterface note_quiz_gui = {
-    .get_id = quiz_gui_get_id,
-    .get_name = quiz_gui_get_name,
-    .init = quiz_gui_init,
-    .display_frequency = quiz_gui_display_frequency,
-    .cleanup = quiz_gui_cleanup
-};
-
-TunerGUIInterface available_guis[] = {
-
-    // IMPORTANT: Make sure you update `num_of_available_guis` below so any new
-    // Tuner GUI you add here will show up in the user settings as an option.
-    
-    needle_gui, // ID = 0
-    strobe_gui,
-    attitude_gui,
-    record_time_ui,
-    note_quiz_gui,
-};
-
-size_t num_of_available_guis = 5;
-
 TunerStandbyGUIInterface *active_standby_gui = NULL;
 TunerGUIInterface *active_gui = NULL;
 
@@ -170,6 +128,98 @@ TunerGUIInterface get_active_gui() {
     return active_gui;
 }
 
+void tuner_gui_get_frame_stats(TunerGUIFrameStats *stats) {
+    *stats = frame_stats;
+    stats->latencyMinUs = render_latency_profiler.getMin();
+    stats->latencyAvgUs = render_latency_profiler.getAverage();
+    stats->latencyMaxUs = render_latency_profiler.getMax();
+}
+
+/// @brief Converts milliseconds to ticks, rounding up so short waits don't
+/// turn into busy loops (the tick is 10 ms).
+static TickType_t ms_to_ticks_ceil(int64_t ms) {
+    return (TickType_t)((ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS);
+}
+
+/// @brief Turns what `lv_timer_handler()` returned into the time its next
+/// timer is due (0 if LVGL has no timers running).
+static int64_t lvgl_timer_due_time(uint32_t until_next_ms) {
+    return until_next_ms == LV_NO_TIMER_READY ? 0 : esp_timer_get_time() + (int64_t)until_next_ms * 1000;
+}
+
+#if TUNER_PROFILE_GUI
+static void log_frame_stats() {
+    ESP_LOGI(TAG, "frames: %" PRIu32 " rendered, %" PRIu32 " skipped, latency min %" PRId64 " us, avg %" PRId64 " us, max %" PRId64 " us",
+        frame_stats.framesRendered, frame_stats.framesSkipped,
+        render_latency_profiler.getMin(), render_latency_profiler.getAverage(), render_latency_profiler.getMax());
+    render_latency_profiler.reset();
+}
+#endif
+
+#if TUNER_PROFILE_DISPLAY_FLUSH
+/// @brief Times each display refresh. LVGL sends these events from
+/// `lv_timer_handler()` so they're never called concurrently.
+static void display_profile_event_cb(lv_event_t *e) {
+    int64_t now = esp_timer_get_time();
+    switch (lv_event_get_code(e)) {
+    case LV_EVENT_REFR_START:
+        refresh_start_us = now;
+        frame_flush_us = 0;
+        frame_flush_wait_us = 0;
+        break;
+    case LV_EVENT_FLUSH_START:
+        flush_start_us = now;
+        break;
+    case LV_EVENT_FLUSH_FINISH:
+        frame_flush_us += now - flush_start_us;
+        break;
+    case LV_EVENT_FLUSH_WAIT_START:
+        flush_wait_start_us = now;
+        break;
+    case LV_EVENT_FLUSH_WAIT_FINISH:
+        frame_flush_wait_us += now - flush_wait_start_us;
+        break;
+    case LV_EVENT_REFR_READY:
+        if (frame_flush_us == 0) {
+            break; // Nothing was invalidated so nothing was drawn
+        }
+        flush_profiler.addSample(frame_flush_us);
+        flush_wait_profiler.addSample(frame_flush_wait_us);
+        refresh_profiler.addSample(now - refresh_start_us);
+        if (refresh_profiler.getCount() == TUNER_PROFILE_DISPLAY_REPORT_FRAMES) {
+            ESP_LOGI(TAG, "rotation %d (%s): %s avg %" PRId64 " us max %" PRId64 " us, %s avg %" PRId64 " us, %s avg %" PRId64 " us max %" PRId64 " us",
+                lcd_display_get_rotation() * 90, LCD_SOFTWARE_ROTATION ? "software" : "panel",
+                flush_profiler.getName(), flush_profiler.getAverage(), flush_profiler.getMax(),
+                flush_wait_profiler.getName(), flush_wait_profiler.getAverage(),
+                refresh_profiler.getName(), refresh_profiler.getAverage(), refresh_profiler.getMax());
+            flush_profiler.reset();
+            flush_wait_profiler.reset();
+            refresh_profiler.reset();
+        }
+        break;
+    default:
+        break;
+    }
+}
+#endif
+
+#if TUNER_PROFILE_LATENCY
+/// @brief Tells the latency trace when LVGL sends the last area of a refresh
+/// to the panel.
+static void latency_trace_event_cb(lv_event_t *e) {
+    switch (lv_event_get_code(e)) {
+    case LV_EVENT_FLUSH_START:
+        latency_trace_flush_started(lv_display_flush_is_last((lv_display_t *)lv_event_get_target(e)));
+        break;
+    case LV_EVENT_REFR_READY:
+        latency_trace_refresh_finished();
+        break;
+    default:
+        break;
+    }
+}
+#endif
+
 /// @brief The main GUI task.
 ///
 /// This is the main GUI FreeRTOS task and is declared as an extern in main.cpp.
@@ -184,6 +234,12 @@ void tuner_gui_task(void *pvParameter) {
     // Make sure the user's preferred rotation is set up before we draw the screen.
     if (lvgl_port_lock(0)) {
         ESP_ERROR_CHECK(lcd_display_rotate(lvgl_display, userSettings->getDisplayOrientation()));
+#if TUNER_PROFILE_DISPLAY_FLUSH
+        lv_display_add_event_cb(lvgl_display, display_profile_event_cb, LV_EVENT_ALL, NULL);
+#endif
+#if TUNER_PROFILE_LATENCY
+        lv_display_add_event_cb(lvgl_display, latency_trace_event_cb, LV_EVENT_ALL, NULL);
+#endif
         lvgl_port_unlock();
     }
 
@@ -199,32 +255,117 @@ void tuner_gui_task(void *pvParameter) {
     TunerState initial_state = userSettings->initialState;
     tunerController->setState(initial_state);
 
+    uint32_t last_version = 0;      // Version of the last reading that was rendered
+    bool needs_render = true;       // Render even if there's no new reading (UI just changed)
+    bool note_showing = false;      // The last rendered reading had a note (UI may be animating)
+    bool last_show_mute_indicator = false;
+    int64_t last_render_time = 0;
+    int64_t lvgl_timer_due = 0;     // When LVGL's next timer (fade-out, animation) runs, 0 if none
+
     while(1) {
+        // Frame pacing: never render more often than the minimum interval.
+        int64_t since_render_ms = (esp_timer_get_time() - last_render_time) / 1000;
+        if (since_render_ms < TUNER_GUI_MIN_FRAME_INTERVAL_MS) {
+            vTaskDelay(ms_to_ticks_ceil(TUNER_GUI_MIN_FRAME_INTERVAL_MS - since_render_ms));
+        }
+
+        // Sleep until there's a new reading or a state change. If a note is
+        // showing, only sleep until its next animation frame, and never past
+        // the next LVGL timer so animations that outlive the note keep their
+        // frame rate.
+        uint32_t wait_ms = TUNER_GUI_IDLE_WAIT_MS;
+        if (note_showing) {
+            int64_t until_next_frame_ms = TUNER_GUI_ANIMATION_FRAME_INTERVAL_MS - (esp_timer_get_time() - last_render_time) / 1000;
+            wait_ms = (uint32_t)std::max(until_next_frame_ms, (int64_t)0);
+        }
+        if (lvgl_timer_due > 0) {
+            int64_t until_lvgl_timer_ms = (lvgl_timer_due - esp_timer_get_time()) / 1000;
+            wait_ms = std::min(wait_ms, (uint32_t)std::max(until_lvgl_timer_ms, (int64_t)0));
+        }
+        if (!needs_render && wait_ms > 0) {
+            ulTaskNotifyTake(pdTRUE, ms_to_ticks_ceil(wait_ms));
+        }
+
         TunerState newState = tunerController->getState();
 
         if (old_tuner_ui_state != newState) {
             update_ui(old_tuner_ui_state, newState);
             old_tuner_ui_state = newState;
+            needs_render = true;
         }
 
         bool monitoring_mode = userSettings->monitoringMode && newState == tunerStateStandby;
-        if ((monitoring_mode || newState == tunerStateTuning) && lvgl_port_lock(0)) {
-            bool show_mute_indicator = newState == tunerStateTuning && userSettings->monitoringMode;
+        if (!monitoring_mode && newState != tunerStateTuning) {
+            note_showing = false;
+            needs_render = false;
+            lvgl_timer_due = 0;
+            continue; // Standby or settings: LVGL's own task handles everything
+        }
 
-            if (!xQueuePeek(frequencyQueue, &freqInfo, 0)) {
-                freqInfo.frequency = -1;
+        bool show_mute_indicator = newState == tunerStateTuning && userSettings->monitoringMode;
+        if (show_mute_indicator != last_show_mute_indicator) {
+            last_show_mute_indicator = show_mute_indicator;
+            needs_render = true;
+        }
+
+        // If a read overlaps a publish, keep showing the previous reading.
+        bool has_new_reading = latestFrequencyInfo.readIfNewer(freqInfo, last_version);
+        bool animation_frame_due = note_showing
+            && (esp_timer_get_time() - last_render_time) / 1000 >= TUNER_GUI_ANIMATION_FRAME_INTERVAL_MS;
+        if (!has_new_reading && !needs_render && !animation_frame_due) {
+            if (lvgl_timer_due > 0 && esp_timer_get_time() >= lvgl_timer_due) {
+                // Nothing new to show but an LVGL timer is due. If the lock is
+                // busy, LVGL's own task is running the timers right now.
+                lvgl_timer_due = 0;
+                if (lvgl_port_lock(0)) {
+                    lvgl_timer_due = lvgl_timer_due_time(lv_timer_handler());
+                    lvgl_port_unlock();
+                }
             }
-            if (freqInfo.frequency > 0) {
-                get_active_gui().display_frequency(freqInfo.frequency, freqInfo.frequency, freqInfo.targetNote, freqInfo.targetOctave, freqInfo.cents, show_mute_indicator);
-            } else {
-                get_active_gui().display_frequency(0, 0, NOTE_NONE, 0, 0, show_mute_indicator);
+            frame_stats.framesSkipped++;
+            continue; // Nothing changed so there's nothing to draw
+        }
+
+        if (!lvgl_port_lock(0)) {
+            continue;
+        }
+        if (freqInfo.frequency > 0) {
+#if TUNER_PROFILE_LATENCY
+            if (has_new_reading) {
+                LatencyTraceRecord record = {
+                    .adcIsrUs = freqInfo.adcIsrUs,
+                    .adcReadUs = freqInfo.adcReadUs,
+                    .detectUs = freqInfo.detectUs,
+                    .publishUs = freqInfo.timestampUs,
+                    .displayUs = esp_timer_get_time(),
+                    .glassUs = 0,
+                };
+                latency_trace_reading_displayed(&record);
             }
+#endif
+            get_active_gui().display_frequency(freqInfo.frequency, freqInfo.frequency, freqInfo.targetNote, freqInfo.targetOctave, freqInfo.cents, show_mute_indicator);
+        } else {
+            get_active_gui().display_frequency(0, 0, NOTE_NONE, 0, 0, show_mute_indicator);
+        }
+        // Flush the changes now instead of waiting for LVGL's task to wake up.
+        lvgl_timer_due = lvgl_timer_due_time(lv_timer_handler());
+#if TUNER_PROFILE_LATENCY
+        latency_trace_collect();
+#endif
+        lvgl_port_unlock();
 
-            lvgl_port_unlock();
+        last_render_time = esp_timer_get_time();
+        note_showing = freqInfo.frequency > 0;
+        needs_render = false;
+        frame_stats.framesRendered++;
+        if (has_new_reading && freqInfo.timestampUs > 0) {
+            render_latency_profiler.addSample(last_render_time - freqInfo.timestampUs);
+        }
+#if TUNER_PROFILE_GUI
+        if (frame_stats.framesRendered % TUNER_PROFILE_GUI_REPORT_FRAMES == 0) {
+            log_frame_stats();
         }
-        
-        lv_timer_handler();
-        vTaskDelay(pdMS_TO_TICKS(33));
+#endif
     }
     vTaskDelay(portMAX_DELAY);
 }
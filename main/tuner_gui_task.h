@@ -23,4 +23,16 @@
 
 void user_settings_updated();
 
+/// @brief Counters kept by the GUI task's render loop.
+typedef struct {
+    uint32_t framesRendered;    // Calls to the active UI's `display_frequency()`
+    uint32_t framesSkipped;     // Wake-ups that had nothing new to draw
+    int64_t latencyMinUs;       // Time from a reading being published to it being rendered
+    int64_t latencyAvgUs;
+    int64_t latencyMaxUs;
+} TunerGUIFrameStats;
+
+/// @brief Returns a snapshot of the GUI task's render counters.
+void tuner_gui_get_frame_stats(TunerGUIFrameStats *stats);
+
 #endif
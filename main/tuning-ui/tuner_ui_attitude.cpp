@@ -18,8 +18,10 @@
  */
 #include "tuner_ui_attitude.h"
 
+#include <math.h>
 #include <stdlib.h>
 
+#include "tuner_ui_label_cache.h"
 #include "user_settings.h"
 
 #include "esp_log.h"
@@ -39,6 +41,14 @@
 #define ATTITUDE_GROUND_COLOR 0x000000
 #define ATTITUDE_SKY_COLOR 0x87CEEB
 #define ATTITUDE_RESOLUTION_FACTOR 1.25 // Move 1.25 pixels for every cent of change
+#define ATTITUDE_HORIZON_LINE_HEIGHT 4 // White line between the sky and the ground
+#define ATTITUDE_RULER_FIRST_CENTS 10
+#define ATTITUDE_RULER_LAST_CENTS 40
+#define ATTITUDE_RULER_STEP_CENTS 10
+#define ATTITUDE_RULER_LABEL_GAP 10
+#define ATTITUDE_RULER_LABEL_WIDTH 30 // Room for a 2 digit label
+#define ATTITUDE_RULER_LINE_COUNT (2 * ((ATTITUDE_RULER_LAST_CENTS - ATTITUDE_RULER_FIRST_CENTS) / ATTITUDE_RULER_STEP_CENTS + 1))
+#define ATTITUDE_MAX_DIRTY_AREAS (1 + 2 * ATTITUDE_RULER_LINE_COUNT) // Horizon band plus every ruler line before and after
 
 static const char *TAG = "ATTITUDE_UI";
 
@@ -59,8 +69,15 @@ LV_IMG_DECLARE(tuner_font_image_sharp)
 //
 // Function Definitions
 //
+int32_t attitude_center_y();
+bool attitude_ruler_is_labeled(int32_t cents);
+int32_t attitude_ruler_line_width(int32_t cents);
+void attitude_ruler_area(int32_t horizon_y, int32_t cents, lv_area_t *area);
 void attitude_create_slider(lv_obj_t * parent);
-void attitude_create_slider_ruler(lv_obj_t *parent);
+void attitude_horizon_draw_cb(lv_event_t *e);
+void attitude_move_horizon(int32_t new_horizon_y);
+bool attitude_join_areas(lv_area_t *area, const lv_area_t *other);
+void attitude_add_dirty_area(lv_area_t *dirty, int *dirty_count, lv_area_t area);
 void attitude_create_labels(lv_obj_t * parent);
 void attitude_create_arrows(lv_obj_t * parent);
 void attitude_update_note_name(TunerNoteName new_value);
@@ -78,7 +95,12 @@ lv_obj_t *attitude_parent_screen = NULL;
 // can be avoided if it is the same.
 TunerNoteName attitude_last_displayed_note = NOTE_NONE;
 
-lv_obj_t *attitude_slider;
+// The sky, ground and ruler are drawn by one full screen object around
+// `attitude_horizon_y` (screen row of the center of the horizon line). Moving
+// the horizon only invalidates the band that switches between sky and ground
+// and the spans the ruler ticks and labels cover before and after the move.
+lv_obj_t *attitude_horizon;
+int32_t attitude_horizon_y = 0;
 
 lv_obj_t *attitude_note_img_container;
 lv_obj_t *attitude_note_img;
@@ -92,7 +114,11 @@ lv_obj_t *attitude_frequency_label;
 lv_style_t attitude_frequency_label_style;
 lv_obj_t *attitude_cents_label;
 lv_style_t attitude_cents_label_style;
+TunerLabelStats attitude_label_stats;
+TunerLabelCache attitude_frequency_cache;
+TunerLabelCache attitude_cents_cache;
 bool attitude_is_landscape = false;
+bool attitude_showing_in_tune = false;
 
 lv_anim_t *attitude_last_note_anim = NULL;
 
@@ -118,38 +144,41 @@ void attitude_gui_init(lv_obj_t *screen) {
     attitude_create_slider(screen);
     attitude_create_arrows(screen);
     attitude_create_labels(screen);
+
+    tuner_label_stats_init(&attitude_label_stats, attitude_gui_get_name());
+    tuner_label_cache_init(&attitude_frequency_cache, attitude_frequency_label, 2, &attitude_label_stats);
+    tuner_label_cache_init(&attitude_cents_cache, attitude_cents_label, 1, &attitude_label_stats);
 }
 
 void attitude_gui_display_frequency(float frequency, float target_frequency, TunerNoteName note_name, int octave, float cents, bool show_mute_indicator) {
     if (note_name < 0) { return; } // Strangely I'm sometimes seeing negative values. No idea how.
+    tuner_label_stats_frame(&attitude_label_stats);
     if (note_name != NOTE_NONE) {
-        lv_label_set_text_fmt(attitude_frequency_label, "%.2f", frequency);
-        lv_obj_clear_flag(attitude_frequency_label, LV_OBJ_FLAG_HIDDEN);
+        tuner_label_cache_set_value(&attitude_frequency_cache, frequency);
+        tuner_label_cache_set_hidden(&attitude_frequency_cache, false);
 
         if (attitude_last_displayed_note != note_name) {
             attitude_update_note_name(note_name);
             attitude_last_displayed_note = note_name; // prevent setting this so often to help prevent an LVGL crash
         }
 
-        lv_label_set_text_fmt(attitude_cents_label, "%.1f", cents);
-        lv_obj_clear_flag(attitude_cents_label, LV_OBJ_FLAG_HIDDEN);
+        tuner_label_cache_set_value(&attitude_cents_cache, cents);
+        tuner_label_cache_set_hidden(&attitude_cents_cache, false);
 
-        if (abs(cents) <= userSettings->inTuneCentsWidth) {
+        // Only restyle the ticks when they change, setting a style redraws
+        // them even if the value is the same.
+        bool in_tune = abs(cents) <= userSettings->inTuneCentsWidth;
+        if (in_tune != attitude_showing_in_tune) {
+            attitude_showing_in_tune = in_tune;
             // When the tuning is within the threshold, show the left and right
             // triangles in orange.
-            lv_obj_set_style_bg_color(attitude_left_tick, lv_palette_main(LV_PALETTE_ORANGE), 0);
-            lv_obj_set_style_bg_color(attitude_right_tick, lv_palette_main(LV_PALETTE_ORANGE), 0);
-        } else {
-            lv_obj_set_style_bg_color(attitude_left_tick, lv_color_white(), 0);
-            lv_obj_set_style_bg_color(attitude_right_tick, lv_color_white(), 0);
+            lv_color_t tick_color = in_tune ? lv_palette_main(LV_PALETTE_ORANGE) : lv_color_white();
+            lv_obj_set_style_bg_color(attitude_left_tick, tick_color, 0);
+            lv_obj_set_style_bg_color(attitude_right_tick, tick_color, 0);
         }
 
-        // Set the vertical position of the slider to indicate the horizon moving
-        lv_obj_align(
-            attitude_slider,
-            LV_ALIGN_CENTER,
-            0,
-            (attitude_is_landscape ? ATTITUDE_LANDSCAPE_VERTICAL_OFFSET : ATTITUDE_PORTRAIT_VERTICAL_OFFSET) + cents * ATTITUDE_RESOLUTION_FACTOR * -1);
+        // Move the horizon
+        attitude_move_horizon(attitude_center_y() - lroundf(cents * ATTITUDE_RESOLUTION_FACTOR));
     } else {
         // Hide the pitch and indicators since it's not detected
         if (attitude_last_displayed_note != NOTE_NONE) {
@@ -158,8 +187,8 @@ void attitude_gui_display_frequency(float frequency, float target_frequency, Tun
         }
 
         // Hide the frequency, and cents labels
-        lv_obj_add_flag(attitude_cents_label, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_add_flag(attitude_frequency_label, LV_OBJ_FLAG_HIDDEN);
+        tuner_label_cache_set_hidden(&attitude_cents_cache, true);
+        tuner_label_cache_set_hidden(&attitude_frequency_cache, true);
     }
 
     if (show_mute_indicator) {
@@ -173,102 +202,195 @@ void attitude_gui_cleanup() {
     // TODO: Do any cleanup needed here. 
 }
 
+/// @brief Screen row the horizon sits on when the note is in tune.
+int32_t attitude_center_y() {
+    return screen_height / 2 + (attitude_is_landscape ? ATTITUDE_LANDSCAPE_VERTICAL_OFFSET : ATTITUDE_PORTRAIT_VERTICAL_OFFSET);
+}
+
+/// @brief Every other ruler line is longer and labeled.
+bool attitude_ruler_is_labeled(int32_t cents) {
+    return LV_ABS(cents) % 20 == 0;
+}
+
+int32_t attitude_ruler_line_width(int32_t cents) {
+    return attitude_ruler_is_labeled(cents) ? 20 + LV_ABS(cents) : 20;
+}
+
+/// @brief Screen area covered by the ruler line (and its labels) for `cents`
+/// when the horizon is at `horizon_y`.
+void attitude_ruler_area(int32_t horizon_y, int32_t cents, lv_area_t *area) {
+    lv_area_t coords;
+    lv_obj_get_coords(attitude_horizon, &coords);
+    int32_t center_x = (coords.x1 + coords.x2) / 2;
+    int32_t line_width = attitude_ruler_line_width(cents);
+    int32_t label_span = attitude_ruler_is_labeled(cents) ? ATTITUDE_RULER_LABEL_GAP + ATTITUDE_RULER_LABEL_WIDTH : 0;
+    int32_t line_y = horizon_y - lroundf(cents * ATTITUDE_RESOLUTION_FACTOR);
+    int32_t half_height = lv_font_get_line_height(LV_FONT_DEFAULT) / 2 + 1;
+    area->x1 = center_x - line_width / 2 - label_span;
+    area->y1 = line_y - half_height;
+    area->x2 = center_x - line_width / 2 + line_width - 1 + label_span;
+    area->y2 = line_y + half_height;
+}
+
 void attitude_create_slider(lv_obj_t * parent) {
-    // Put some sky and ground behind the slider so black isn't exposed when
-    // the slider is moved.
-    lv_obj_t *background_sky = lv_obj_create(parent);
-    lv_obj_set_size(background_sky, lv_pct(100), lv_pct(50));
-    lv_obj_set_style_border_width(background_sky, 0, 0);
-    lv_obj_set_style_bg_color(background_sky, lv_color_hex(ATTITUDE_SKY_COLOR), 0);
-    lv_obj_set_style_radius(background_sky, 0, 0);
-    lv_obj_align(background_sky, LV_ALIGN_TOP_LEFT, 0, 0);
-
-    lv_obj_t *background_ground = lv_obj_create(parent);
-    lv_obj_set_size(background_ground, lv_pct(100), lv_pct(50));
-    lv_obj_set_style_bg_color(background_ground, lv_color_hex(ATTITUDE_GROUND_COLOR), 0);
-    lv_obj_set_style_radius(background_ground, 0, 0);
-    lv_obj_set_style_border_opa(background_ground, 0, 0);
-    lv_obj_align(background_ground, LV_ALIGN_BOTTOM_LEFT, 0, 0);
-
-    // Create the container for the slider
-    attitude_slider = lv_obj_create(parent);
-    lv_obj_set_size(attitude_slider, lv_pct(100), lv_pct(100));
-    lv_obj_set_style_pad_all(attitude_slider, 0, LV_PART_MAIN);
-    lv_obj_set_style_border_width(attitude_slider, 0, 0);
-    lv_obj_set_scrollbar_mode(attitude_slider, LV_SCROLLBAR_MODE_OFF);
-    lv_obj_set_style_bg_color(attitude_slider, lv_color_white(), 0);
-    lv_obj_align(attitude_slider, LV_ALIGN_CENTER, 0, attitude_is_landscape ? ATTITUDE_LANDSCAPE_VERTICAL_OFFSET : ATTITUDE_PORTRAIT_VERTICAL_OFFSET);
-
-    // Create the top box that represents the sky
-    lv_obj_t *sky = lv_obj_create(attitude_slider);
-    lv_obj_set_style_border_width(sky, 0, 0);
-    lv_obj_set_size(sky, lv_pct(100), lv_pct(50));
-    lv_obj_set_style_bg_color(sky, lv_color_hex(ATTITUDE_SKY_COLOR), 0);
-    lv_obj_set_style_radius(background_sky, 0, 0);
-    lv_obj_align(sky, LV_ALIGN_TOP_LEFT, 0, -2); // Offset by 2 pixels to get the slider white background to show through and look like the horizon line
-
-    // Create the bottom box that represents the ground
-    lv_obj_t *ground = lv_obj_create(attitude_slider);
-    lv_obj_set_style_border_width(ground, 0, 0);
-    lv_obj_set_size(ground, lv_pct(100), lv_pct(50));
-    lv_obj_set_style_bg_color(ground, lv_color_hex(ATTITUDE_GROUND_COLOR), 0); // brownish
-    lv_obj_set_style_radius(ground, 0, 0);
-    // lv_obj_set_style_bg_color(ground, lv_color_black(), 0);
-    lv_obj_align(ground, LV_ALIGN_BOTTOM_LEFT, 0, 2); // Offset by 2 pixels to get the slider white background to show through
-
-    attitude_create_slider_ruler(attitude_slider);
+    attitude_horizon = lv_obj_create(parent);
+    lv_obj_remove_style_all(attitude_horizon); // Everything is drawn by attitude_horizon_draw_cb
+    lv_obj_set_size(attitude_horizon, lv_pct(100), lv_pct(100));
+    lv_obj_remove_flag(attitude_horizon, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_remove_flag(attitude_horizon, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_align(attitude_horizon, LV_ALIGN_TOP_LEFT, 0, 0);
+    lv_obj_add_event_cb(attitude_horizon, attitude_horizon_draw_cb, LV_EVENT_DRAW_MAIN, NULL);
+
+    attitude_horizon_y = attitude_center_y();
+    attitude_showing_in_tune = false;
+}
+
+void attitude_horizon_draw_cb(lv_event_t *e) {
+    lv_obj_t *obj = (lv_obj_t *)lv_event_get_target(e);
+    lv_layer_t *layer = lv_event_get_layer(e);
+    lv_area_t coords;
+    lv_obj_get_coords(obj, &coords);
+    int32_t center_x = (coords.x1 + coords.x2) / 2;
+
+    // Sky, horizon line and ground. LVGL clips all of these to the rows that
+    // were invalidated.
+    lv_draw_rect_dsc_t rect_dsc;
+    lv_draw_rect_dsc_init(&rect_dsc);
+    rect_dsc.radius = 0;
+    rect_dsc.bg_opa = LV_OPA_COVER;
+
+    int32_t line_top = attitude_horizon_y - ATTITUDE_HORIZON_LINE_HEIGHT / 2;
+    int32_t line_bottom = line_top + ATTITUDE_HORIZON_LINE_HEIGHT - 1;
+    lv_area_t area = { coords.x1, coords.y1, coords.x2, line_top - 1 };
+    rect_dsc.bg_color = lv_color_hex(ATTITUDE_SKY_COLOR);
+    lv_draw_rect(layer, &rect_dsc, &area);
+
+    area.y1 = line_top;
+    area.y2 = line_bottom;
+    rect_dsc.bg_color = lv_color_white();
+    lv_draw_rect(layer, &rect_dsc, &area);
+
+    area.y1 = line_bottom + 1;
+    area.y2 = coords.y2;
+    rect_dsc.bg_color = lv_color_hex(ATTITUDE_GROUND_COLOR);
+    lv_draw_rect(layer, &rect_dsc, &area);
+
+    // Ruler lines above and below the horizon, every other one labeled
+    rect_dsc.bg_color = lv_color_white();
+    rect_dsc.bg_opa = LV_OPA_50;
+
+    lv_draw_label_dsc_t label_dsc;
+    lv_draw_label_dsc_init(&label_dsc);
+    label_dsc.color = lv_color_white();
+    label_dsc.opa = LV_OPA_50;
+    label_dsc.font = LV_FONT_DEFAULT;
+    label_dsc.text_local = 1; // text is on the stack and LVGL draws later
+    int32_t label_height = lv_font_get_line_height(LV_FONT_DEFAULT);
+
+    for (int32_t i = ATTITUDE_RULER_FIRST_CENTS; i <= ATTITUDE_RULER_LAST_CENTS; i += ATTITUDE_RULER_STEP_CENTS) {
+        bool is_label_line = attitude_ruler_is_labeled(i);
+        int32_t line_width = attitude_ruler_line_width(i);
+        char text[4];
+        lv_snprintf(text, sizeof(text), "%d", (int)i);
+
+        for (int32_t sign = -1; sign <= 1; sign += 2) {
+            int32_t line_y = attitude_horizon_y + sign * lroundf(i * ATTITUDE_RESOLUTION_FACTOR);
+            lv_area_t line = {
+                center_x - line_width / 2,
+                line_y - ATTITUDE_RULER_LINE_WIDTH / 2,
+                center_x - line_width / 2 + line_width - 1,
+                line_y - ATTITUDE_RULER_LINE_WIDTH / 2 + ATTITUDE_RULER_LINE_WIDTH - 1,
+            };
+            lv_draw_rect(layer, &rect_dsc, &line);
+
+            if (!is_label_line) {
+                continue;
+            }
+            label_dsc.text = text;
+            lv_area_t label_area = {
+                line.x1 - ATTITUDE_RULER_LABEL_GAP - ATTITUDE_RULER_LABEL_WIDTH,
+                line_y - label_height / 2,
+                line.x1 - ATTITUDE_RULER_LABEL_GAP - 1,
+                line_y - label_height / 2 + label_height - 1,
+            };
+            label_dsc.align = LV_TEXT_ALIGN_RIGHT;
+            lv_draw_label(layer, &label_dsc, &label_area);
+
+            label_area.x1 = line.x2 + ATTITUDE_RULER_LABEL_GAP + 1;
+            label_area.x2 = line.x2 + ATTITUDE_RULER_LABEL_GAP + ATTITUDE_RULER_LABEL_WIDTH;
+            label_dsc.align = LV_TEXT_ALIGN_LEFT;
+            lv_draw_label(layer, &label_dsc, &label_area);
+        }
+    }
+}
+
+/// @brief Grows `area` to cover `other` when they overlap or touch and the
+/// joined area isn't bigger than the two of them apart.
+bool attitude_join_areas(lv_area_t *area, const lv_area_t *other) {
+    if (other->x1 > area->x2 + 1 || other->x2 < area->x1 - 1 || other->y1 > area->y2 + 1 || other->y2 < area->y1 - 1) {
+        return false;
+    }
+    lv_area_t joined = {
+        LV_MIN(area->x1, other->x1),
+        LV_MIN(area->y1, other->y1),
+        LV_MAX(area->x2, other->x2),
+        LV_MAX(area->y2, other->y2),
+    };
+    if (lv_area_get_size(&joined) > lv_area_get_size(area) + lv_area_get_size(other)) {
+        return false;
+    }
+    *area = joined;
+    return true;
 }
 
-void attitude_create_slider_ruler(lv_obj_t *parent) {
-    for (int i = 10; i < 50; i += 10) {
-        bool is_label_line = i % 20 == 0;
-        int line_width = (is_label_line ? 20 + i : 20);
-
-        // Top line
-        lv_obj_t *line = lv_obj_create(parent);
-        lv_obj_set_size(line, line_width, ATTITUDE_RULER_LINE_WIDTH);
-        lv_obj_set_style_bg_color(line, lv_color_white(), 0);
-        lv_obj_set_style_bg_opa(line, LV_OPA_50, 0);
-        lv_obj_set_style_border_width(line, 0, 0);
-        lv_obj_align(line, LV_ALIGN_CENTER, 0, i * -1 * ATTITUDE_RESOLUTION_FACTOR);
-
-        lv_obj_t *label; 
-        if (is_label_line) {
-            label = lv_label_create(parent);
-            lv_label_set_text_fmt(label, "%d", i);
-            lv_obj_set_style_opa(label, LV_OPA_50, 0);
-            lv_obj_align(label, LV_ALIGN_CENTER, 0, 0);
-            lv_obj_align_to(label, line, LV_ALIGN_OUT_LEFT_MID, -10, 0);
-
-            label = lv_label_create(parent);
-            lv_label_set_text_fmt(label, "%d", i);
-            lv_obj_set_style_opa(label, LV_OPA_50, 0);
-            lv_obj_align(label, LV_ALIGN_CENTER, 0, 0);
-            lv_obj_align_to(label, line, LV_ALIGN_OUT_RIGHT_MID, 10, 0);
+/// @brief Adds `area` to the `dirty` list, joining it with any area it
+/// overlaps.
+void attitude_add_dirty_area(lv_area_t *dirty, int *dirty_count, lv_area_t area) {
+    for (int i = 0; i < *dirty_count; i++) {
+        if (attitude_join_areas(&area, &dirty[i])) {
+            // The joined area may now overlap one that was already checked
+            dirty[i] = dirty[--(*dirty_count)];
+            i = -1;
         }
+    }
+    dirty[(*dirty_count)++] = area;
+}
 
-        // Bottom line
-        line = lv_obj_create(parent);
-        lv_obj_set_size(line, line_width, ATTITUDE_RULER_LINE_WIDTH);
-        lv_obj_set_style_bg_color(line, lv_color_white(), 0);
-        lv_obj_set_style_bg_opa(line, LV_OPA_50, 0);
-        lv_obj_set_style_border_width(line, 0, 0);
-        lv_obj_align(line, LV_ALIGN_CENTER, 0, i * ATTITUDE_RESOLUTION_FACTOR);
-
-        if (is_label_line) {
-            label = lv_label_create(parent);
-            lv_label_set_text_fmt(label, "%d", i);
-            lv_obj_set_style_opa(label, LV_OPA_50, 0);
-            lv_obj_align(label, LV_ALIGN_CENTER, 0, 0);
-            lv_obj_align_to(label, line, LV_ALIGN_OUT_LEFT_MID, -10, 0);
-
-            label = lv_label_create(parent);
-            lv_label_set_text_fmt(label, "%d", i);
-            lv_obj_set_style_opa(label, LV_OPA_50, 0);
-            lv_obj_align(label, LV_ALIGN_CENTER, 0, 0);
-            lv_obj_align_to(label, line, LV_ALIGN_OUT_RIGHT_MID, 10, 0);
+void attitude_move_horizon(int32_t new_horizon_y) {
+    int32_t old_horizon_y = attitude_horizon_y;
+    if (new_horizon_y == old_horizon_y) {
+        return;
+    }
+    attitude_horizon_y = new_horizon_y;
+
+    lv_area_t dirty[ATTITUDE_MAX_DIRTY_AREAS];
+    int dirty_count = 0;
+
+    // The full width rows that switch between sky and ground, plus the
+    // horizon line at both ends.
+    int32_t half_line = ATTITUDE_HORIZON_LINE_HEIGHT / 2 + 1;
+    lv_area_t band;
+    lv_obj_get_coords(attitude_horizon, &band);
+    band.y1 = LV_MIN(old_horizon_y, new_horizon_y) - half_line;
+    band.y2 = LV_MAX(old_horizon_y, new_horizon_y) + half_line;
+    attitude_add_dirty_area(dirty, &dirty_count, band);
+
+    // Every ruler line moves with the horizon. Only the span of its tick and
+    // labels before and after the move needs redrawing.
+    for (int32_t i = ATTITUDE_RULER_FIRST_CENTS; i <= ATTITUDE_RULER_LAST_CENTS; i += ATTITUDE_RULER_STEP_CENTS) {
+        for (int32_t cents = -i; cents <= i; cents += 2 * i) {
+            lv_area_t area;
+            attitude_ruler_area(old_horizon_y, cents, &area);
+            attitude_add_dirty_area(dirty, &dirty_count, area);
+            attitude_ruler_area(new_horizon_y, cents, &area);
+            attitude_add_dirty_area(dirty, &dirty_count, area);
         }
     }
+
+    // LVGL clips each area to the object
+    for (int i = 0; i < dirty_count; i++) {
+        lv_obj_invalidate_area(attitude_horizon, &dirty[i]);
+    }
 }
 
 void attitude_create_labels(lv_obj_t * parent) {
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "tuner_ui_label_cache.h"
+
+#include <inttypes.h>
+#include <math.h>
+
+#include "esp_log.h"
+
+#if TUNER_PROFILE_LABELS
+static const char *TAG = "LABEL_CACHE";
+#endif
+
+#define TUNER_LABEL_MAX_DECIMALS 3
+
+void tuner_label_stats_init(TunerLabelStats *stats, const char *ui_name) {
+    stats->ui_name = ui_name;
+    stats->frames = 0;
+    stats->invalidations = 0;
+    stats->skipped = 0;
+}
+
+void tuner_label_stats_frame(TunerLabelStats *stats) {
+    stats->frames++;
+#if TUNER_PROFILE_LABELS
+    if (stats->frames >= TUNER_PROFILE_LABELS_REPORT_FRAMES) {
+        ESP_LOGI(TAG, "%s: %" PRIu32 " frames, %" PRIu32 " label invalidations, %" PRIu32 " skipped",
+            stats->ui_name, stats->frames, stats->invalidations, stats->skipped);
+        stats->frames = 0;
+        stats->invalidations = 0;
+        stats->skipped = 0;
+    }
+#endif
+}
+
+void tuner_label_cache_init(TunerLabelCache *cache, lv_obj_t *label, uint8_t decimals, TunerLabelStats *stats) {
+    if (decimals > TUNER_LABEL_MAX_DECIMALS) {
+        decimals = TUNER_LABEL_MAX_DECIMALS;
+    }
+    cache->label = label;
+    cache->stats = stats;
+    cache->decimals = decimals;
+    cache->scale = 1;
+    for (uint8_t i = 0; i < decimals; i++) {
+        cache->scale *= 10;
+    }
+    cache->has_value = false;
+    cache->last_value = 0;
+}
+
+bool tuner_label_cache_set_value(TunerLabelCache *cache, float value) {
+    int32_t quantized = (int32_t)lroundf(value * cache->scale);
+    if (cache->has_value && quantized == cache->last_value) {
+        cache->stats->skipped++;
+        return false;
+    }
+    cache->last_value = quantized;
+    cache->has_value = true;
+
+    // Format from the quantized value with integer math so the text always
+    // matches what was compared (and "-0.0" never shows up). Digits are
+    // written from the end of the buffer backwards.
+    char text[16];
+    char *p = text + sizeof(text) - 1;
+    *p = '\0';
+    uint32_t magnitude = quantized < 0 ? -(uint32_t)quantized : (uint32_t)quantized;
+    for (uint8_t i = 0; i < cache->decimals; i++) {
+        *--p = '0' + magnitude % 10;
+        magnitude /= 10;
+    }
+    if (cache->decimals > 0) {
+        *--p = '.';
+    }
+    do {
+        *--p = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (quantized < 0) {
+        *--p = '-';
+    }
+    lv_label_set_text(cache->label, p);
+    cache->stats->invalidations++;
+    return true;
+}
+
+void tuner_label_cache_set_hidden(TunerLabelCache *cache, bool hidden) {
+    if (lv_obj_has_flag(cache->label, LV_OBJ_FLAG_HIDDEN) == hidden) {
+        cache->stats->skipped++;
+        return;
+    }
+    if (hidden) {
+        lv_obj_add_flag(cache->label, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_clear_flag(cache->label, LV_OBJ_FLAG_HIDDEN);
+    }
+    cache->stats->invalidations++;
+}
+
+void tuner_label_cache_reset(TunerLabelCache *cache) {
+    cache->has_value = false;
+}
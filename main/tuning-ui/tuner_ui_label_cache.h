@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_UI_LABEL_CACHE)
+#define TUNER_UI_LABEL_CACHE
+
+#include <stdint.h>
+
+#include "lvgl.h"
+#include "defines.h"
+
+/// @brief Counts how many times a tuner UI touched its labels.
+///
+/// Every label cache of a UI points at the same stats so the UI can report
+/// one number per frame.
+typedef struct {
+    const char *ui_name;
+    uint32_t frames;
+    uint32_t invalidations; // Label text or visibility actually changed
+    uint32_t skipped;       // Update was dropped because nothing on screen would change
+} TunerLabelStats;
+
+/// @brief Remembers what a numeric label is showing so it is only touched
+/// when the text on the screen would change.
+///
+/// Values are quantized to the number of decimals the label shows and the
+/// label is only reformatted when the quantized value changes, so a reading
+/// of 440.001 followed by 440.004 doesn't run snprintf, reallocate the label
+/// text or invalidate the label.
+typedef struct {
+    lv_obj_t *label;
+    TunerLabelStats *stats;
+    uint8_t decimals;
+    int32_t scale;
+    int32_t last_value; // Quantized value currently shown
+    bool has_value;
+} TunerLabelCache;
+
+void tuner_label_stats_init(TunerLabelStats *stats, const char *ui_name);
+
+/// @brief Call once per `display_frequency()` call. Logs the counters every
+/// TUNER_PROFILE_LABELS_REPORT_FRAMES frames when TUNER_PROFILE_LABELS is on.
+void tuner_label_stats_frame(TunerLabelStats *stats);
+
+/// @brief Attach a cache to a label.
+/// @param decimals Number of decimals to show (0-3).
+void tuner_label_cache_init(TunerLabelCache *cache, lv_obj_t *label, uint8_t decimals, TunerLabelStats *stats);
+
+/// @brief Show `value` with the cache's number of decimals. Only touches the
+/// label when the rounded value differs from what is already shown.
+/// @return true if the label text was changed.
+bool tuner_label_cache_set_value(TunerLabelCache *cache, float value);
+
+/// @brief Show or hide the label, only touching it if the state changes.
+void tuner_label_cache_set_hidden(TunerLabelCache *cache, bool hidden);
+
+/// @brief Forget the shown value so the next set_value() always formats.
+void tuner_label_cache_reset(TunerLabelCache *cache);
+
+#endif
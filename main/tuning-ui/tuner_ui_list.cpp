@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "tuner_ui_list.h"
+
+#include "tuner_ui_attitude.h"
+#include "tuner_ui_needle.h"
+#include "tuner_ui_note_quiz.h"
+#include "tuner_ui_record_time.h"
+#include "tuner_ui_scroll_strobe.h"
+#include "tuner_ui_strobe.h"
+
+///
+/// Add Tuning GUIs here.
+///
+TunerGUIInterface needle_gui = {
+    .get_id = needle_gui_get_id,
+    .get_name = needle_gui_get_name,
+    .init = needle_gui_init,
+    .display_frequency = needle_gui_display_frequency,
+    .cleanup = needle_gui_cleanup
+};
+
+TunerGUIInterface strobe_gui = {
+    .get_id = strobe_gui_get_id,
+    .get_name = strobe_gui_get_name,
+    .init = strobe_gui_init,
+    .display_frequency = strobe_gui_display_frequency,
+    .cleanup = strobe_gui_cleanup
+};
+
+TunerGUIInterface attitude_gui = {
+    .get_id = attitude_gui_get_id,
+    .get_name = attitude_gui_get_name,
+    .init = attitude_gui_init,
+    .display_frequency = attitude_gui_display_frequency,
+    .cleanup = attitude_gui_cleanup
+};
+
+TunerGUIInterface record_time_ui = {
+    .get_id = record_time_gui_get_id,
+    .get_name = record_time_gui_get_name,
+    .init = record_time_gui_init,
+    .display_frequency = record_time_gui_display_frequency,
+    .cleanup = record_time_gui_cleanup
+};
+
+TunerGUIInterface note_quiz_gui = {
+    .get_id = quiz_gui_get_id,
+    .get_name = quiz_gui_get_name,
+    .init = quiz_gui_init,
+    .display_frequency = quiz_gui_display_frequency,
+    .cleanup = quiz_gui_cleanup
+};
+
+TunerGUIInterface scroll_strobe_gui = {
+    .get_id = scroll_strobe_gui_get_id,
+    .get_name = scroll_strobe_gui_get_name,
+    .init = scroll_strobe_gui_init,
+    .display_frequency = scroll_strobe_gui_display_frequency,
+    .cleanup = scroll_strobe_gui_cleanup
+};
+
+TunerGUIInterface available_guis[] = {
+
+    // IMPORTANT: Make sure you update `num_of_available_guis` below so any new
+    // Tuner GUI you add here will show up in the user settings as an option.
+    
+    needle_gui, // ID = 0
+    strobe_gui,
+    attitude_gui,
+    record_time_ui,
+    note_quiz_gui,
+    scroll_strobe_gui,
+};
+
+size_t num_of_available_guis = 6;
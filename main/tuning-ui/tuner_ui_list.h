@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_UI_LIST)
+#define TUNER_UI_LIST
+
+#include <stddef.h>
+
+#include "tuner_ui_interface.h"
+
+/// @brief Every tuner UI, indexed by its ID.
+///
+/// Shared by the GUI task and the host render benchmark (host/) so a new UI
+/// only has to be added in one place.
+extern TunerGUIInterface available_guis[];
+extern size_t num_of_available_guis;
+
+#endif
@@ -20,6 +20,7 @@
 
 #include <stdlib.h>
 
+#include "tuner_ui_label_cache.h"
 #include "user_settings.h"
 
 #include "esp_lvgl_port.h"
@@ -77,6 +78,9 @@ lv_obj_t *needle_frequency_label;
 lv_style_t needle_frequency_label_style;
 lv_obj_t *needle_cents_label;
 lv_style_t needle_cents_label_style;
+TunerLabelStats needle_label_stats;
+TunerLabelCache needle_frequency_cache;
+TunerLabelCache needle_cents_cache;
 
 lv_obj_t *needle_pitch_indicator_bar;
 lv_obj_t *center_target;
@@ -96,13 +100,18 @@ void needle_gui_init(lv_obj_t *screen) {
     needle_parent_screen = screen;
     needle_create_ruler(screen);
     needle_create_labels(screen);
+
+    tuner_label_stats_init(&needle_label_stats, needle_gui_get_name());
+    tuner_label_cache_init(&needle_frequency_cache, needle_frequency_label, 2, &needle_label_stats);
+    tuner_label_cache_init(&needle_cents_cache, needle_cents_label, 1, &needle_label_stats);
 }
 
 void needle_gui_display_frequency(float frequency, float target_frequency, TunerNoteName note_name, int octave, float cents, bool show_mute_indicator) {
     if (note_name < 0) { return; } // Strangely I'm sometimes seeing negative values. No idea how.
+    tuner_label_stats_frame(&needle_label_stats);
     if (note_name != NOTE_NONE) {
-        lv_label_set_text_fmt(needle_frequency_label, "%.2f", frequency);
-        lv_obj_clear_flag(needle_frequency_label, LV_OBJ_FLAG_HIDDEN);
+        tuner_label_cache_set_value(&needle_frequency_cache, frequency);
+        tuner_label_cache_set_hidden(&needle_frequency_cache, false);
 
         if (needle_last_displayed_note != note_name) {
             needle_update_note_name(note_name);
@@ -129,8 +138,8 @@ void needle_gui_display_frequency(float frequency, float target_frequency, Tuner
         // Make the two bars show up
         lv_obj_clear_flag(needle_pitch_indicator_bar, LV_OBJ_FLAG_HIDDEN);
 
-        lv_label_set_text_fmt(needle_cents_label, "%.1f", cents);
-        lv_obj_clear_flag(needle_cents_label, LV_OBJ_FLAG_HIDDEN);
+        tuner_label_cache_set_value(&needle_cents_cache, cents);
+        tuner_label_cache_set_hidden(&needle_cents_cache, false);
         lv_obj_clear_flag(center_target, LV_OBJ_FLAG_HIDDEN);
 
         lv_anim_start(&needle_pitch_animation);
@@ -142,8 +151,8 @@ void needle_gui_display_frequency(float frequency, float target_frequency, Tuner
         }
 
         // Hide the frequency and cents labels
-        lv_obj_add_flag(needle_cents_label, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_add_flag(needle_frequency_label, LV_OBJ_FLAG_HIDDEN);
+        tuner_label_cache_set_hidden(&needle_cents_cache, true);
+        tuner_label_cache_set_hidden(&needle_frequency_cache, true);
     }
 
     if (show_mute_indicator) {
@@ -20,6 +20,7 @@
 
 #include <stdlib.h>
 
+#include "tuner_ui_label_cache.h"
 #include "user_settings.h"
 
 #include "esp_log.h"
@@ -99,6 +100,9 @@ lv_obj_t *quiz_frequency_label;
 lv_style_t quiz_frequency_label_style;
 lv_obj_t *quiz_cents_label;
 lv_style_t quiz_cents_label_style;
+TunerLabelStats quiz_label_stats;
+TunerLabelCache quiz_frequency_cache;
+TunerLabelCache quiz_cents_cache;
 
 lv_obj_t *quiz_slider_container_left;
 lv_obj_t *quiz_slider_container_right;
@@ -127,6 +131,10 @@ void quiz_gui_init(lv_obj_t *screen) {
     quiz_parent_screen = screen;
     quiz_create_labels(screen);
 
+    tuner_label_stats_init(&quiz_label_stats, quiz_gui_get_name());
+    tuner_label_cache_init(&quiz_frequency_cache, quiz_frequency_label, 2, &quiz_label_stats);
+    tuner_label_cache_init(&quiz_cents_cache, quiz_cents_label, 1, &quiz_label_stats);
+
     quiz_current_target_note = NOTE_NONE;
     quiz_last_displayed_note = NOTE_NONE;
     quiz_upcoming_note = NOTE_NONE;
@@ -146,6 +154,7 @@ void quiz_gui_init(lv_obj_t *screen) {
 
 void quiz_gui_display_frequency(float frequency, float target_frequency, TunerNoteName note_name, int octave, float cents, bool show_mute_indicator) {
     if (note_name < 0) { return; } // Strangely I'm sometimes seeing negative values. No idea how.
+    tuner_label_stats_frame(&quiz_label_stats);
 
     if (quiz_current_target_note == NOTE_NONE) {
         // This will be called at the beginning of the quiz
@@ -153,8 +162,8 @@ void quiz_gui_display_frequency(float frequency, float target_frequency, TunerNo
     }
 
     if (note_name != NOTE_NONE) {
-        lv_label_set_text_fmt(quiz_frequency_label, "%.2f", frequency);
-        lv_obj_clear_flag(quiz_frequency_label, LV_OBJ_FLAG_HIDDEN);
+        tuner_label_cache_set_value(&quiz_frequency_cache, frequency);
+        tuner_label_cache_set_hidden(&quiz_frequency_cache, false);
         lv_obj_clear_flag(quiz_slider_container_left, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(quiz_slider_container_right, LV_OBJ_FLAG_HIDDEN);
 
@@ -164,8 +173,8 @@ void quiz_gui_display_frequency(float frequency, float target_frequency, TunerNo
             quiz_last_note_change_time_ms = esp_timer_get_time() / 1000; // milliseconds
         }
 
-        lv_label_set_text_fmt(quiz_cents_label, "%.1f", cents);
-        lv_obj_clear_flag(quiz_cents_label, LV_OBJ_FLAG_HIDDEN);
+        tuner_label_cache_set_value(&quiz_cents_cache, cents);
+        tuner_label_cache_set_hidden(&quiz_cents_cache, false);
 
         int64_t elapsed_time_ms = (esp_timer_get_time() / 1000) - quiz_last_note_change_time_ms;
 
@@ -195,8 +204,8 @@ void quiz_gui_display_frequency(float frequency, float target_frequency, TunerNo
         }
 
         // Hide the frequency, and cents labels
-        lv_obj_add_flag(quiz_cents_label, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_add_flag(quiz_frequency_label, LV_OBJ_FLAG_HIDDEN);
+        tuner_label_cache_set_hidden(&quiz_cents_cache, true);
+        tuner_label_cache_set_hidden(&quiz_frequency_cache, true);
         lv_obj_add_flag(quiz_slider_container_left, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(quiz_slider_container_right, LV_OBJ_FLAG_HIDDEN);
 
@@ -18,13 +18,18 @@
  */
 #include "tuner_ui_record_time.h"
 
+#include <inttypes.h>
+#include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "user_settings.h"
 
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 #include "esp_lvgl_port.h"
 #include "esp_random.h"
+#include "esp_timer.h"
 
 static const char *TAG = "RECORD_TIME";
 
@@ -47,6 +52,19 @@ static const char *TAG = "RECORD_TIME";
 #define RECORD_TIME_SLIDER_LINE_HEIGHT      7
 #define RECORD_TIME_RULER_LINE_HEIGHT       3
 
+#define RECORD_TIME_SPIN_DEGREES_PER_FRAME  25
+
+// The record title is pre-rendered at this many evenly spaced angles when the
+// UI is created so spinning it is a plain image blit instead of an LVGL
+// transform every frame. Spinning 25 degrees a frame only ever lands on
+// multiples of 5 degrees so 72 angles match every position exactly; fewer
+// angles save memory but the nearest angle will wobble. Each angle costs
+// w * h * 3 bytes of PSRAM (14.7 KB for the 70x70 titles, 1 MB for 72).
+// Set to 0 to rotate with an LVGL transform instead. The two haven't been
+// compared on the panel yet; TUNER_PROFILE_DISPLAY_FLUSH logs the refresh
+// time of each.
+#define RECORD_TIME_SPRITE_ANGLES           72
+
 extern UserSettings *userSettings;
 extern lv_coord_t screen_width;
 extern lv_coord_t screen_height;
@@ -87,6 +105,8 @@ void record_time_create_arm(lv_obj_t * parent);
 void record_time_create_slider(lv_obj_t * parent);
 void record_time_update_note_name(TunerNoteName new_value);
 void record_time_switch_to_none_note(lv_timer_t *timer);
+void record_time_create_sprites(lv_obj_t * parent);
+void record_time_free_sprites();
 
 //
 // Local Variables
@@ -130,6 +150,13 @@ lv_obj_t *record_time_title_img;
 float record_time_rotation_current_pos = 0;
 float record_time_amount_to_rotate = 0;
 
+#if RECORD_TIME_SPRITE_ANGLES > 0
+lv_image_dsc_t record_time_sprites[RECORD_TIME_SPRITE_ANGLES];
+#endif
+uint8_t *record_time_sprite_data = NULL; // One PSRAM block holding every angle
+int record_time_num_sprites = 0; // 0 if the sprites couldn't be created
+int record_time_current_sprite = 0;
+
 lv_anim_t *record_time_last_note_anim = NULL;
 
 uint8_t record_time_gui_get_id() {
@@ -181,7 +208,7 @@ void record_time_gui_display_frequency(float frequency, float target_frequency,
         //     lv_obj_clear_flag(record_time_cents_label, LV_OBJ_FLAG_HIDDEN);
         // }
 
-        record_time_amount_to_rotate = 25; // Keep spinning the record clockwise
+        record_time_amount_to_rotate = RECORD_TIME_SPIN_DEGREES_PER_FRAME; // Keep spinning the record clockwise
     } else {
         record_time_amount_to_rotate = 0.0;
         // Hide the pitch and indicators since it's not detected
@@ -197,6 +224,9 @@ void record_time_gui_display_frequency(float frequency, float target_frequency,
 
     if (record_time_amount_to_rotate != 0) {
         record_time_rotation_current_pos += record_time_amount_to_rotate;
+        if (record_time_rotation_current_pos >= 360) {
+            record_time_rotation_current_pos -= 360;
+        }
 
         // As the record "spins", simulate the record being warped a little by
         // shifting the arcs.
@@ -226,7 +256,15 @@ void record_time_gui_display_frequency(float frequency, float target_frequency,
         lv_obj_set_style_transform_angle(record_time_arm_img, arm_rotation * 10, 0);
 
         // Rotate the record title image
-        lv_obj_set_style_transform_angle(record_time_title_img, record_time_rotation_current_pos * 10, 0);
+        if (record_time_num_sprites > 0) {
+            int sprite = (int)lroundf(record_time_rotation_current_pos * record_time_num_sprites / 360.0f) % record_time_num_sprites;
+            if (sprite != record_time_current_sprite) {
+                record_time_current_sprite = sprite;
+                lv_image_set_src(record_time_title_img, &record_time_sprites[sprite]);
+            }
+        } else {
+            lv_obj_set_style_transform_angle(record_time_title_img, record_time_rotation_current_pos * 10, 0);
+        }
 
         // Move the slider to represent the frequency
         lv_obj_align_to(record_time_slider, record_time_slider_container, LV_ALIGN_CENTER, 0, cents * -1);
@@ -255,6 +293,8 @@ void record_time_gui_cleanup() {
         lv_timer_del(record_time_fade_timer);
         record_time_fade_timer = NULL;
     }
+
+    record_time_free_sprites();
 }
 
 void record_time_create_labels(lv_obj_t * parent) {
@@ -373,9 +413,16 @@ void record_time_create_record(lv_obj_t *parent) {
     lv_obj_align(center_dot, LV_ALIGN_CENTER, 0, 0);
 
 
+    record_time_create_sprites(parent);
+
     record_time_title_img = lv_image_create(record_time_record);
     // lv_image_set_src(record_time_title_img, &record_time_title_1);
-    lv_image_set_src(record_time_title_img, &record_time_title_src_img);
+    if (record_time_num_sprites > 0) {
+        record_time_current_sprite = (int)lroundf(record_time_rotation_current_pos * record_time_num_sprites / 360.0f) % record_time_num_sprites;
+        lv_image_set_src(record_time_title_img, &record_time_sprites[record_time_current_sprite]);
+    } else {
+        lv_image_set_src(record_time_title_img, &record_time_title_src_img);
+    }
     lv_obj_set_style_transform_pivot_x(record_time_title_img, 35, 0);
     lv_obj_set_style_transform_pivot_y(record_time_title_img, 35, 0);
     lv_obj_align(record_time_title_img, LV_ALIGN_CENTER, 0, 0);
@@ -591,4 +638,95 @@ void record_time_switch_to_none_note(lv_timer_t *timer) {
     
     // Keep the system happy and prevent a watchdog event
     lv_timer_handler();
- }
\ No newline at end of file
+ }
+
+void record_time_create_sprites(lv_obj_t * parent) {
+    record_time_free_sprites();
+#if RECORD_TIME_SPRITE_ANGLES > 0
+    const lv_image_dsc_t *src = &record_time_title_src_img;
+    uint32_t w = src->header.w;
+    uint32_t h = src->header.h;
+    uint32_t sprite_size = w * h * 3; // RGB565 plane followed by an A8 plane
+    record_time_sprite_data = (uint8_t *)heap_caps_malloc(sprite_size * RECORD_TIME_SPRITE_ANGLES, MALLOC_CAP_SPIRAM);
+    if (record_time_sprite_data == NULL) {
+        ESP_LOGW(TAG, "No PSRAM for %d sprites, rotating with transforms", RECORD_TIME_SPRITE_ANGLES);
+        return;
+    }
+
+    // LVGL can't render into RGB565A8 so rotate into an ARGB8888 scratch
+    // canvas and convert from there.
+    lv_draw_buf_t *scratch = lv_draw_buf_create(w, h, LV_COLOR_FORMAT_ARGB8888, LV_STRIDE_AUTO);
+    if (scratch == NULL) {
+        ESP_LOGW(TAG, "No memory for the sprite canvas, rotating with transforms");
+        record_time_free_sprites();
+        return;
+    }
+    lv_obj_t *canvas = lv_canvas_create(parent);
+    lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+    lv_canvas_set_draw_buf(canvas, scratch);
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < RECORD_TIME_SPRITE_ANGLES; i++) {
+        lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_TRANSP);
+
+        lv_layer_t layer;
+        lv_canvas_init_layer(canvas, &layer);
+        lv_draw_image_dsc_t image_dsc;
+        lv_draw_image_dsc_init(&image_dsc);
+        image_dsc.src = src;
+        image_dsc.rotation = i * 3600 / RECORD_TIME_SPRITE_ANGLES;
+        image_dsc.pivot.x = w / 2;
+        image_dsc.pivot.y = h / 2;
+        image_dsc.antialias = 1;
+        lv_area_t area = { 0, 0, (int32_t)w - 1, (int32_t)h - 1 };
+        lv_draw_image(&layer, &image_dsc, &area);
+        lv_canvas_finish_layer(canvas, &layer);
+
+        uint8_t *sprite = record_time_sprite_data + i * sprite_size;
+        uint16_t *rgb = (uint16_t *)sprite;
+        uint8_t *alpha = sprite + w * h * 2;
+        for (uint32_t y = 0; y < h; y++) {
+            const lv_color32_t *row = (const lv_color32_t *)(scratch->data + y * scratch->header.stride);
+            for (uint32_t x = 0; x < w; x++) {
+                rgb[y * w + x] = lv_color_to_u16(lv_color_make(row[x].red, row[x].green, row[x].blue));
+                alpha[y * w + x] = row[x].alpha;
+            }
+        }
+
+        lv_image_dsc_t *dsc = &record_time_sprites[i];
+        memset(dsc, 0, sizeof(lv_image_dsc_t));
+        dsc->header.magic = LV_IMAGE_HEADER_MAGIC;
+        dsc->header.cf = LV_COLOR_FORMAT_RGB565A8;
+        dsc->header.w = w;
+        dsc->header.h = h;
+        dsc->header.stride = w * 2;
+        dsc->data_size = sprite_size;
+        dsc->data = sprite;
+    }
+
+    lv_obj_delete(canvas);
+    lv_draw_buf_destroy(scratch);
+
+    record_time_num_sprites = RECORD_TIME_SPRITE_ANGLES;
+    ESP_LOGI(TAG, "Rendered %d sprites (%" PRIu32 " bytes) in %" PRId64 " ms", record_time_num_sprites,
+        sprite_size * RECORD_TIME_SPRITE_ANGLES, (esp_timer_get_time() - start) / 1000);
+#endif
+}
+
+void record_time_free_sprites() {
+    if (record_time_sprite_data == NULL) {
+        return;
+    }
+#if RECORD_TIME_SPRITE_ANGLES > 0
+    // Make sure nothing still points at the sprites once they're freed.
+    if (record_time_title_img != NULL && lv_obj_is_valid(record_time_title_img)) {
+        lv_image_set_src(record_time_title_img, &record_time_title_src_img);
+    }
+    for (int i = 0; i < record_time_num_sprites; i++) {
+        lv_image_cache_drop(&record_time_sprites[i]);
+    }
+#endif
+    heap_caps_free(record_time_sprite_data);
+    record_time_sprite_data = NULL;
+    record_time_num_sprites = 0;
+}
@@ -0,0 +1,446 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+//
+// A strobe that never redraws while it moves. LVGL draws a band of stripes
+// across the middle of the screen once and the stripes are moved by changing
+// the ST7789T's vertical scroll start address (VSCSAD, one 2-byte command),
+// so LVGL only redraws the band when its color or the note changes. How that
+// compares with the regular Strobe UI on the panel hasn't been measured yet
+// (TUNER_PROFILE_DISPLAY_FLUSH logs the flush and refresh times).
+//
+// Hardware scrolling only works along the panel's 320-pixel gate axis, so the
+// stripes move up/down in portrait and left/right in landscape. The band is
+// centered on that axis so it lands in the same place no matter how the
+// panel is mirrored for the current rotation.
+//
+#include "tuner_ui_scroll_strobe.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "tuner_ui_label_cache.h"
+#include "user_settings.h"
+#include "waveshare.h"
+#include "Vernon_ST7789T.h"
+
+#include "esp_log.h"
+#include "esp_lvgl_port.h"
+#include "esp_timer.h"
+
+static const char *TAG = "SCROLL_STROBE";
+
+// Length of the scrolling band along the gate axis.
+#define SCROLL_STROBE_BAND_LINES        80
+
+// Distance between the start of one stripe and the next. This must divide
+// SCROLL_STROBE_BAND_LINES evenly so the pattern looks identical at every
+// scroll offset (LVGL can then redraw any part of it without knowing where
+// the hardware has scrolled to).
+#define SCROLL_STROBE_STRIPE_PERIOD     16
+#define SCROLL_STROBE_STRIPE_WIDTH      8
+
+// First gate line of the scrolling band.
+#define SCROLL_STROBE_FIRST_LINE        ((ST7789T_GATE_LINES - SCROLL_STROBE_BAND_LINES) / 2)
+
+// How fast the stripes move for each cent out of tune.
+#define SCROLL_STROBE_LINES_PER_SEC_PER_CENT    2.0f
+
+// How often the scroll offset is recalculated (~ the panel refresh rate).
+#define SCROLL_STROBE_TIMER_PERIOD_MS   16
+
+// Don't let a stalled timer make the stripes jump.
+#define SCROLL_STROBE_MAX_STEP_US       100000
+
+#define SCROLL_STROBE_NUM_STRIPES       (SCROLL_STROBE_BAND_LINES / SCROLL_STROBE_STRIPE_PERIOD)
+
+static_assert(SCROLL_STROBE_BAND_LINES % SCROLL_STROBE_STRIPE_PERIOD == 0, "The stripe period must divide the band evenly");
+
+extern UserSettings *userSettings;
+extern lv_coord_t screen_width;
+extern lv_coord_t screen_height;
+extern bool is_landscape;
+
+LV_IMG_DECLARE(tuner_font_image_a)
+LV_IMG_DECLARE(tuner_font_image_b)
+LV_IMG_DECLARE(tuner_font_image_c)
+LV_IMG_DECLARE(tuner_font_image_d)
+LV_IMG_DECLARE(tuner_font_image_e)
+LV_IMG_DECLARE(tuner_font_image_f)
+LV_IMG_DECLARE(tuner_font_image_g)
+LV_IMG_DECLARE(tuner_font_image_none)
+LV_IMG_DECLARE(tuner_font_image_sharp)
+
+//
+// Function Definitions
+//
+void scroll_strobe_create_labels(lv_obj_t * parent);
+void scroll_strobe_create_band(lv_obj_t * parent);
+void scroll_strobe_update_note_name(TunerNoteName new_value);
+void scroll_strobe_set_stripe_color(lv_color_t color);
+void scroll_strobe_scroll_timer_cb(lv_timer_t *timer);
+void scroll_strobe_switch_to_none_note(lv_timer_t *timer);
+
+//
+// Local Variables
+//
+TunerNoteName scroll_strobe_last_displayed_note = NOTE_NONE;
+
+lv_obj_t *scroll_strobe_note_img;
+lv_obj_t *scroll_strobe_sharp_img;
+
+lv_obj_t *scroll_strobe_mute_label;
+lv_obj_t *scroll_strobe_frequency_label;
+lv_obj_t *scroll_strobe_cents_label;
+lv_style_t scroll_strobe_label_style;
+TunerLabelStats scroll_strobe_label_stats;
+TunerLabelCache scroll_strobe_frequency_cache;
+TunerLabelCache scroll_strobe_cents_cache;
+
+lv_obj_t *scroll_strobe_band;
+lv_obj_t *scroll_strobe_stripes[SCROLL_STROBE_NUM_STRIPES];
+
+lv_timer_t *scroll_strobe_scroll_timer = NULL;
+lv_timer_t *scroll_strobe_fade_timer = NULL;
+
+
+// -1 = not set yet, 0 = out of tune (white), 1 = in tune
+int scroll_strobe_in_tune_state = -1;
+
+// Read by the scroll timer. Both are only touched with the LVGL lock held.
+float scroll_strobe_lines_per_sec = 0.0f;
+float scroll_strobe_phase = 0.0f;
+uint16_t scroll_strobe_current_offset = 0;
+int64_t scroll_strobe_last_tick_us = 0;
+
+uint8_t scroll_strobe_gui_get_id() {
+    return 5;
+}
+
+const char * scroll_strobe_gui_get_name() {
+    return "Scroll Strobe";
+}
+
+void scroll_strobe_gui_init(lv_obj_t *screen) {
+    scroll_strobe_last_displayed_note = NOTE_NONE;
+    scroll_strobe_in_tune_state = -1;
+    scroll_strobe_lines_per_sec = 0.0f;
+    scroll_strobe_phase = 0.0f;
+    scroll_strobe_current_offset = 0;
+
+    scroll_strobe_create_band(screen);
+    scroll_strobe_create_labels(screen);
+
+    tuner_label_stats_init(&scroll_strobe_label_stats, scroll_strobe_gui_get_name());
+    tuner_label_cache_init(&scroll_strobe_frequency_cache, scroll_strobe_frequency_label, 2, &scroll_strobe_label_stats);
+    tuner_label_cache_init(&scroll_strobe_cents_cache, scroll_strobe_cents_label, 1, &scroll_strobe_label_stats);
+
+    if (lcd_display_scroll_area_set(SCROLL_STROBE_FIRST_LINE, SCROLL_STROBE_BAND_LINES) != ESP_OK
+        || lcd_display_scroll_offset_set(0) != ESP_OK) {
+        ESP_LOGE(TAG, "Could not set up hardware scrolling");
+    }
+
+    scroll_strobe_last_tick_us = esp_timer_get_time();
+    scroll_strobe_scroll_timer = lv_timer_create(scroll_strobe_scroll_timer_cb, SCROLL_STROBE_TIMER_PERIOD_MS, NULL);
+}
+
+void scroll_strobe_gui_display_frequency(float frequency, float target_frequency, TunerNoteName note_name, int octave, float cents, bool show_mute_indicator) {
+    if (note_name < 0) { return; } // Strangely I'm sometimes seeing negative values. No idea how.
+    tuner_label_stats_frame(&scroll_strobe_label_stats);
+    if (note_name != NOTE_NONE) {
+        tuner_label_cache_set_value(&scroll_strobe_frequency_cache, frequency);
+        tuner_label_cache_set_hidden(&scroll_strobe_frequency_cache, false);
+
+        if (scroll_strobe_last_displayed_note != note_name) {
+            scroll_strobe_update_note_name(note_name);
+            scroll_strobe_last_displayed_note = note_name;
+        }
+
+        tuner_label_cache_set_value(&scroll_strobe_cents_cache, cents);
+        tuner_label_cache_set_hidden(&scroll_strobe_cents_cache, false);
+
+        if (lv_obj_has_flag(scroll_strobe_band, LV_OBJ_FLAG_HIDDEN)) {
+            lv_obj_clear_flag(scroll_strobe_band, LV_OBJ_FLAG_HIDDEN);
+        }
+
+        // Only recolor the stripes when crossing in or out of the in-tune
+        // range. Recoloring is the only thing that makes LVGL redraw them.
+        int in_tune_state = fabsf(cents) <= userSettings->inTuneCentsWidth ? 1 : 0;
+        if (in_tune_state != scroll_strobe_in_tune_state) {
+            if (in_tune_state) {
+                lv_palette_t palette = userSettings->noteNamePalette;
+                scroll_strobe_set_stripe_color(lv_palette_main(palette == LV_PALETTE_NONE ? LV_PALETTE_BLUE : palette));
+            } else {
+                scroll_strobe_set_stripe_color(lv_color_white());
+            }
+            scroll_strobe_in_tune_state = in_tune_state;
+        }
+
+        scroll_strobe_lines_per_sec = cents * SCROLL_STROBE_LINES_PER_SEC_PER_CENT;
+    } else {
+        scroll_strobe_lines_per_sec = 0.0f;
+        if (scroll_strobe_last_displayed_note != NOTE_NONE) {
+            scroll_strobe_update_note_name(NOTE_NONE);
+            scroll_strobe_last_displayed_note = NOTE_NONE;
+        }
+
+        // Hide the frequency, and cents labels
+        tuner_label_cache_set_hidden(&scroll_strobe_cents_cache, true);
+        tuner_label_cache_set_hidden(&scroll_strobe_frequency_cache, true);
+    }
+
+    if (show_mute_indicator) {
+        lv_obj_clear_flag(scroll_strobe_mute_label, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(scroll_strobe_mute_label, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+void scroll_strobe_gui_cleanup() {
+    if (scroll_strobe_scroll_timer != NULL) {
+        lv_timer_del(scroll_strobe_scroll_timer);
+        scroll_strobe_scroll_timer = NULL;
+    }
+    if (scroll_strobe_fade_timer != NULL) {
+        lv_timer_del(scroll_strobe_fade_timer);
+        scroll_strobe_fade_timer = NULL;
+    }
+
+    // The next UI expects an unscrolled panel.
+    if (lcd_display_scroll_reset() != ESP_OK) {
+        ESP_LOGE(TAG, "Could not turn off hardware scrolling");
+    }
+}
+
+void scroll_strobe_create_band(lv_obj_t * parent) {
+    scroll_strobe_band = lv_obj_create(parent);
+    lv_obj_remove_style_all(scroll_strobe_band);
+    lv_obj_set_style_bg_color(scroll_strobe_band, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(scroll_strobe_band, LV_OPA_COVER, 0);
+    lv_obj_set_scrollbar_mode(scroll_strobe_band, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_set_scroll_dir(scroll_strobe_band, LV_DIR_NONE);
+    lv_obj_remove_flag(scroll_strobe_band, LV_OBJ_FLAG_CLICKABLE);
+
+    // The gate axis is logical y in portrait and logical x in landscape.
+    if (is_landscape) {
+        lv_obj_set_size(scroll_strobe_band, SCROLL_STROBE_BAND_LINES, screen_height);
+    } else {
+        lv_obj_set_size(scroll_strobe_band, screen_width, SCROLL_STROBE_BAND_LINES);
+    }
+    lv_obj_align(scroll_strobe_band, LV_ALIGN_CENTER, 0, 0);
+
+    for (int i = 0; i < SCROLL_STROBE_NUM_STRIPES; i++) {
+        lv_obj_t *stripe = lv_obj_create(scroll_strobe_band);
+        lv_obj_remove_style_all(stripe);
+        lv_obj_set_style_bg_color(stripe, lv_color_white(), 0);
+        lv_obj_set_style_bg_opa(stripe, LV_OPA_COVER, 0);
+        lv_obj_remove_flag(stripe, LV_OBJ_FLAG_CLICKABLE);
+        if (is_landscape) {
+            lv_obj_set_size(stripe, SCROLL_STROBE_STRIPE_WIDTH, lv_pct(100));
+            lv_obj_set_pos(stripe, i * SCROLL_STROBE_STRIPE_PERIOD, 0);
+        } else {
+            lv_obj_set_size(stripe, lv_pct(100), SCROLL_STROBE_STRIPE_WIDTH);
+            lv_obj_set_pos(stripe, 0, i * SCROLL_STROBE_STRIPE_PERIOD);
+        }
+        scroll_strobe_stripes[i] = stripe;
+    }
+
+    lv_obj_add_flag(scroll_strobe_band, LV_OBJ_FLAG_HIDDEN);
+}
+
+void scroll_strobe_create_labels(lv_obj_t * parent) {
+    // Everything here has to stay outside of the scrolling band or it would
+    // scroll along with the stripes. The note goes before the band and the
+    // labels after it.
+    lv_coord_t outside_band = (ST7789T_GATE_LINES - SCROLL_STROBE_BAND_LINES) / 2;
+
+    scroll_strobe_note_img = lv_image_create(parent);
+    lv_image_set_src(scroll_strobe_note_img, &tuner_font_image_none);
+
+    scroll_strobe_sharp_img = lv_image_create(parent);
+    lv_image_set_src(scroll_strobe_sharp_img, &tuner_font_image_sharp);
+    lv_obj_add_flag(scroll_strobe_sharp_img, LV_OBJ_FLAG_HIDDEN);
+
+    if (is_landscape) {
+        lv_obj_align(scroll_strobe_note_img, LV_ALIGN_LEFT_MID, 8, 0);
+        lv_obj_align_to(scroll_strobe_sharp_img, scroll_strobe_note_img, LV_ALIGN_OUT_TOP_RIGHT, 0, 0);
+    } else {
+        lv_obj_align(scroll_strobe_note_img, LV_ALIGN_TOP_MID, 0, 8);
+        lv_obj_align_to(scroll_strobe_sharp_img, scroll_strobe_note_img, LV_ALIGN_OUT_RIGHT_TOP, 0, 0);
+    }
+
+    // Enable recoloring on the images
+    lv_obj_set_style_img_recolor_opa(scroll_strobe_note_img, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_img_recolor_opa(scroll_strobe_sharp_img, LV_OPA_COVER, LV_PART_MAIN);
+    lv_palette_t palette = userSettings->noteNamePalette;
+    lv_color_t note_color = palette == LV_PALETTE_NONE ? lv_color_white() : lv_palette_main(palette);
+    lv_obj_set_style_img_recolor(scroll_strobe_note_img, note_color, 0);
+    lv_obj_set_style_img_recolor(scroll_strobe_sharp_img, note_color, 0);
+
+    lv_style_init(&scroll_strobe_label_style);
+    lv_style_set_text_font(&scroll_strobe_label_style, &lv_font_montserrat_18);
+
+    // MUTE label (for monitoring mode)
+    scroll_strobe_mute_label = lv_label_create(parent);
+    lv_label_set_text_static(scroll_strobe_mute_label, "MUTE");
+    lv_obj_add_style(scroll_strobe_mute_label, &scroll_strobe_label_style, 0);
+    lv_obj_align(scroll_strobe_mute_label, LV_ALIGN_TOP_LEFT, 2, 0);
+    lv_obj_add_flag(scroll_strobe_mute_label, LV_OBJ_FLAG_HIDDEN);
+
+    // Frequency Label
+    scroll_strobe_frequency_label = lv_label_create(parent);
+    lv_label_set_long_mode(scroll_strobe_frequency_label, LV_LABEL_LONG_CLIP);
+    lv_label_set_text_static(scroll_strobe_frequency_label, "-");
+    lv_obj_add_style(scroll_strobe_frequency_label, &scroll_strobe_label_style, 0);
+    lv_obj_set_style_text_align(scroll_strobe_frequency_label, LV_TEXT_ALIGN_RIGHT, 0);
+    lv_obj_add_flag(scroll_strobe_frequency_label, LV_OBJ_FLAG_HIDDEN);
+
+    // Cents display
+    scroll_strobe_cents_label = lv_label_create(parent);
+    lv_obj_add_style(scroll_strobe_cents_label, &scroll_strobe_label_style, 0);
+    lv_obj_set_style_text_align(scroll_strobe_cents_label, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_add_flag(scroll_strobe_cents_label, LV_OBJ_FLAG_HIDDEN);
+
+    if (is_landscape) {
+        // Stack both labels in the area to the right of the band
+        lv_obj_set_width(scroll_strobe_frequency_label, outside_band - 4);
+        lv_obj_set_width(scroll_strobe_cents_label, outside_band - 4);
+        lv_obj_align(scroll_strobe_cents_label, LV_ALIGN_RIGHT_MID, -2, 0);
+        lv_obj_align(scroll_strobe_frequency_label, LV_ALIGN_BOTTOM_RIGHT, -2, -2);
+    } else {
+        lv_obj_set_width(scroll_strobe_frequency_label, screen_width / 2);
+        lv_obj_set_width(scroll_strobe_cents_label, screen_width / 2);
+        lv_obj_align(scroll_strobe_cents_label, LV_ALIGN_BOTTOM_LEFT, 2, -2);
+        lv_obj_align(scroll_strobe_frequency_label, LV_ALIGN_BOTTOM_RIGHT, -2, -2);
+    }
+}
+
+void scroll_strobe_set_stripe_color(lv_color_t color) {
+    for (int i = 0; i < SCROLL_STROBE_NUM_STRIPES; i++) {
+        lv_obj_set_style_bg_color(scroll_strobe_stripes[i], color, 0);
+    }
+}
+
+/// @brief Moves the stripes by changing the panel's scroll offset. Runs from
+/// `lv_timer_handler()` so the LVGL lock is already held.
+void scroll_strobe_scroll_timer_cb(lv_timer_t *timer) {
+    int64_t now = esp_timer_get_time();
+    int64_t elapsed_us = now - scroll_strobe_last_tick_us;
+    scroll_strobe_last_tick_us = now;
+    if (elapsed_us > SCROLL_STROBE_MAX_STEP_US) {
+        elapsed_us = SCROLL_STROBE_MAX_STEP_US;
+    }
+    if (scroll_strobe_lines_per_sec == 0.0f) {
+        return;
+    }
+
+    // The panel is mirrored for 180 and 270 so flip the direction to keep
+    // sharp moving the same way on screen.
+    lv_display_rotation_t rotation = lcd_display_get_rotation();
+    float direction = (rotation == LV_DISPLAY_ROTATION_180 || rotation == LV_DISPLAY_ROTATION_270) ? -1.0f : 1.0f;
+
+    // Only the phase within one stripe period matters since the pattern
+    // repeats.
+    scroll_strobe_phase += direction * scroll_strobe_lines_per_sec * elapsed_us / 1000000.0f;
+    scroll_strobe_phase = fmodf(scroll_strobe_phase, SCROLL_STROBE_STRIPE_PERIOD);
+    if (scroll_strobe_phase < 0) {
+        scroll_strobe_phase += SCROLL_STROBE_STRIPE_PERIOD;
+    }
+
+    uint16_t offset = (uint16_t)scroll_strobe_phase;
+    if (offset != scroll_strobe_current_offset) {
+        lcd_display_scroll_offset_set(offset);
+        scroll_strobe_current_offset = offset;
+    }
+}
+
+void scroll_strobe_update_note_name(TunerNoteName new_value) {
+    const lv_image_dsc_t *img_desc;
+    bool show_sharp_symbol = false;
+    bool show_note_fade_anim = false;
+    switch (new_value) {
+    case NOTE_A_SHARP:
+        show_sharp_symbol = true;
+    case NOTE_A:
+        img_desc = &tuner_font_image_a;
+        break;
+    case NOTE_B:
+        img_desc = &tuner_font_image_b;
+        break;
+    case NOTE_C_SHARP:
+        show_sharp_symbol = true;
+    case NOTE_C:
+        img_desc = &tuner_font_image_c;
+        break;
+    case NOTE_D_SHARP:
+        show_sharp_symbol = true;
+    case NOTE_D:
+        img_desc = &tuner_font_image_d;
+        break;
+    case NOTE_E:
+        img_desc = &tuner_font_image_e;
+        break;
+    case NOTE_F_SHARP:
+        show_sharp_symbol = true;
+    case NOTE_F:
+        img_desc = &tuner_font_image_f;
+        break;
+    case NOTE_G_SHARP:
+        show_sharp_symbol = true;
+    case NOTE_G:
+        img_desc = &tuner_font_image_g;
+        break;
+    case NOTE_NONE:
+        show_note_fade_anim = true;
+        break;
+    default:
+        return;
+    }
+    if (scroll_strobe_fade_timer != NULL) {
+        lv_timer_del(scroll_strobe_fade_timer);
+        scroll_strobe_fade_timer = NULL;
+    }
+
+    if (show_note_fade_anim) {
+        scroll_strobe_fade_timer = lv_timer_create(scroll_strobe_switch_to_none_note, 2000, NULL);
+        lv_obj_add_flag(scroll_strobe_band, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        if (show_sharp_symbol) {
+            lv_obj_clear_flag(scroll_strobe_sharp_img, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(scroll_strobe_sharp_img, LV_OBJ_FLAG_HIDDEN);
+        }
+
+        lv_image_set_src(scroll_strobe_note_img, img_desc);
+    }
+}
+
+void scroll_strobe_switch_to_none_note(lv_timer_t *timer) {
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
+
+    lv_timer_del(scroll_strobe_fade_timer);
+    scroll_strobe_fade_timer = NULL;
+
+    lv_image_set_src(scroll_strobe_note_img, &tuner_font_image_none);
+    lv_obj_add_flag(scroll_strobe_sharp_img, LV_OBJ_FLAG_HIDDEN);
+
+    lvgl_port_unlock();
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_SCROLL_STROBE_GUI)
+#define TUNER_SCROLL_STROBE_GUI
+
+#include "lvgl.h"
+#include "defines.h"
+
+uint8_t scroll_strobe_gui_get_id();
+const char * scroll_strobe_gui_get_name();
+void scroll_strobe_gui_init(lv_obj_t *screen);
+void scroll_strobe_gui_display_frequency(float frequency, float target_frequency, TunerNoteName note_name, int octave, float cents, bool show_mute_indicator);
+void scroll_strobe_gui_cleanup();
+
+#endif
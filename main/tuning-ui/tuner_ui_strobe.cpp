@@ -20,6 +20,7 @@
 
 #include <stdlib.h>
 
+#include "tuner_ui_label_cache.h"
 #include "user_settings.h"
 
 #include "esp_log.h"
@@ -74,6 +75,9 @@ lv_obj_t *strobe_frequency_label;
 lv_style_t strobe_frequency_label_style;
 lv_obj_t *strobe_cents_label;
 lv_style_t strobe_cents_label_style;
+TunerLabelStats strobe_label_stats;
+TunerLabelCache strobe_frequency_cache;
+TunerLabelCache strobe_cents_cache;
 
 lv_obj_t *strobe_arc_container;
 lv_obj_t *strobe_arc1;
@@ -97,22 +101,19 @@ const char * strobe_gui_get_name() {
 void strobe_gui_init(lv_obj_t *screen) {
     strobe_parent_screen = screen;
     strobe_create_labels(screen);
+
+    tuner_label_stats_init(&strobe_label_stats, strobe_gui_get_name());
+    tuner_label_cache_init(&strobe_frequency_cache, strobe_frequency_label, 2, &strobe_label_stats);
+    tuner_label_cache_init(&strobe_cents_cache, strobe_cents_label, 1, &strobe_label_stats);
     strobe_create_arcs(screen);
 }
 
-float strobe_last_frequency = 0.0;
-float strobe_last_cents = 0.0;
-
 void strobe_gui_display_frequency(float frequency, float target_frequency, TunerNoteName note_name, int octave, float cents, bool show_mute_indicator) {
     if (note_name < 0) { return; } // Strangely I'm sometimes seeing negative values. No idea how.
+    tuner_label_stats_frame(&strobe_label_stats);
     if (note_name != NOTE_NONE) {
-        if (strobe_last_frequency != frequency) {
-            lv_label_set_text_fmt(strobe_frequency_label, "%.2f", frequency);
-            strobe_last_frequency = frequency;
-        }
-        if (lv_obj_has_flag(strobe_frequency_label, LV_OBJ_FLAG_HIDDEN)) {
-            lv_obj_clear_flag(strobe_frequency_label, LV_OBJ_FLAG_HIDDEN);
-        }
+        tuner_label_cache_set_value(&strobe_frequency_cache, frequency);
+        tuner_label_cache_set_hidden(&strobe_frequency_cache, false);
 
         if (strobe_last_displayed_note != note_name) {
             strobe_update_note_name(note_name);
@@ -124,13 +125,8 @@ void strobe_gui_display_frequency(float frequency, float target_frequency, Tuner
             lv_obj_clear_flag(strobe_arc_container, LV_OBJ_FLAG_HIDDEN);
         }
 
-        if (strobe_last_cents != cents) {
-            lv_label_set_text_fmt(strobe_cents_label, "%.1f", cents);
-            strobe_last_cents = cents;
-        }
-        if (lv_obj_has_flag(strobe_cents_label, LV_OBJ_FLAG_HIDDEN)) {
-            lv_obj_clear_flag(strobe_cents_label, LV_OBJ_FLAG_HIDDEN);
-        }
+        tuner_label_cache_set_value(&strobe_cents_cache, cents);
+        tuner_label_cache_set_hidden(&strobe_cents_cache, false);
 
         if (lv_obj_has_flag(strobe_arc_container, LV_OBJ_FLAG_HIDDEN)) {
             lv_obj_clear_flag(strobe_arc_container, LV_OBJ_FLAG_HIDDEN);
@@ -167,8 +163,8 @@ void strobe_gui_display_frequency(float frequency, float target_frequency, Tuner
         }
 
         // Hide the frequency, and cents labels
-        lv_obj_add_flag(strobe_cents_label, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_add_flag(strobe_frequency_label, LV_OBJ_FLAG_HIDDEN);
+        tuner_label_cache_set_hidden(&strobe_cents_cache, true);
+        tuner_label_cache_set_hidden(&strobe_frequency_cache, true);
     }
 
     if (strobe_amount_to_rotate != 0) {
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_TUNING_PRESETS)
+#define TUNER_TUNING_PRESETS
+
+#include <cstddef>
+#include <cstdint>
+
+/// @brief Most strings a tuning preset can have.
+#define TUNING_PRESET_MAX_STRINGS   6
+
+/// @brief The tunings the tuner can be locked to. This is the index into
+/// `tuning_presets` and it is stored in NVS, so only ever add new presets
+/// right before `tuningPresetCount`.
+typedef enum : uint8_t {
+    tuningPresetOff = 0,
+    tuningPresetStandard,
+    tuningPresetDropD,
+    tuningPresetDADGAD,
+    tuningPresetBass5,
+    tuningPresetCount,
+} TunerTuningPreset;
+
+/// @brief The strings of a tuning, lowest first.
+///
+/// With a preset picked the tuner only listens for these strings (see
+/// main/utils/TuningBank.hpp) instead of searching the whole chromatic range.
+typedef struct {
+    const char  *name;
+    size_t      numStrings;                             // 0 for chromatic
+    uint8_t     midiNotes[TUNING_PRESET_MAX_STRINGS];   // MIDI note numbers (A4 = 69)
+} TuningPreset;
+
+static constexpr TuningPreset tuning_presets[tuningPresetCount] = {
+    { "Off (Chromatic)",    0,  {} },
+    // E2 A2 D3 G3 B3 E4
+    { "Standard",           6,  { 40, 45, 50, 55, 59, 64 } },
+    // D2 A2 D3 G3 B3 E4
+    { "Drop D",             6,  { 38, 45, 50, 55, 59, 64 } },
+    // D2 A2 D3 G3 A3 D4
+    { "DADGAD",             6,  { 38, 45, 50, 55, 57, 62 } },
+    // B0 E1 A1 D2 G2
+    { "Bass (5-String)",    5,  { 23, 28, 33, 38, 43 } },
+};
+
+/// @brief Returns the preset for `preset` (Off if it's out of range).
+inline const TuningPreset &tuning_preset(TunerTuningPreset preset) {
+    return tuning_presets[preset < tuningPresetCount ? preset : tuningPresetOff];
+}
+
+#endif
@@ -18,9 +18,11 @@
  */
 #include "user_settings.h"
 
+#include "gpio_task.h"
 #include "tuner_controller.h"
 #include "tuner_ui_interface.h"
 #include "waveshare.h"
+#include "latency_trace.h"
 
 static const char *TAG = "Settings";
 
@@ -36,6 +38,8 @@ extern UserSettings *userSettings;
 #endif
 
 #define MENU_BTN_TUNER              "Tuner"
+    #define MENU_BTN_INSTRUMENT         "Instrument"
+    #define MENU_BTN_TUNING_PRESET      "Tuning Preset"
     #define MENU_BTN_TUNER_MODE         "Mode"
     #define MENU_BTN_IN_TUNE_THRESHOLD  "In-Tune Threshold"
     #define MENU_BTN_BYPASS_TYPE        "Bypass Type"
@@ -63,6 +67,9 @@ extern UserSettings *userSettings;
 #define MENU_BTN_1EU_FLTR_1ST       "1 EU 1st?"
 #define MENU_BTN_MOVING_AVG         "Moving Average"
 #define MENU_BTN_NAME_DEBOUNCING    "Name Debouncing"
+#define MENU_BTN_LATENCY            "Latency"
+    #define MENU_BTN_LOG_LATENCY        "Log to Serial"
+    #define MENU_BTN_RESET_LATENCY      "Reset"
 
 #define MENU_BTN_ABOUT              "About"
     #define MENU_BTN_FACTORY_RESET      "Factory Reset"
@@ -85,11 +92,15 @@ extern UserSettings *userSettings;
 #define SETTING_KEY_USE_1EU_FILTER_FIRST    "oneEUFilter1st"
 // #define SETTING_KEY_MOVING_AVG_WINDOW_SIZE  "movingAvgWindow"
 #define SETTING_KEY_DISPLAY_BRIGHTNESS      "dsp_brightness"
+#define SETTING_KEY_INSTRUMENT              "instrument"
+#define SETTING_KEY_TUNING_PRESET           "tuning_preset"
 
 /*
 
 SETTINGS
     Tuning
+        [x] Instrument
+        [x] Tuning Preset
         [X] In Tune Width
         [x] Back - returns to the main menu
 
@@ -104,6 +115,7 @@ SETTINGS
         [x] 1EU Beta
         [x] Note Debouncing
         [x] Moving Average Window Size
+        [x] Latency (only with TUNER_PROFILE_LATENCY)
         [x] Back - returns to the main menu
 
     About
@@ -120,6 +132,10 @@ SETTINGS
 // Function Declarations
 //
 static void handleTunerButtonClicked(lv_event_t *e);
+static void handleInstrumentButtonClicked(lv_event_t *e);
+static void handleInstrumentSelected(lv_event_t *e);
+static void handleTuningPresetButtonClicked(lv_event_t *e);
+static void handleTuningPresetSelected(lv_event_t *e);
 static void handleTunerModeButtonClicked(lv_event_t *e);
 static void handleTunerModeSelected(lv_event_t *e);
 static void handleInTuneThresholdButtonClicked(lv_event_t *e);
@@ -152,6 +168,11 @@ static void handle1EUBetaButtonClicked(lv_event_t *e);
 static void handle1EUFilterFirstButtonClicked(lv_event_t *e);
 // static void handleMovingAvgButtonClicked(lv_event_t *e);
 static void handleNameDebouncingButtonClicked(lv_event_t *e);
+#if TUNER_PROFILE_LATENCY
+static void handleLatencyButtonClicked(lv_event_t *e);
+static void handleLogLatencyButtonClicked(lv_event_t *e);
+static void handleResetLatencyButtonClicked(lv_event_t *e);
+#endif
 
 static void handleAboutButtonClicked(lv_event_t *e);
 static void handleFactoryResetButtonClicked(lv_event_t *e);
@@ -190,6 +211,7 @@ void UserSettings::loadSettings() {
     // Set the initial value in the queue so gpio_task will set the relay in
     // the correct state.
     xQueueOverwrite(bypassTypeQueue, &bypassType);
+    gpio_relay_settings_changed();
 
     if (nvs_get_u8(nvsHandle, SETTING_STANDBY_GUI_INDEX, &value) == ESP_OK) {
         standbyGUIIndex = value;
@@ -219,6 +241,20 @@ void UserSettings::loadSettings() {
     }
     ESP_LOGI(TAG, "Monitoring Mode: %d", monitoringMode);
 
+    if (nvs_get_u8(nvsHandle, SETTING_KEY_INSTRUMENT, &value) == ESP_OK && value < instrumentCount) {
+        instrument = (TunerInstrument)value;
+    } else {
+        instrument = DEFAULT_INSTRUMENT;
+    }
+    ESP_LOGI(TAG, "Instrument: %s", instrument_profile(instrument).name);
+
+    if (nvs_get_u8(nvsHandle, SETTING_KEY_TUNING_PRESET, &value) == ESP_OK && value < tuningPresetCount) {
+        tuningPreset = (TunerTuningPreset)value;
+    } else {
+        tuningPreset = DEFAULT_TUNING_PRESET;
+    }
+    ESP_LOGI(TAG, "Tuning Preset: %s", tuning_preset(tuningPreset).name);
+
     if (nvs_get_u8(nvsHandle, SETTING_KEY_NOTE_NAME_PALETTE, &value) == ESP_OK) {
         noteNamePalette = (lv_palette_t)value;
     } else {
@@ -349,6 +385,14 @@ void UserSettings::saveSettings() {
     ESP_LOGI(TAG, "Monitoring Mode: %d", value);
     nvs_set_u8(nvsHandle, SETTING_KEY_MONITORING_MODE, value);
 
+    value = (uint8_t)instrument;
+    ESP_LOGI(TAG, "Instrument: %d", value);
+    nvs_set_u8(nvsHandle, SETTING_KEY_INSTRUMENT, value);
+
+    value = (uint8_t)tuningPreset;
+    ESP_LOGI(TAG, "Tuning Preset: %d", value);
+    nvs_set_u8(nvsHandle, SETTING_KEY_TUNING_PRESET, value);
+
     value = (uint8_t)noteNamePalette;
     ESP_LOGI(TAG, "Note Name Palette: %d", value);
     nvs_set_u8(nvsHandle, SETTING_KEY_NOTE_NAME_PALETTE, value);
@@ -387,6 +431,8 @@ void UserSettings::restoreDefaultSettings() {
     standbyGUIIndex = DEFAULT_STANDBY_GUI_INDEX;
     tunerGUIIndex = DEFAULT_TUNER_GUI_INDEX;
     inTuneCentsWidth = DEFAULT_IN_TUNE_CENTS_WIDTH;
+    instrument = DEFAULT_INSTRUMENT;
+    tuningPreset = DEFAULT_TUNING_PRESET;
     noteNamePalette = DEFAULT_NOTE_NAME_PALETTE;
     displayOrientation = DEFAULT_DISPLAY_ORIENTATION;
     expSmoothing = DEFAULT_EXP_SMOOTHING;
@@ -609,6 +655,7 @@ void UserSettings::removeCurrentMenu() {
     // settings screen).
     bool bypassTypeSettingsScreen = false;
     xQueueOverwrite(bypassTypeSettingsScreenQeuue, &bypassTypeSettingsScreen);
+    gpio_relay_settings_changed();
 }
 
 void UserSettings::createSlider(const char *sliderName, int32_t minRange, int32_t maxRange, lv_event_cb_t sliderCallback, float *sliderValue) {
@@ -897,7 +944,7 @@ void UserSettings::rotateScreenTo(TunerOrientation newRotation) {
         break;
     }
 
-    if (lv_display_get_rotation(lvglDisplay) != new_rotation) {
+    if (lcd_display_get_rotation() != new_rotation) {
         ESP_ERROR_CHECK(lcd_display_rotate(lvglDisplay, new_rotation));
 
         // Save this off into user preferences.
@@ -921,18 +968,121 @@ static void handleTunerButtonClicked(lv_event_t *e) {
     }
     lvgl_port_unlock();
     const char *buttonNames[] = {
+        MENU_BTN_INSTRUMENT,
+        MENU_BTN_TUNING_PRESET,
         MENU_BTN_TUNER_MODE,
         MENU_BTN_IN_TUNE_THRESHOLD,
         MENU_BTN_BYPASS_TYPE,
         MENU_BTN_MONITORING_MODE,
     };
     lv_event_cb_t callbackFunctions[] = {
+        handleInstrumentButtonClicked,
+        handleTuningPresetButtonClicked,
         handleTunerModeButtonClicked,
         handleInTuneThresholdButtonClicked,
         handleBypassTypeButtonClicked,
         handleMonitoringModeButtonClicked,
     };
-    userSettings->createMenu(buttonNames, NULL, NULL, callbackFunctions, 4);    
+    userSettings->createMenu(buttonNames, NULL, NULL, callbackFunctions, 6);    
+}
+
+static void handleInstrumentButtonClicked(lv_event_t *e) {
+    ESP_LOGI(TAG, "Instrument button clicked");
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
+    lvgl_port_unlock();
+
+    const char *buttonNames[instrumentCount];
+    for (int i = 0; i < instrumentCount; i++) {
+        buttonNames[i] = instrument_profiles[i].name;
+    }
+
+    userSettings->createRadioList((const char *)MENU_BTN_INSTRUMENT, 
+                               buttonNames,
+                               instrumentCount,
+                               NULL,
+                               handleInstrumentSelected,
+                               (uint8_t *)&userSettings->instrument,
+                               0); // a 0-based setting
+}
+
+static void handleInstrumentSelected(lv_event_t *e) {
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
+
+    uint8_t *instrumentSetting = (uint8_t *)lv_event_get_user_data(e);
+    int32_t radioIndex = ((int32_t)*instrumentSetting);
+
+    lv_obj_t * cont = (lv_obj_t *)lv_event_get_current_target(e);
+    lv_obj_t * act_cb = (lv_obj_t *)lv_event_get_target(e);
+    lv_obj_t * old_cb = (lv_obj_t *)lv_obj_get_child(cont, radioIndex);
+
+    // Do nothing if the container was clicked
+    if(act_cb == cont) {
+        lvgl_port_unlock();
+        return;
+    }
+
+    lv_obj_remove_state(old_cb, LV_STATE_CHECKED);   // Uncheck the previous radio button
+    lv_obj_add_state(act_cb, LV_STATE_CHECKED);     // Uncheck the current radio button
+
+    // The ADC ingest task picks this up and switches the ADC and the pitch
+    // detector over to the new profile.
+    *instrumentSetting = lv_obj_get_index(act_cb);
+    ESP_LOGI(TAG, "New Instrument setting: %s", instrument_profile((TunerInstrument)*instrumentSetting).name);
+
+    lvgl_port_unlock();
+}
+
+static void handleTuningPresetButtonClicked(lv_event_t *e) {
+    ESP_LOGI(TAG, "Tuning preset button clicked");
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
+    lvgl_port_unlock();
+
+    const char *buttonNames[tuningPresetCount];
+    for (int i = 0; i < tuningPresetCount; i++) {
+        buttonNames[i] = tuning_presets[i].name;
+    }
+
+    userSettings->createRadioList((const char *)MENU_BTN_TUNING_PRESET, 
+                               buttonNames,
+                               tuningPresetCount,
+                               NULL,
+                               handleTuningPresetSelected,
+                               (uint8_t *)&userSettings->tuningPreset,
+                               0); // a 0-based setting
+}
+
+static void handleTuningPresetSelected(lv_event_t *e) {
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
+
+    uint8_t *presetSetting = (uint8_t *)lv_event_get_user_data(e);
+    int32_t radioIndex = ((int32_t)*presetSetting);
+
+    lv_obj_t * cont = (lv_obj_t *)lv_event_get_current_target(e);
+    lv_obj_t * act_cb = (lv_obj_t *)lv_event_get_target(e);
+    lv_obj_t * old_cb = (lv_obj_t *)lv_obj_get_child(cont, radioIndex);
+
+    // Do nothing if the container was clicked
+    if(act_cb == cont) {
+        lvgl_port_unlock();
+        return;
+    }
+
+    lv_obj_remove_state(old_cb, LV_STATE_CHECKED);   // Uncheck the previous radio button
+    lv_obj_add_state(act_cb, LV_STATE_CHECKED);     // Uncheck the current radio button
+
+    // The pitch detector task picks this up and rebuilds its chain.
+    *presetSetting = lv_obj_get_index(act_cb);
+    ESP_LOGI(TAG, "New Tuning Preset setting: %s", tuning_preset((TunerTuningPreset)*presetSetting).name);
+
+    lvgl_port_unlock();
 }
 
 static void handleTunerModeButtonClicked(lv_event_t *e) {
@@ -1022,6 +1172,7 @@ static void handleBypassTypeButtonClicked(lv_event_t *e) {
     // tuner can unmute in gpio_task.
     bool bypassTypeSettingsScreen = true;
     xQueueOverwrite(bypassTypeSettingsScreenQeuue, &bypassTypeSettingsScreen);
+    gpio_relay_settings_changed();
 
     const char *buttonNames[] = {
         MENU_BTN_TRUE_BYPASS,
@@ -1099,6 +1250,7 @@ static void handleBypassTypeSelected(lv_event_t *e) {
         // Make sure the queue is updated with the new bypass type. This will allow
         // the gpio_task to update the actual GPIO to high or low state.
         xQueueOverwrite(bypassTypeQueue, bypassTypeSetting);
+        gpio_relay_settings_changed();
     }
 
     lvgl_port_unlock();
@@ -1119,6 +1271,7 @@ static void handleDisableMonitoringChickenOutConfirmed(lv_event_t *e) {
     // Make sure the queue is updated with the new bypass type. This will allow
     // the gpio_task to update the actual GPIO to high or low state.
     xQueueOverwrite(bypassTypeQueue, &userSettings->bypassType);
+    gpio_relay_settings_changed();
 
     // Close the message box
     lv_obj_del(mbox);
@@ -1265,6 +1418,7 @@ static void handleEnableMonitoringChickenOutConfirmed(lv_event_t *e) {
     // Make sure the queue is updated with the new bypass type. This will allow
     // the gpio_task to update the actual GPIO to high or low state.
     xQueueOverwrite(bypassTypeQueue, &userSettings->bypassType);
+    gpio_relay_settings_changed();
 
     // Close the message box
     lv_obj_del(mbox);
@@ -1585,15 +1739,70 @@ static void handleDebugButtonClicked(lv_event_t *e) {
         MENU_BTN_1EU_BETA,
         MENU_BTN_NAME_DEBOUNCING,
         // MENU_BTN_MOVING_AVG,
+#if TUNER_PROFILE_LATENCY
+        MENU_BTN_LATENCY,
+#endif
     };
     lv_event_cb_t callbackFunctions[] = {
         handleExpSmoothingButtonClicked,
         handle1EUBetaButtonClicked,
         handleNameDebouncingButtonClicked,
         // handleMovingAvgButtonClicked,
+#if TUNER_PROFILE_LATENCY
+        handleLatencyButtonClicked,
+#endif
     };
-    userSettings->createMenu(buttonNames, NULL, NULL, callbackFunctions, 3);
+    userSettings->createMenu(buttonNames, NULL, NULL, callbackFunctions, sizeof(buttonNames) / sizeof(buttonNames[0]));
+}
+
+#if TUNER_PROFILE_LATENCY
+static void handleLatencyButtonClicked(lv_event_t *e) {
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
+    // One line per stage with the median and 99th percentile in ms, e.g.
+    // "total 12/25 ms". Readings keep being traced while the settings are
+    // showing but this screen is a snapshot.
+    static char stageStrings[latencyStageCount][32];
+    static const char *buttonNames[latencyStageCount + 2];
+    static lv_event_cb_t callbackFunctions[latencyStageCount + 2];
+    latency_trace_collect();
+    for (int stage = 0; stage < latencyStageCount; stage++) {
+        const LatencyHistogram *histogram = latency_trace_get_histogram((LatencyStage)stage);
+        snprintf(stageStrings[stage], sizeof(stageStrings[stage]), "%s %.1f/%.1f ms",
+            latency_trace_stage_name((LatencyStage)stage),
+            latency_histogram_percentile(histogram, 50) / 1000.0f,
+            latency_histogram_percentile(histogram, 99) / 1000.0f);
+        buttonNames[stage] = stageStrings[stage];
+        callbackFunctions[stage] = handleLogLatencyButtonClicked;
+    }
+    lvgl_port_unlock();
+
+    buttonNames[latencyStageCount] = MENU_BTN_LOG_LATENCY;
+    callbackFunctions[latencyStageCount] = handleLogLatencyButtonClicked;
+    buttonNames[latencyStageCount + 1] = MENU_BTN_RESET_LATENCY;
+    callbackFunctions[latencyStageCount + 1] = handleResetLatencyButtonClicked;
+    userSettings->createMenu(buttonNames, NULL, NULL, callbackFunctions, latencyStageCount + 2);
+}
+
+static void handleLogLatencyButtonClicked(lv_event_t *e) {
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
+    latency_trace_collect();
+    latency_trace_log();
+    lvgl_port_unlock();
+}
+
+static void handleResetLatencyButtonClicked(lv_event_t *e) {
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
+    latency_trace_reset();
+    lvgl_port_unlock();
+    userSettings->removeCurrentMenu();
 }
+#endif
 
 static void handleExpSmoothingButtonClicked(lv_event_t *e) {
     if (!lvgl_port_lock(0)) {
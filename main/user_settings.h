@@ -39,6 +39,8 @@ extern "C" { // because these files are C and not C++
 #include "nvs.h"
 
 #include "defines.h"
+#include "instrument_profiles.h"
+#include "tuning_presets.h"
 
 enum TunerOrientation: uint8_t {
     orientationNormal = 0,
@@ -90,6 +92,8 @@ public:
     uint8_t             tunerGUIIndex           = DEFAULT_TUNER_GUI_INDEX; // The ID is also the index in the `available_guis` array.
     uint8_t             inTuneCentsWidth        = DEFAULT_IN_TUNE_CENTS_WIDTH;
     uint8_t             monitoringMode          = DEFAULT_MONITORING_MODE;
+    TunerInstrument     instrument              = DEFAULT_INSTRUMENT; // Read by the pitch detector tasks
+    TunerTuningPreset   tuningPreset            = DEFAULT_TUNING_PRESET; // Read by the pitch detector task
     lv_palette_t        noteNamePalette         = DEFAULT_NOTE_NAME_PALETTE;
     TunerOrientation    displayOrientation      = DEFAULT_DISPLAY_ORIENTATION;
     uint8_t             displayBrightness       = DEFAULT_DISPLAY_BRIGHTNESS;
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_DECIMATOR)
+#define TUNER_DECIMATOR
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "adc_frame_kernel.h"
+#include "decimator_kernel.h"
+
+/// @brief Low-pass filters oversampled ADC conversions and keeps every
+/// `Factor`-th sample.
+///
+/// This is a polyphase decimator: only the outputs that are kept are ever
+/// computed, each one a single dot product of the last
+/// `decimator_num_taps(Factor)` samples with the taps.
+///
+/// The SIMD kernel only loads from 16-byte boundaries, but consecutive
+/// outputs start `Factor` samples (8 bytes when decimating by 4) apart. So
+/// the history is kept `8 / Factor` times, each copy shifted by `Factor`
+/// samples, and every output reads from the copy where its window starts on
+/// a boundary. That costs one more store per input sample when decimating by
+/// 4 and nothing when decimating by 8.
+///
+/// @tparam Factor 4 or 8.
+/// @tparam MaxOutputs Most outputs `process()` produces per call.
+template <size_t Factor, size_t MaxOutputs>
+class Decimator {
+    static_assert(decimator_num_taps(Factor) > 0, "Only decimation by 4 or 8 is supported");
+
+public:
+    static constexpr size_t NumTaps = decimator_num_taps(Factor);
+    static constexpr size_t NumCopies = Factor >= DECIMATOR_KERNEL_LANES ? 1 : DECIMATOR_KERNEL_LANES / Factor;
+    static constexpr size_t BufferSize = NumTaps + MaxOutputs * Factor;
+
+    static_assert(NumTaps % DECIMATOR_KERNEL_LANES == 0 && BufferSize % DECIMATOR_KERNEL_LANES == 0,
+        "Every copy of the history has to start on a 16-byte boundary");
+
+    /// @param dot The dot product kernel. Only the profiling code that checks
+    /// the SIMD kernel against the scalar one passes something else.
+    Decimator(decimator_dot_fn_t dot = decimator_dot) : dot(dot) {
+        decimator_design(Factor, taps);
+        reset();
+    }
+
+    /// @brief Forgets the history (as if the input had been at mid-scale).
+    void reset() {
+        memset(history, 0, sizeof(history));
+    }
+
+    /// @brief Filters and decimates a frame of ADC conversion words.
+    /// @param words The raw conversion words as read from the ADC driver.
+    /// @param numWords Number of words. Anything past the last whole group of
+    /// `Factor` words (or past `MaxOutputs` outputs) is dropped.
+    /// @param out Receives the decimated samples (about 0 - 4095).
+    /// @param outMin Receives the smallest output sample.
+    /// @param outMax Receives the largest output sample.
+    /// @return Returns the number of samples written to `out`.
+    size_t process(const uint32_t *words, size_t numWords, float *out, float *outMin, float *outMax) {
+        size_t numOutputs = std::min(numWords / Factor, MaxOutputs);
+        size_t numInputs = numOutputs * Factor;
+
+        // Append the new samples (centered on 0) after the history of every
+        // copy. Copy `c` holds everything `c * Factor` samples earlier.
+        for (size_t c = 0; c < NumCopies; c++) {
+            int16_t *dst = &history[c][NumTaps - c * Factor];
+            for (size_t i = 0; i < numInputs; i++) {
+                dst[i] = (int16_t)((words[i] & ADC_FRAME_KERNEL_DATA_MASK) - MidScale);
+            }
+        }
+
+        float minVal = INFINITY;
+        float maxVal = -INFINITY;
+        for (size_t m = 0; m < numOutputs; m++) {
+            // The window of output `m` ends on input sample (m + 1) * Factor - 1
+            size_t c = (m + 1) % NumCopies;
+            const int16_t *window = &history[c][(m + 1 - c) * Factor];
+            float value = dot(window, taps, NumTaps) * (1.0f / 32768) + MidScale;
+            out[m] = value;
+            minVal = std::min(minVal, value);
+            maxVal = std::max(maxVal, value);
+        }
+
+        // Keep the last NumTaps samples for the next frame.
+        for (size_t c = 0; c < NumCopies; c++) {
+            memmove(history[c], &history[c][numInputs], (NumTaps - c * Factor) * sizeof(int16_t));
+        }
+
+        *outMin = numOutputs > 0 ? minVal : 0;
+        *outMax = numOutputs > 0 ? maxVal : 0;
+        return numOutputs;
+    }
+
+    const int16_t *getTaps() const { return taps; }
+
+private:
+    static constexpr int32_t MidScale = (ADC_FRAME_KERNEL_DATA_MASK + 1) / 2;
+
+    decimator_dot_fn_t dot;
+
+    alignas(ADC_FRAME_KERNEL_ALIGNMENT) int16_t taps[NumTaps];
+    alignas(ADC_FRAME_KERNEL_ALIGNMENT) int16_t history[NumCopies][BufferSize];
+};
+
+#endif
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_FOOTSWITCH_GESTURES)
+#define TUNER_FOOTSWITCH_GESTURES
+
+#include <cstdint>
+
+#define FOOTSWITCH_NO_DEADLINE  INT64_MAX
+
+enum FootswitchGesture : uint8_t {
+    footswitchGestureNone = 0,
+    footswitchGestureSingle,
+    footswitchGestureDouble,
+    footswitchGestureLong,
+};
+
+/// @brief Debounces the foot switch and turns it into single, double and long
+/// presses.
+///
+/// The first edge is taken right away so a press is never delayed by the
+/// debounce. Edges for `debounceUs` after that are contact bounce and are
+/// ignored. When the lockout ends the level is sampled once more in case the
+/// switch was released (or pressed) while edges were being ignored.
+///
+/// Nothing here reads a pin or a clock. Feed it edges with `edge()`, and call
+/// `timeout()` once `nextDeadlineUs()` has passed, which is when long presses
+/// and delayed single presses are decided.
+///
+/// - Long press: held for `longPressUs`. Reported while still held.
+/// - Double press: released after a second press that started within
+///   `doublePressUs` of the first.
+/// - Single press: released before `longPressUs`. If
+///   `setWaitsForDoublePress(true)`, it is held back for `doublePressUs` after
+///   the release in case a second press turns it into a double press.
+///   Otherwise it is reported right on the release.
+class FootswitchGestures {
+public:
+    FootswitchGestures(int64_t debounceUs, int64_t doublePressUs, int64_t longPressUs)
+        : debounceUs(debounceUs), doublePressUs(doublePressUs), longPressUs(longPressUs) {
+        reset();
+    }
+
+    /// @brief Single presses are held back until a double press is ruled out.
+    /// Takes effect on the next release.
+    void setWaitsForDoublePress(bool waits) { waitsForDoublePress = waits; }
+
+    /// @brief Feed a change of the switch level.
+    /// @param pressed The level after the edge (true when closed).
+    /// @param nowUs When the edge happened.
+    /// @return The gesture this edge completed, if any.
+    FootswitchGesture edge(bool pressed, int64_t nowUs) {
+        if (nowUs < lockoutEndUs || pressed == isPressed) {
+            return footswitchGestureNone;
+        }
+        return accept(pressed, nowUs);
+    }
+
+    /// @brief Call when `nextDeadlineUs()` has passed.
+    /// @param pressed The current level of the switch.
+    /// @param nowUs The current time.
+    /// @return The gesture that was decided, if any.
+    FootswitchGesture timeout(bool pressed, int64_t nowUs) {
+        if (needsResample && nowUs >= lockoutEndUs) {
+            needsResample = false;
+            if (pressed != isPressed) {
+                return accept(pressed, nowUs);
+            }
+        }
+        if (isPressed && !longPressFired && nowUs - pressStartUs >= longPressUs) {
+            longPressFired = true;
+            pressCount = 0; // A long press is never part of a double press
+            return footswitchGestureLong;
+        }
+        if (singlePressDeadlineUs != FOOTSWITCH_NO_DEADLINE && nowUs >= singlePressDeadlineUs) {
+            singlePressDeadlineUs = FOOTSWITCH_NO_DEADLINE;
+            pressCount = 0;
+            return footswitchGestureSingle;
+        }
+        return footswitchGestureNone;
+    }
+
+    /// @brief When `timeout()` needs to be called next, or
+    /// `FOOTSWITCH_NO_DEADLINE` if there's nothing to wait for.
+    int64_t nextDeadlineUs() const {
+        int64_t deadline = singlePressDeadlineUs;
+        if (needsResample && lockoutEndUs < deadline) {
+            deadline = lockoutEndUs;
+        }
+        if (isPressed && !longPressFired && pressStartUs + longPressUs < deadline) {
+            deadline = pressStartUs + longPressUs;
+        }
+        return deadline;
+    }
+
+    bool pressed() const { return isPressed; }
+
+    /// @brief Forget everything and assume the switch is open.
+    void reset() {
+        isPressed = false;
+        lockoutEndUs = INT64_MIN;
+        needsResample = false;
+        pressCount = 0;
+        pressStartUs = 0;
+        lastPressUs = INT64_MIN / 2;
+        longPressFired = false;
+        singlePressDeadlineUs = FOOTSWITCH_NO_DEADLINE;
+    }
+
+private:
+    FootswitchGesture accept(bool pressed, int64_t nowUs) {
+        isPressed = pressed;
+        lockoutEndUs = nowUs + debounceUs;
+        needsResample = true;
+        return pressed ? press(nowUs) : release(nowUs);
+    }
+
+    FootswitchGesture press(int64_t nowUs) {
+        if (nowUs - lastPressUs <= doublePressUs) {
+            pressCount++;
+        } else {
+            pressCount = 1;
+        }
+        if (pressCount > 1) {
+            // This press is going to be a double (or a long) press instead
+            singlePressDeadlineUs = FOOTSWITCH_NO_DEADLINE;
+        }
+        lastPressUs = nowUs;
+        pressStartUs = nowUs;
+        longPressFired = false;
+        return footswitchGestureNone;
+    }
+
+    FootswitchGesture release(int64_t nowUs) {
+        if (longPressFired) {
+            return footswitchGestureNone;
+        }
+        if (pressCount == 2) {
+            pressCount = 0;
+            return footswitchGestureDouble;
+        }
+        if (pressCount == 1 && nowUs - pressStartUs < longPressUs) {
+            if (waitsForDoublePress) {
+                singlePressDeadlineUs = nowUs + doublePressUs;
+                return footswitchGestureNone;
+            }
+            pressCount = 0;
+            return footswitchGestureSingle;
+        }
+        pressCount = 0;
+        return footswitchGestureNone;
+    }
+
+    int64_t debounceUs;
+    int64_t doublePressUs;
+    int64_t longPressUs;
+    bool waitsForDoublePress = false;
+
+    bool isPressed;                 // Debounced level
+    int64_t lockoutEndUs;           // Edges before this are contact bounce
+    bool needsResample;             // Check the level again when the lockout ends
+    int pressCount;                 // Presses within `doublePressUs` of each other
+    int64_t pressStartUs;
+    int64_t lastPressUs;
+    bool longPressFired;
+    int64_t singlePressDeadlineUs;  // When a held back single press is reported
+};
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_LATEST_VALUE)
+#define TUNER_LATEST_VALUE
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// How many times a reader retries when it keeps overlapping a write before it
+// gives up for now. Writes are a few dozen bytes so this is never reached
+// unless the writer was preempted in the middle of one.
+#define LATEST_VALUE_READ_ATTEMPTS  8
+
+/// @brief A single-writer/multi-reader cell that holds the latest published
+/// value (a seqlock).
+///
+/// `publish()` is wait-free and never blocks on readers. Readers copy the value
+/// out and retry if a write overlapped the copy. Every publish bumps a version
+/// number so readers can cheaply tell whether anything changed since they last
+/// looked.
+///
+/// The value is stored as relaxed atomic words so concurrent reads and writes
+/// are well defined in C++.
+///
+/// @tparam T A trivially copyable value type (e.g. `FrequencyInfo`).
+template <typename T>
+class LatestValue {
+    static_assert(std::is_trivially_copyable<T>::value, "LatestValue requires a trivially copyable type");
+
+    static constexpr size_t NumWords = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+public:
+    LatestValue() : sequence(0) {
+        for (size_t i = 0; i < NumWords; i++) {
+            words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    LatestValue(const LatestValue&) = delete;
+    LatestValue& operator=(const LatestValue&) = delete;
+
+    /// @brief Replaces the value (writer only).
+    void publish(const T &value) {
+        uint32_t buffer[NumWords] = {};
+        memcpy(buffer, &value, sizeof(T));
+
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed); // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < NumWords; i++) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /// @brief Copies out the latest value.
+    /// @param value Receives the value.
+    /// @param version If not NULL, receives the version of the value.
+    /// @return Returns false if nothing has been published yet or a
+    /// consistent copy couldn't be made (`value` is left untouched).
+    bool read(T &value, uint32_t *version = nullptr) const {
+        uint32_t buffer[NumWords];
+        for (int attempt = 0; attempt < LATEST_VALUE_READ_ATTEMPTS; attempt++) {
+            uint32_t before = sequence.load(std::memory_order_acquire);
+            if (before == 0) {
+                return false; // Never published
+            }
+            if (before & 1) {
+                continue; // Write in progress
+            }
+            for (size_t i = 0; i < NumWords; i++) {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before) {
+                memcpy(&value, buffer, sizeof(T));
+                if (version != nullptr) {
+                    *version = before / 2;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Copies out the latest value only if it was published after
+    /// `lastVersion`, and updates `lastVersion`.
+    /// @return Returns true if `value` was updated.
+    bool readIfNewer(T &value, uint32_t &lastVersion) const {
+        if (getVersion() == lastVersion) {
+            return false;
+        }
+        return read(value, &lastVersion);
+    }
+
+    /// @brief The number of times `publish()` has completed. Starts at 0.
+    uint32_t getVersion() const {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    std::atomic<uint32_t> sequence;     // Even when stable, odd while a write is in progress
+    std::atomic<uint32_t> words[NumWords];
+};
+
+#endif
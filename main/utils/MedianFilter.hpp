@@ -16,80 +16,219 @@
  *
  * SPDX-License-Identifier: GPL-3.0-or-later
  */
-#include <vector>
-#include <numeric>
-#include <iostream>
+#if !defined(TUNER_MEDIAN_FILTER)
+#define TUNER_MEDIAN_FILTER
+
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 
 #define MIN_MEDIAN_WINDOW_SIZE ((size_t)3)
 #define MAX_MEDIAN_WINDOW_SIZE ((size_t)21)
 
+/// @brief A rolling median over the last `windowSize` values.
+///
+/// The values live in a fixed circular buffer (so the oldest value is the one
+/// that leaves the window) and are indexed by two heaps: a max-heap holding
+/// the lower half and a min-heap holding the upper half. Adding a value is
+/// O(log n) and nothing is allocated after construction.
+///
+/// @tparam Capacity The largest window this filter can be set to. Windows
+/// larger than `MAX_MEDIAN_WINDOW_SIZE` only need a larger capacity.
+template <size_t Capacity = MAX_MEDIAN_WINDOW_SIZE>
 class MedianFilter {
+    static_assert(Capacity >= MIN_MEDIAN_WINDOW_SIZE, "MedianFilter capacity is too small");
+    static_assert(Capacity <= UINT16_MAX, "MedianFilter capacity is too large");
+
+    typedef uint16_t Slot;
+
 public:
     /// @brief Create a new smoother with the specified window size.
-    explicit MedianFilter(size_t windowSize, bool useMovingMode) : useMovingMode(useMovingMode), calculatedValue(-1.0f) {
+    /// @param useMovingMode If true, every value returns the median of the
+    /// last `windowSize` values (or of all values so far until the window
+    /// fills). If false, a median is only returned once per `windowSize`
+    /// values and the window then starts over.
+    explicit MedianFilter(size_t windowSize, bool useMovingMode) : useMovingMode(useMovingMode) {
         setWindowSize(windowSize);
     }
 
     /// @brief Sets the window size after the class has been constructed.
-    /// @param size The new window size.
+    /// This also resets the filter.
+    /// @param size The new window size. It is made odd and clamped to
+    /// [`MIN_MEDIAN_WINDOW_SIZE`, `Capacity`].
     void setWindowSize(size_t size) {
-        this->windowSize = size;
-        if (this->windowSize % 2 == 0) { // Ensure the window size is odd
-            this->windowSize += 1;
+        if (size % 2 == 0) { // Ensure the window size is odd
+            size += 1;
         }
-        this->windowSize = std::min(this->windowSize, MAX_MEDIAN_WINDOW_SIZE);
-        this->windowSize = std::max(this->windowSize, MIN_MEDIAN_WINDOW_SIZE);
-        this->middleIndex = this->windowSize / 2;
+        size = std::min(size, Capacity);
+        if (size % 2 == 0) {
+            size -= 1;
+        }
+        windowSize = std::max(size, MIN_MEDIAN_WINDOW_SIZE);
+        reset();
     }
 
+    size_t getWindowSize() const { return windowSize; }
+
     /// @brief Add a value to the smoother.
     /// @param value The new value.
     /// @return Returns the calculated value IF it's available or -1 if not available.
     float addValue(float value) {
-        // Always keep the values sorted
-        auto it = std::upper_bound(values.begin(), values.end(), value);
-        values.insert(it, value);
-        size_t size = values.size();
-        if (useMovingMode) {
-            if (size > windowSize) {
-                values.erase(values.begin());
-                size = windowSize;
-            }
-            if (size == windowSize) {
-                // Return the middle value
-                calculatedValue = values[middleIndex];
-
-                return calculatedValue;
-            } else {
-                // Return the "middle" value of the current set
-                int tempMiddleIndex = size / 2;
-                calculatedValue = values[tempMiddleIndex];
-                return calculatedValue;
-            }
-        } else if (size == windowSize) {
-            // Return the middle value
-            calculatedValue = values[middleIndex];
-
-            // Clear all the values
-            values.clear();
+        Slot slot;
+        if (count == windowSize) {
+            // Reuse the oldest value's slot
+            slot = oldest;
+            removeSlot(slot);
+            oldest = (Slot)((oldest + 1) % windowSize);
+        } else {
+            slot = (Slot)count;
+            count++;
+        }
+        values[slot] = value;
+        insertSlot(slot);
 
-            return calculatedValue;
+        if (useMovingMode) {
+            // With an even number of values (only while the window fills)
+            // this is the upper of the two middle values.
+            return median();
+        } else if (count == windowSize) {
+            float result = median();
+            reset();
+            return result;
         }
 
         return -1; // Not enough values yet
     }
 
-    /// @brief Resets the average and prep for reuse.
+    /// @brief Resets the filter and prep for reuse.
     void reset() {
-        values.clear();
-        calculatedValue = -1.0f;
+        count = 0;
+        oldest = 0;
+        lowCount = 0;
+        highCount = 0;
     }
 
 private:
     size_t windowSize;
     bool useMovingMode;
-    int middleIndex;
-    std::vector<float> values;
-    float calculatedValue;
+
+    size_t count;               // Number of values in the window
+    Slot oldest;                // Slot holding the oldest value once the window is full
+
+    float values[Capacity];     // Circular buffer of the values in the window
+    Slot heapIndex[Capacity];   // Where each slot is in its heap
+    bool inLow[Capacity];       // Which heap each slot is in
+
+    // The lower half as a max-heap and the upper half as a min-heap (of slots).
+    // highCount is always lowCount or lowCount + 1 so the median (or the upper
+    // middle value) is the top of `high`.
+    Slot low[Capacity];
+    Slot high[Capacity];
+    size_t lowCount;
+    size_t highCount;
+
+    float median() const {
+        return values[high[0]];
+    }
+
+    /// True if `a` belongs above `b` in the given heap.
+    bool outranks(bool isLow, Slot a, Slot b) const {
+        return isLow ? values[a] > values[b] : values[a] < values[b];
+    }
+
+    void place(bool isLow, size_t index, Slot slot) {
+        (isLow ? low : high)[index] = slot;
+        heapIndex[slot] = (Slot)index;
+        inLow[slot] = isLow;
+    }
+
+    void siftUp(bool isLow, size_t index) {
+        Slot *heap = isLow ? low : high;
+        Slot slot = heap[index];
+        while (index > 0) {
+            size_t parent = (index - 1) / 2;
+            if (!outranks(isLow, slot, heap[parent])) {
+                break;
+            }
+            place(isLow, index, heap[parent]);
+            index = parent;
+        }
+        place(isLow, index, slot);
+    }
+
+    void siftDown(bool isLow, size_t index) {
+        Slot *heap = isLow ? low : high;
+        size_t heapCount = isLow ? lowCount : highCount;
+        Slot slot = heap[index];
+        while (true) {
+            size_t child = index * 2 + 1;
+            if (child >= heapCount) {
+                break;
+            }
+            if (child + 1 < heapCount && outranks(isLow, heap[child + 1], heap[child])) {
+                child++;
+            }
+            if (!outranks(isLow, heap[child], slot)) {
+                break;
+            }
+            place(isLow, index, heap[child]);
+            index = child;
+        }
+        place(isLow, index, slot);
+    }
+
+    void push(bool isLow, Slot slot) {
+        size_t index = isLow ? lowCount++ : highCount++;
+        place(isLow, index, slot);
+        siftUp(isLow, index);
+    }
+
+    Slot popTop(bool isLow) {
+        Slot *heap = isLow ? low : high;
+        Slot top = heap[0];
+        size_t last = isLow ? --lowCount : --highCount;
+        if (last > 0) {
+            place(isLow, 0, heap[last]);
+            siftDown(isLow, 0);
+        }
+        return top;
+    }
+
+    void insertSlot(Slot slot) {
+        if (highCount > 0 && values[slot] < values[high[0]]) {
+            push(true, slot);
+        } else {
+            push(false, slot);
+        }
+        rebalance();
+    }
+
+    void removeSlot(Slot slot) {
+        bool isLow = inLow[slot];
+        Slot *heap = isLow ? low : high;
+        size_t index = heapIndex[slot];
+        size_t last = isLow ? --lowCount : --highCount;
+        if (index != last) {
+            // Fill the hole with the last element and move it whichever way
+            // it needs to go.
+            Slot moved = heap[last];
+            place(isLow, index, moved);
+            siftUp(isLow, index);
+            if (heapIndex[moved] == index) {
+                siftDown(isLow, index);
+            }
+        }
+        rebalance();
+    }
+
+    void rebalance() {
+        while (highCount > lowCount + 1) {
+            push(true, popTop(false));
+        }
+        while (lowCount > highCount) {
+            push(false, popTop(true));
+        }
+    }
 };
+
+#endif
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_NOISE_GATE_CLASS)
+#define TUNER_NOISE_GATE_CLASS
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+/// @brief Settings for `NoiseGate`. Levels are RMS in ADC counts and times
+/// are in seconds.
+typedef struct {
+    float initialFloor;     // Noise floor assumed until one has been measured
+    float minFloor;         // The learned floor is clamped to [minFloor, maxFloor]
+    float maxFloor;
+    float openRatio;        // Opens when the envelope reaches floor * openRatio
+    float closeRatio;       // Closes once the envelope stays below floor * closeRatio...
+    float holdSeconds;      // ...for this long
+    float releaseSeconds;   // Envelope decay time constant (it rises instantly)
+    float floorRiseSeconds; // Time constants of the floor while the gate is closed
+    float floorFallSeconds;
+    float dcSeconds;        // Time constant of the DC (bias) tracker
+} NoiseGateConfig;
+
+/// @brief A noise gate for the pitch detector that learns its own noise floor.
+///
+/// Every frame the RMS of the samples around a slowly tracked DC level is
+/// folded into an envelope that jumps up to a louder frame and decays
+/// otherwise. While the gate is closed the envelope is what silence sounds
+/// like, so the noise floor follows it (slowly up, faster down). The gate
+/// opens when the envelope gets `openRatio` above the floor and only closes
+/// after it has been below the lower `closeRatio` for `holdSeconds`, so a
+/// decaying string doesn't chatter open and closed around one threshold.
+///
+/// All state is a handful of floats. Nothing is allocated.
+class NoiseGate {
+public:
+    explicit NoiseGate(const NoiseGateConfig &config) : config(config) {
+        reset();
+    }
+
+    /// @brief Measures a frame and updates the gate.
+    /// @param samples Raw ADC samples (0 - 4095).
+    /// @param numSamples Number of samples in the frame.
+    /// @param frameSeconds Length of the frame.
+    /// @return Returns true if the gate is open (detect the pitch of this frame).
+    bool process(const float *samples, size_t numSamples, float frameSeconds) {
+        if (numSamples == 0) {
+            return open;
+        }
+
+        float sum = 0;
+        float sumOfSquares = 0;
+        for (size_t i = 0; i < numSamples; i++) {
+            float centered = samples[i] - dc;
+            sum += centered;
+            sumOfSquares += centered * centered;
+        }
+        float mean = sum / numSamples;
+        // Measured against the tracked DC, not this frame's mean, so periods
+        // longer than a frame (low strings) still count in full.
+        float rms = std::sqrt(sumOfSquares / numSamples);
+        if (!hasDC) {
+            // The very first frame sets the DC level and can't be trusted.
+            dc += mean;
+            hasDC = true;
+            return open;
+        }
+        dc += mean * coefficient(frameSeconds, config.dcSeconds);
+
+        envelope = std::max(rms, envelope * (1.0f - coefficient(frameSeconds, config.releaseSeconds)));
+
+        justOpened = false;
+        justClosed = false;
+        if (open) {
+            if (envelope >= floor * config.closeRatio) {
+                holdLeft = config.holdSeconds;
+            } else {
+                holdLeft -= frameSeconds;
+                if (holdLeft <= 0) {
+                    open = false;
+                    justClosed = true;
+                }
+            }
+        } else if (envelope >= floor * config.openRatio) {
+            open = true;
+            justOpened = true;
+            holdLeft = config.holdSeconds;
+        } else {
+            float tau = envelope > floor ? config.floorRiseSeconds : config.floorFallSeconds;
+            floor += (envelope - floor) * coefficient(frameSeconds, tau);
+            floor = std::clamp(floor, config.minFloor, config.maxFloor);
+        }
+        return open;
+    }
+
+    bool isOpen() const { return open; }
+
+    /// @brief True if the last `process()` call opened the gate.
+    bool didJustOpen() const { return justOpened; }
+
+    /// @brief True if the last `process()` call closed the gate.
+    bool didJustClose() const { return justClosed; }
+
+    /// @brief The tracked DC level (bias) of the input in ADC counts.
+    float getDC() const { return dc; }
+
+    float getEnvelope() const { return envelope; }
+    float getNoiseFloor() const { return floor; }
+
+    /// @brief Closes the gate and goes back to the initial noise floor.
+    void reset() {
+        open = false;
+        justOpened = false;
+        justClosed = false;
+        hasDC = false;
+        dc = 0;
+        envelope = 0;
+        floor = config.initialFloor;
+        holdLeft = 0;
+    }
+
+private:
+    /// One-pole smoothing coefficient for a step of `seconds`.
+    static float coefficient(float seconds, float tau) {
+        return tau > 0 ? 1.0f - std::exp(-seconds / tau) : 1.0f;
+    }
+
+    NoiseGateConfig config;
+
+    bool open;
+    bool justOpened;
+    bool justClosed;
+    bool hasDC;
+    float dc;           // Bias of the input (about mid-scale)
+    float envelope;     // Smoothed RMS around `dc`
+    float floor;        // Learned noise floor
+    float holdLeft;     // Seconds left before an open gate may close
+};
+
+#endif
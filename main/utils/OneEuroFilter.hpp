@@ -1,6 +1,6 @@
 /* -*- coding: utf-8 -*-
  *
- * OneEuroFilter.h -
+ * OneEuroFilter.hpp -
  *
  * Authors: 
  * Nicolas Roussel (nicolas.roussel@inria.fr)
@@ -32,56 +32,97 @@
  *
  */
 
-#include <iostream>
-#include <stdexcept>
+//
+// Header-only, allocation-free version of the 1EU filter templated on the
+// scalar type. Use OneEuroFilter<float> on the ESP32-S3 since its FPU only
+// does single precision.
+//
+// Differences from the original:
+//   - The low pass filters are held by value so reset() just clears state.
+//   - The 1 / (2 * pi * cutoff) time constants are computed once in the
+//     setters instead of on every call to filter().
+//   - Timestamps are integer microseconds. A float of seconds since boot
+//     runs out of precision for 200 us sample spacing after a few minutes.
+//
+
+#if !defined(TUNER_ONE_EURO_FILTER)
+#define TUNER_ONE_EURO_FILTER
+
 #include <cmath>
-#include <ctime>
+#include <cstdint>
 
 // -----------------------------------------------------------------
 // Utilities
 
-typedef double TimeStamp ; // in seconds
+typedef int64_t TimeStamp ; // in microseconds
 
-static const TimeStamp UndefinedTime = -1.0 ;
+static const TimeStamp UndefinedTime = -1 ;
 
 // -----------------------------------------------------------------
 
+template <typename T>
 class LowPassFilter {
-    
-  double y, a, s ;
-  bool initialized ;
 
-  void setAlpha(double alpha) ;
+  T y, s ;
+  bool initialized ;
 
 public:
 
-  LowPassFilter(double alpha, double initval=0.0) ;
-
-  double filter(double value) ;
-
-  double filterWithAlpha(double value, double alpha) ;
-
-  bool hasLastRawValue(void) ;
+  LowPassFilter() : y(0), s(0), initialized(false) {}
 
-  double lastRawValue(void) ;
+  void reset() {
+    y = s = 0 ;
+    initialized = false ;
+  }
 
-  double lastFilteredValue(void) ;
+  /**
+   * @brief Filter a value with the given smoothing factor
+   * @param alpha Smoothing factor in (0.0, 1.0]. Values outside of that range are treated as 0.0.
+   */
+  T filterWithAlpha(T value, T alpha) {
+    T result ;
+    if (initialized) {
+      if (!(alpha > 0 && alpha <= 1)) {
+        alpha = 0 ;
+      }
+      result = alpha*value + (1-alpha)*s ;
+    } else {
+      result = value ;
+      initialized = true ;
+    }
+    y = value ;
+    s = result ;
+    return result ;
+  }
+
+  bool hasLastRawValue(void) const { return initialized ; }
+
+  T lastRawValue(void) const { return y ; }
+
+  T lastFilteredValue(void) const { return s ; }
 
 } ;
 
 // -----------------------------------------------------------------
 
+template <typename T>
 class OneEuroFilter {
 
-  double freq ;
-  double mincutoff ;
-  double beta_ ;
-  double dcutoff ;
-  LowPassFilter *x ;
-  LowPassFilter *dx ;
+  T freq ;
+  T mincutoff ;
+  T beta_ ;
+  T dcutoff ;
+  T dtau ;  // 1 / (2 * pi * dcutoff)
+  LowPassFilter<T> x ;
+  LowPassFilter<T> dx ;
   TimeStamp lasttime ;
 
-  double alpha(double cutoff) ;
+  static constexpr T TwoPi = (T)6.283185307179586476925 ;
+
+  /// alpha = 1 / (1 + tau / te) where te = 1 / freq
+  T alphaForTau(T tau) const {
+    return 1 / (1 + tau*freq) ;
+  }
 
 public:
 
@@ -92,45 +133,75 @@ public:
    * @param beta_ Parameter to reduce latency (> 0).
    * @param dcutoff Used to filter the derivates. 1 Hz by default. Change this parameter if you know what you are doing.
    */
-  OneEuroFilter(double freq, 
-		double mincutoff=1.0, double beta_=0.0, double dcutoff=1.0) ;
-
-  void reset() ;
+  OneEuroFilter(T freq, T mincutoff=1, T beta_=0, T dcutoff=1) {
+    setFrequency(freq) ;
+    setMinCutoff(mincutoff) ;
+    setBeta(beta_) ;
+    setDerivateCutoff(dcutoff) ;
+    lasttime = UndefinedTime ;
+  }
+
+  void reset() {
+    x.reset() ;
+    dx.reset() ;
+    lasttime = UndefinedTime ;
+  }
 
   /**
    * @brief Filter the noisy signal
    * @param value Noisy value to filter
-   * @param timestamp (optional) timestamp in seconds
+   * @param timestamp (optional) timestamp in microseconds
    * @return The filtered value
    */
-  double filter(double value, TimeStamp timestamp=UndefinedTime) ;
+  T filter(T value, TimeStamp timestamp=UndefinedTime) {
+    // update the sampling frequency based on timestamps
+    if (lasttime!=UndefinedTime && timestamp!=UndefinedTime && timestamp>lasttime)
+      freq = (T)1000000 / (T)(timestamp-lasttime) ;
+    lasttime = timestamp ;
+    // estimate the current variation per second
+    T dvalue = x.hasLastRawValue() ? (value - x.lastFilteredValue())*freq : 0 ;
+    T edvalue = dx.filterWithAlpha(dvalue, alphaForTau(dtau)) ;
+    // use it to update the cutoff frequency
+    T cutoff = mincutoff + beta_*std::fabs(edvalue) ;
+    // filter the given value
+    return x.filterWithAlpha(value, alphaForTau(1 / (TwoPi*cutoff))) ;
+  }
 
   /**
    * @brief Sets the frequency of the signal
    * @param f An estimate of the frequency in Hz of the signal (> 0), if timestamps are not available.
    */
-  void setFrequency(double f) ;
+  void setFrequency(T f) {
+    freq = f <= 0 ? 0 : f ;
+  }
 
   /**
    * @brief Sets the filter min cutoff frequency
    * @param mc Min cutoff frequency in Hz (> 0). Lower values allow to remove more jitter.
    */ 
-  void setMinCutoff(double mc) ;
+  void setMinCutoff(T mc) {
+    mincutoff = mc <= 0 ? 1 : mc ;
+  }
 
   /**
    * @brief Sets the Beta parameter
    * @param b Parameter to reduce latency (> 0).
    */ 
-  void setBeta(double b) ;
+  void setBeta(T b) {
+    beta_ = b ;
+  }
 
   /**
    * @brief Sets the Cutoff frequency for derivates
    * @param dc Used to filter the derivates. 1 Hz by default. Change this parameter if you know what you are doing.
    */ 
-  void setDerivateCutoff(double dc) ;
-
-  ~OneEuroFilter(void) ;
+  void setDerivateCutoff(T dc) {
+    dcutoff = dc <= 0 ? 1 : dc ;
+    dtau = 1 / (TwoPi*dcutoff) ;
+  }
 
 } ;
 
 // -----------------------------------------------------------------
+
+#endif
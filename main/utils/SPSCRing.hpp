@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_SPSC_RING)
+#define TUNER_SPSC_RING
+
+#include <atomic>
+#include <cstddef>
+
+/// @brief A fixed-capacity, lock-free, single-producer/single-consumer ring.
+///
+/// Exactly one task may call `push()` and exactly one (possibly different)
+/// task may call `pop()`. Neither call blocks or allocates, which makes this
+/// suitable for handing pointers to preallocated buffers between pipeline
+/// stages.
+///
+/// @tparam T The element type. Keep this small (a pointer or index).
+/// @tparam Capacity The maximum number of elements. Must be a power of two.
+template <typename T, size_t Capacity>
+class SPSCRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SPSCRing capacity must be a power of two");
+
+public:
+    SPSCRing() : head(0), tail(0) {}
+
+    SPSCRing(const SPSCRing&) = delete;
+    SPSCRing& operator=(const SPSCRing&) = delete;
+
+    /// @brief Adds an item to the ring (producer only).
+    /// @return Returns false if the ring is full.
+    bool push(const T &item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == Capacity) {
+            return false; // full
+        }
+        items[h & (Capacity - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Removes the oldest item from the ring (consumer only).
+    /// @return Returns false if the ring is empty.
+    bool pop(T &item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return false; // empty
+        }
+        item = items[t & (Capacity - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief The number of items currently in the ring. This is only a
+    /// snapshot when called from a task other than the producer or consumer.
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+private:
+    T items[Capacity];
+    std::atomic<size_t> head; // next slot to write (owned by the producer)
+    std::atomic<size_t> tail; // next slot to read (owned by the consumer)
+};
+
+#endif
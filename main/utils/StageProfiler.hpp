@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_STAGE_PROFILER)
+#define TUNER_STAGE_PROFILER
+
+#include <cstdint>
+
+/// @brief Accumulates min/avg/max durations for one stage of a pipeline.
+///
+/// The profiler does no timing itself so it can be fed from
+/// `esp_timer_get_time()`, cycle counters or host clocks alike.
+class StageProfiler {
+public:
+    explicit StageProfiler(const char *name) : name(name) {
+        reset();
+    }
+
+    /// @brief Record one measurement.
+    void addSample(int64_t duration) {
+        if (duration < minDuration) {
+            minDuration = duration;
+        }
+        if (duration > maxDuration) {
+            maxDuration = duration;
+        }
+        totalDuration += duration;
+        count++;
+    }
+
+    const char *getName() const { return name; }
+    uint32_t getCount() const { return count; }
+    int64_t getMin() const { return count > 0 ? minDuration : 0; }
+    int64_t getMax() const { return maxDuration; }
+    int64_t getAverage() const { return count > 0 ? totalDuration / count : 0; }
+
+    void reset() {
+        minDuration = INT64_MAX;
+        maxDuration = 0;
+        totalDuration = 0;
+        count = 0;
+    }
+
+private:
+    const char *name;
+    int64_t minDuration;
+    int64_t maxDuration;
+    int64_t totalDuration;
+    uint32_t count;
+};
+
+#endif
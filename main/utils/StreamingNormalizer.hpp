@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_STREAMING_NORMALIZER_CLASS)
+#define TUNER_STREAMING_NORMALIZER_CLASS
+
+#include <cmath>
+
+/// @brief Brings raw ADC samples to about -1.0 to +1.0 one sample at a time.
+///
+/// A one-pole DC blocker removes the input bias and a peak follower with an
+/// instant attack and a slow release sets the gain. Both carry their state
+/// from one frame to the next, so unlike normalizing every frame by its own
+/// min and max, neither the offset nor the scale jumps at frame boundaries.
+/// A new pluck can't overshoot (the attack is instant) and the gain only
+/// follows a dying string as fast as `releaseSeconds` allows.
+class StreamingNormalizer {
+public:
+    /// @param sampleRate Sample rate in Hz.
+    /// @param dcCutoffHz Corner of the DC blocker. Keep it well below the
+    /// lowest note.
+    /// @param releaseSeconds Time constant of the level decay.
+    /// @param minLevel Smallest level (in ADC counts) the gain is set for so
+    /// noise isn't blown up to full scale.
+    StreamingNormalizer(float sampleRate, float dcCutoffHz, float releaseSeconds, float minLevel)
+        : dcCoefficient(1.0f - std::exp(-2.0f * (float)M_PI * dcCutoffHz / sampleRate)),
+          releaseCoefficient(std::exp(-1.0f / (releaseSeconds * sampleRate))),
+          minLevel(minLevel) {
+        reset(0, minLevel);
+    }
+
+    /// @brief Starts over from a known bias and level, e.g. what the noise
+    /// gate measured, so the first samples come out right.
+    void reset(float dc, float level) {
+        this->dc = dc;
+        this->level = level;
+    }
+
+    float operator()(float s) {
+        float y = s - dc;
+        dc += y * dcCoefficient;
+
+        float magnitude = std::fabs(y);
+        level = magnitude > level ? magnitude : level * releaseCoefficient;
+        return y / (level > minLevel ? level : minLevel);
+    }
+
+    float getDC() const { return dc; }
+    float getLevel() const { return level; }
+
+private:
+    float dcCoefficient;
+    float releaseCoefficient;
+    float minLevel;
+
+    float dc;       // Input bias in ADC counts
+    float level;    // Peak level around `dc` in ADC counts
+};
+
+#endif
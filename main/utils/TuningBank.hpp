@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_TUNING_BANK_CLASS)
+#define TUNER_TUNING_BANK_CLASS
+
+#include <cmath>
+#include <cstddef>
+
+/// @brief Settings for `TuningBank`.
+typedef struct {
+    float bandwidth;        // Corner of each resonator's low-pass as a fraction of its frequency
+    float octaveRatio;      // A string below that has this much of the picked string's fundamental energy is the one playing
+    float minShare;         // The picked string has to hold at least this share of the bank's energy
+    float maxCents;         // Readings further off than this are dropped
+    int   stableFrames;     // Frames in a row a string has to be picked before it is reported
+} TuningBankConfig;
+
+/// @brief A reading from `TuningBank`.
+typedef struct {
+    size_t  string;         // Index of the string in the tuning
+    float   frequency;      // Hz
+    float   cents;          // Relative to the string's target frequency
+} TuningBankReading;
+
+/// @brief Tells which string of a known tuning is ringing and how far off it
+/// is, without searching for the pitch.
+///
+/// Every string gets two resonators, one on its target frequency and one on
+/// twice that. A resonator mixes the input down with a complex oscillator at
+/// its frequency and low-passes the result twice (one-pole each), so it is a
+/// sliding single-bin DFT with a smooth window about `bandwidth` wide. At the
+/// end of every frame the string whose fundamental and 2nd harmonic hold the
+/// most energy is picked, and its pitch comes from how far the phase of its
+/// resonators turned since the last frame: a string that is `df` Hz off
+/// turns `2 pi df` radians a second. The 2nd harmonic turns twice as fast so
+/// both are averaged, weighted by their energy.
+///
+/// With constant-Q resonators the low strings are much slower to ring up than
+/// the high ones, so right after a pluck their energy is scaled up by how far
+/// they've charged. A string that is picked because its resonators sit on or
+/// near upper harmonics of a lower string (E4 and the 4th harmonic of E2, G2
+/// and the 3rd of B0) gives way to the lower string as long as that one's
+/// fundamental is there at all.
+///
+/// The state is kept as one array per field with the resonators side by
+/// side, so the per-sample loop has no branches and can run across all
+/// strings at once. GCC vectorizes it for the host (-fopt-info-vec); whether
+/// the ESP32-S3 build does hasn't been checked.
+///
+/// All state is fixed-size. Nothing is allocated.
+///
+/// @tparam MaxStrings Most strings a tuning can have.
+template <size_t MaxStrings>
+class TuningBank {
+public:
+    /// @brief Highest harmonic of a lower string that is checked for when
+    /// picking the string.
+    static constexpr float MaxHarmonic = 10;
+
+    /// @brief How far off a harmonic of a lower string a frequency can be
+    /// and still be taken for it, as a fraction of the harmonic (25 cents).
+    static constexpr float HarmonicTolerance = 0.015f;
+
+    /// @brief Right after a reset the attack rings resonators that are a
+    /// semitone away from a low partial before their pitch can be trusted, so
+    /// for `AttackSeconds` the resonators' own frequency is matched against
+    /// the 2nd and 3rd harmonics this loosely (about a semitone). It's kept
+    /// that short because a string plucked over a lower one that's still
+    /// ringing would otherwise be handed to it (G2 over B0).
+    static constexpr float AttackHarmonicTolerance = 0.06f;
+    static constexpr float AttackMaxHarmonic = 3;
+    static constexpr float AttackSeconds = 0.3f;
+
+    /// @brief Least charge a resonator is scaled up for, so the first frames
+    /// after a reset aren't mostly amplified noise.
+    static constexpr float MinCharge = 0.5f;
+
+    /// @param config See `TuningBankConfig`.
+    /// @param targetFrequencies The frequency of each string in Hz, lowest first.
+    /// @param numStrings Number of strings (at most `MaxStrings`). With 0 the
+    /// bank never reports anything.
+    /// @param sampleRate Sample rate in Hz.
+    TuningBank(const TuningBankConfig &config, const float *targetFrequencies, size_t numStrings, float sampleRate)
+        : config(config),
+          numStrings(numStrings < MaxStrings ? numStrings : MaxStrings),
+          numResonators(2 * this->numStrings),
+          sampleRate(sampleRate) {
+        for (size_t k = 0; k < this->numStrings; k++) {
+            targets[k] = targetFrequencies[k];
+            for (size_t h = 0; h < 2; h++) {
+                size_t r = h * this->numStrings + k;
+                float frequency = targetFrequencies[k] * (h + 1);
+                float omega = 2.0f * (float)M_PI * frequency / sampleRate;
+                stepRe[r] = std::cos(omega);
+                stepIm[r] = std::sin(omega);
+                alpha[r] = 1.0f - std::exp(-2.0f * (float)M_PI * frequency * config.bandwidth / sampleRate);
+            }
+        }
+        reset();
+    }
+
+    /// @brief Forgets everything so the next note starts from silence.
+    void reset() {
+        for (size_t r = 0; r < 2 * MaxStrings; r++) {
+            oscRe[r] = 1;
+            oscIm[r] = 0;
+            z1Re[r] = z1Im[r] = z2Re[r] = z2Im[r] = 0;
+            lastRe[r] = lastIm[r] = 0;
+        }
+        hasLast = false;
+        numSamplesSinceReset = 0;
+        lastString = -1;
+        sameStringFrames = 0;
+    }
+
+    /// @brief Runs one (normalized) sample through every resonator.
+    inline void operator()(float s) {
+        for (size_t r = 0; r < numResonators; r++) {
+            // Mix down: s * conj(osc)
+            float mixRe = s * oscRe[r];
+            float mixIm = -s * oscIm[r];
+            z1Re[r] += alpha[r] * (mixRe - z1Re[r]);
+            z1Im[r] += alpha[r] * (mixIm - z1Im[r]);
+            z2Re[r] += alpha[r] * (z1Re[r] - z2Re[r]);
+            z2Im[r] += alpha[r] * (z1Im[r] - z2Im[r]);
+
+            float re = oscRe[r] * stepRe[r] - oscIm[r] * stepIm[r];
+            oscIm[r] = oscRe[r] * stepIm[r] + oscIm[r] * stepRe[r];
+            oscRe[r] = re;
+        }
+    }
+
+    /// @brief Picks the string at the end of a frame.
+    /// @param numSamples Number of samples run through the bank since the
+    /// last call.
+    /// @param reading Receives the string and its pitch.
+    /// @return Returns true if a string has been picked for `stableFrames`
+    /// frames in a row and `reading` was filled in.
+    bool endFrame(size_t numSamples, TuningBankReading *reading) {
+        numSamplesSinceReset += numSamples;
+        float n = (float)numSamplesSinceReset;
+
+        float energy[2 * MaxStrings];
+        float total = 0;
+        for (size_t r = 0; r < numResonators; r++) {
+            // Pull the oscillators back onto the unit circle before rounding
+            // errors add up (one Newton step is plenty, they barely drift).
+            float g = 1.5f - 0.5f * (oscRe[r] * oscRe[r] + oscIm[r] * oscIm[r]);
+            oscRe[r] *= g;
+            oscIm[r] *= g;
+
+            // Scale up by how far the resonator has charged since the reset
+            // (the step response of the two low-passes) so the slow ones
+            // down low aren't outvoted by the fast ones up high right after
+            // the pluck.
+            float p = 1.0f - alpha[r];
+            float charge = 1.0f - std::pow(p, n) * (1.0f + n * alpha[r] / p);
+            charge = charge > MinCharge ? charge : MinCharge;
+            energy[r] = (z2Re[r] * z2Re[r] + z2Im[r] * z2Im[r]) / (charge * charge);
+            total += energy[r];
+        }
+
+        int best = -1;
+        float bestScore = 0;
+        for (size_t k = 0; k < numStrings; k++) {
+            float score = energy[k] + energy[numStrings + k];
+            if (score > bestScore) {
+                best = (int)k;
+                bestScore = score;
+            }
+        }
+
+        // The loudest string has to stand out from everything else the bank
+        // hears, or it's noise or a chord.
+        bool found = best >= 0 && hasLast && bestScore >= config.minShare * total;
+
+        // The loudest string's resonators can be sitting on upper harmonics
+        // of a lower string (low strings often have a weak fundamental and a
+        // bright top). If that string has a fundamental of its own, it's the
+        // one that was plucked. The resonators also ring for a partial up to
+        // a semitone away (G2 picks up the 3rd harmonic of B0), so the pitch
+        // they hear is checked against the pitch the lower string hears, as
+        // well as where they sit.
+        bool inAttack = n < AttackSeconds * sampleRate;
+        float heard = found ? measure_frequency(best, numSamples, energy) : 0;
+        for (int j = 0; found && j < best; j++) {
+            if (energy[j] <= config.octaveRatio * bestScore) {
+                continue;
+            }
+            float lower = measure_frequency(j, numSamples, energy);
+            if (is_harmonic(targets[best], targets[j], inAttack) || is_harmonic(2 * targets[best], targets[j], inAttack)
+                || is_harmonic(heard, lower) || is_harmonic(2 * heard, lower)) {
+                best = j;
+                heard = lower;
+            }
+        }
+
+        if (found) {
+            float frequency = heard;
+            float cents = 1200.0f * std::log2(frequency / targets[best]);
+            found = std::fabs(cents) <= config.maxCents;
+            if (found) {
+                reading->string = (size_t)best;
+                reading->frequency = frequency;
+                reading->cents = cents;
+            }
+        }
+
+        for (size_t r = 0; r < numResonators; r++) {
+            lastRe[r] = z2Re[r];
+            lastIm[r] = z2Im[r];
+        }
+        hasLast = true;
+
+        if (!found) {
+            lastString = -1;
+            sameStringFrames = 0;
+            return false;
+        }
+        sameStringFrames = best == lastString ? sameStringFrames + 1 : 1;
+        lastString = best;
+        return sameStringFrames >= config.stableFrames;
+    }
+
+    size_t getNumStrings() const { return numStrings; }
+
+private:
+    /// @brief Pitch of `string` from how far its resonators turned since the
+    /// last frame, averaged by their energy.
+    float measure_frequency(int string, size_t numSamples, const float *energy) const {
+        float hopSeconds = numSamples / sampleRate;
+        float offset = 0;
+        float weight = 0;
+        for (size_t h = 0; h < 2; h++) {
+            size_t r = h * numStrings + string;
+            float dotRe = z2Re[r] * lastRe[r] + z2Im[r] * lastIm[r];
+            float dotIm = z2Im[r] * lastRe[r] - z2Re[r] * lastIm[r];
+            float turned = std::atan2(dotIm, dotRe);
+            offset += energy[r] * turned / (2.0f * (float)M_PI * hopSeconds * (h + 1));
+            weight += energy[r];
+        }
+        return targets[string] + offset / weight;
+    }
+
+    /// @brief Is `frequency` one of the first `MaxHarmonic` harmonics of
+    /// `fundamental` (within `HarmonicTolerance`, or the attack tolerance
+    /// when `inAttack`)?
+    static bool is_harmonic(float frequency, float fundamental, bool inAttack = false) {
+        float ratio = frequency / fundamental;
+        float harmonic = std::round(ratio);
+        if (harmonic < 2 || harmonic > MaxHarmonic) {
+            return false;
+        }
+        float tolerance = inAttack && harmonic <= AttackMaxHarmonic ? AttackHarmonicTolerance : HarmonicTolerance;
+        return std::fabs(ratio - harmonic) < tolerance * harmonic;
+    }
+
+    TuningBankConfig config;
+    size_t  numStrings;
+    size_t  numResonators;      // Fundamentals first, then the 2nd harmonics
+    float   sampleRate;
+    float   targets[MaxStrings];
+
+    // Per resonator
+    float   stepRe[2 * MaxStrings];     // Oscillator rotation per sample
+    float   stepIm[2 * MaxStrings];
+    float   alpha[2 * MaxStrings];      // Low-pass coefficient
+    float   oscRe[2 * MaxStrings];      // Oscillator
+    float   oscIm[2 * MaxStrings];
+    float   z1Re[2 * MaxStrings];       // First low-pass
+    float   z1Im[2 * MaxStrings];
+    float   z2Re[2 * MaxStrings];       // Second low-pass (the output)
+    float   z2Im[2 * MaxStrings];
+    float   lastRe[2 * MaxStrings];     // Output at the end of the last frame
+    float   lastIm[2 * MaxStrings];
+
+    bool    hasLast;
+    size_t  numSamplesSinceReset;
+    int     lastString;
+    int     sameStringFrames;
+};
+
+#endif
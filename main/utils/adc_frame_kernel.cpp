@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "adc_frame_kernel.h"
+
+#include <algorithm>
+#include <cstring>
+
+void adc_frame_unpack_scalar(const uint32_t *words, size_t numWords, float *out, float *outMin, float *outMax) {
+    // Reduce on integers so the compiler can use the branchless MIN/MAX
+    // instructions instead of float compares.
+    uint32_t minVal = ADC_FRAME_KERNEL_DATA_MASK;
+    uint32_t maxVal = 0;
+    for (size_t i = 0; i < numWords; i++) {
+        uint32_t value = words[i] & ADC_FRAME_KERNEL_DATA_MASK;
+        out[i] = (float)value;
+        minVal = std::min(minVal, value);
+        maxVal = std::max(maxVal, value);
+    }
+    if (numWords == 0) {
+        minVal = 0;
+    }
+    *outMin = (float)minVal;
+    *outMax = (float)maxVal;
+}
+
+#if ADC_FRAME_KERNEL_HAS_PIE
+// adc_frame_kernel_pie.S
+extern "C" void adc_frame_unpack_pie_blocks(const uint32_t *words, size_t numBlocks, int32_t *out, int32_t *lanes);
+
+void adc_frame_unpack_pie(const uint32_t *words, size_t numWords, float *out, float *outMin, float *outMax) {
+    size_t numBlocks = numWords / 4;
+    if (numBlocks == 0) {
+        adc_frame_unpack_scalar(words, numWords, out, outMin, outMax);
+        return;
+    }
+
+    // Mask 4 words at a time, keep a running max and min per lane and store
+    // the masked integers into `out`. They get converted to floats in place
+    // below while they are still in cache.
+    alignas(ADC_FRAME_KERNEL_ALIGNMENT) int32_t lanes[8]; // 4 max lanes followed by 4 min lanes
+    adc_frame_unpack_pie_blocks(words, numBlocks, (int32_t *)out, lanes);
+
+    size_t vectorWords = numBlocks * 4;
+    for (size_t i = 0; i < vectorWords; i++) {
+        int32_t value;
+        memcpy(&value, &out[i], sizeof(value));
+        out[i] = (float)value;
+    }
+
+    int32_t maxVal = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    int32_t minVal = std::min(std::min(lanes[4], lanes[5]), std::min(lanes[6], lanes[7]));
+
+    // Pick up any words that don't fill a whole vector.
+    for (size_t i = vectorWords; i < numWords; i++) {
+        int32_t value = words[i] & ADC_FRAME_KERNEL_DATA_MASK;
+        out[i] = (float)value;
+        minVal = std::min(minVal, value);
+        maxVal = std::max(maxVal, value);
+    }
+
+    *outMin = (float)minVal;
+    *outMax = (float)maxVal;
+}
+#endif
+
+void adc_frame_unpack(const uint32_t *words, size_t numWords, float *out, float *outMin, float *outMax) {
+#if ADC_FRAME_KERNEL_HAS_PIE && ADC_FRAME_KERNEL_USE_PIE
+    if (((uintptr_t)words % ADC_FRAME_KERNEL_ALIGNMENT) == 0 && ((uintptr_t)out % ADC_FRAME_KERNEL_ALIGNMENT) == 0) {
+        adc_frame_unpack_pie(words, numWords, out, outMin, outMax);
+        return;
+    }
+#endif
+    adc_frame_unpack_scalar(words, numWords, out, outMin, outMax);
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_ADC_FRAME_KERNEL)
+#define TUNER_ADC_FRAME_KERNEL
+
+#include <cstddef>
+#include <cstdint>
+
+// The 12-bit conversion result in an ADC_DIGI_OUTPUT_FORMAT_TYPE2 word.
+#define ADC_FRAME_KERNEL_DATA_MASK      0x0FFF
+
+// The SIMD path loads 4 conversion words (128 bits) at a time and needs the
+// input and output buffers aligned to this many bytes.
+#define ADC_FRAME_KERNEL_ALIGNMENT      16
+
+#if defined(ESP_PLATFORM)
+#include "sdkconfig.h"
+#endif
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+#define ADC_FRAME_KERNEL_HAS_PIE        1
+#else
+#define ADC_FRAME_KERNEL_HAS_PIE        0
+#endif
+
+// Set to 0 to force `adc_frame_unpack()` onto the scalar path on the S3.
+#if !defined(ADC_FRAME_KERNEL_USE_PIE)
+#define ADC_FRAME_KERNEL_USE_PIE        ADC_FRAME_KERNEL_HAS_PIE
+#endif
+
+/// @brief Unpacks TYPE2 ADC conversion words into float samples and finds the
+/// min and max sample in the same pass (portable reference implementation).
+/// @param words The raw conversion words as read from the ADC driver.
+/// @param numWords Number of words in `words`.
+/// @param out Receives `numWords` samples (0 - 4095).
+/// @param outMin Receives the smallest sample.
+/// @param outMax Receives the largest sample.
+void adc_frame_unpack_scalar(const uint32_t *words, size_t numWords, float *out, float *outMin, float *outMax);
+
+#if ADC_FRAME_KERNEL_HAS_PIE
+/// @brief Same as `adc_frame_unpack_scalar()` but uses the ESP32-S3 128-bit
+/// PIE vector instructions for the mask and min/max reduction.
+///
+/// `words` and `out` must be aligned to `ADC_FRAME_KERNEL_ALIGNMENT`.
+void adc_frame_unpack_pie(const uint32_t *words, size_t numWords, float *out, float *outMin, float *outMax);
+#endif
+
+/// @brief Unpacks a frame using the fastest path available for the target
+/// and the alignment of the buffers.
+void adc_frame_unpack(const uint32_t *words, size_t numWords, float *out, float *outMin, float *outMax);
+
+/// @brief Computes the scale and offset that map samples in [minVal, maxVal]
+/// to [-1.0, +1.0] as `sample * scale + offset` so the consumer can normalize
+/// while it walks the frame.
+inline void adc_frame_normalizer(float minVal, float maxVal, float *scale, float *offset) {
+    float midVal = (maxVal - minVal) / 2;
+    *scale = 1.0f / midVal;
+    *offset = -(minVal * *scale) - 1.0f;
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "decimator_kernel.h"
+
+#include <cmath>
+
+#define DECIMATOR_KAISER_BETA       5.65    // 60 dB stop band
+#define DECIMATOR_Q15_ONE           32768
+
+/// Zeroth order modified Bessel function of the first kind (for the window).
+static double bessel_i0(double x) {
+    double sum = 1;
+    double term = 1;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+void decimator_design(size_t factor, int16_t *taps) {
+    size_t numTaps = decimator_num_taps(factor);
+    if (numTaps == 0) {
+        return;
+    }
+
+    // Cut off halfway through the transition band, at the output Nyquist.
+    double cutoff = 0.5 / factor; // cycles per input sample
+    double center = (numTaps - 1) / 2.0;
+    double window = bessel_i0(DECIMATOR_KAISER_BETA);
+    double ideal[decimator_num_taps(8)];
+    double sum = 0;
+    for (size_t i = 0; i < numTaps; i++) {
+        double t = i - center;
+        double sinc = 2 * cutoff * (t == 0 ? 1 : sin(2 * M_PI * cutoff * t) / (2 * M_PI * cutoff * t));
+        double r = t / center;
+        ideal[i] = sinc * bessel_i0(DECIMATOR_KAISER_BETA * sqrt(1 - r * r)) / window;
+        sum += ideal[i];
+    }
+
+    // Quantize pairs so the taps stay symmetric, then put whatever rounding
+    // left over into the middle pair so DC comes through unchanged.
+    int32_t total = 0;
+    for (size_t i = 0; i < numTaps / 2; i++) {
+        int16_t tap = (int16_t)lround(ideal[i] / sum * DECIMATOR_Q15_ONE);
+        taps[i] = tap;
+        taps[numTaps - 1 - i] = tap;
+        total += 2 * tap;
+    }
+    int32_t error = DECIMATOR_Q15_ONE - total; // Always even
+    taps[numTaps / 2 - 1] += error / 2;
+    taps[numTaps / 2] += error / 2;
+}
+
+int32_t decimator_dot_scalar(const int16_t *samples, const int16_t *taps, size_t numTaps) {
+    int32_t sum = 0;
+    for (size_t i = 0; i < numTaps; i++) {
+        sum += (int32_t)samples[i] * taps[i];
+    }
+    return sum;
+}
+
+#if ADC_FRAME_KERNEL_HAS_PIE
+// decimator_kernel_pie.S
+extern "C" int32_t decimator_dot_pie_blocks(const int16_t *samples, const int16_t *taps, size_t numBlocks);
+
+int32_t decimator_dot_pie(const int16_t *samples, const int16_t *taps, size_t numTaps) {
+    // 8 products per instruction into the 40-bit ACCX accumulator.
+    return decimator_dot_pie_blocks(samples, taps, numTaps / DECIMATOR_KERNEL_LANES);
+}
+#endif
+
+int32_t decimator_dot(const int16_t *samples, const int16_t *taps, size_t numTaps) {
+#if ADC_FRAME_KERNEL_HAS_PIE && DECIMATOR_KERNEL_USE_PIE
+    if (((uintptr_t)samples % ADC_FRAME_KERNEL_ALIGNMENT) == 0 && ((uintptr_t)taps % ADC_FRAME_KERNEL_ALIGNMENT) == 0
+        && (numTaps % DECIMATOR_KERNEL_LANES) == 0) {
+        return decimator_dot_pie(samples, taps, numTaps);
+    }
+#endif
+    return decimator_dot_scalar(samples, taps, numTaps);
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_DECIMATOR_KERNEL)
+#define TUNER_DECIMATOR_KERNEL
+
+#include <cstddef>
+#include <cstdint>
+
+#include "adc_frame_kernel.h"
+
+// The SIMD path multiplies 8 int16 lanes at a time. Tap counts are a
+// multiple of this and both vectors need to be aligned to
+// ADC_FRAME_KERNEL_ALIGNMENT.
+#define DECIMATOR_KERNEL_LANES          8
+
+// Set to 0 to force `decimator_dot()` onto the scalar path on the S3.
+#if !defined(DECIMATOR_KERNEL_USE_PIE)
+#define DECIMATOR_KERNEL_USE_PIE        ADC_FRAME_KERNEL_HAS_PIE
+#endif
+
+/// @brief Number of FIR taps used to decimate by `factor` (4 or 8).
+///
+/// The filter passes everything up to 2.1 kHz (C7, the top of the detector
+/// range) at the 5 kHz output rate and is down 60 dB from 2.9 kHz, so
+/// nothing can alias into the detector range. The transition band is the
+/// same width in Hz for both factors, so 8 needs about twice the taps.
+constexpr size_t decimator_num_taps(size_t factor) {
+    return factor == 4 ? 96 : factor == 8 ? 184 : 0;
+}
+
+/// @brief Designs the anti-alias low-pass for decimating by `factor`: a
+/// Kaiser windowed sinc in Q15 with a DC gain of exactly 1.0.
+/// @param taps Receives `decimator_num_taps(factor)` taps. The filter is
+/// symmetric so they can be used as is for a straight dot product.
+void decimator_design(size_t factor, int16_t *taps);
+
+/// @brief One of the dot product kernels below.
+typedef int32_t (*decimator_dot_fn_t)(const int16_t *samples, const int16_t *taps, size_t numTaps);
+
+/// @brief Multiplies `numTaps` samples with the taps and adds them up
+/// (portable reference implementation).
+/// @return The sum in Q15. It can't overflow for 12-bit samples.
+int32_t decimator_dot_scalar(const int16_t *samples, const int16_t *taps, size_t numTaps);
+
+#if ADC_FRAME_KERNEL_HAS_PIE
+/// @brief Same as `decimator_dot_scalar()` but uses the ESP32-S3 128-bit
+/// PIE multiply-accumulate, 8 taps per instruction.
+///
+/// `samples` and `taps` must be aligned to `ADC_FRAME_KERNEL_ALIGNMENT` and
+/// `numTaps` must be a multiple of `DECIMATOR_KERNEL_LANES`.
+int32_t decimator_dot_pie(const int16_t *samples, const int16_t *taps, size_t numTaps);
+#endif
+
+/// @brief Uses the fastest path available for the target and the alignment
+/// of the buffers.
+int32_t decimator_dot(const int16_t *samples, const int16_t *taps, size_t numTaps);
+
+#endif
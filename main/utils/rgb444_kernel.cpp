@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "rgb444_kernel.h"
+
+#include <cstring>
+
+/// @brief Packs two RGB565 pixels into the three bytes R1G1 B1R2 G2B2,
+/// returned in the low 24 bits in memory (little endian) order.
+static inline uint32_t rgb444_pack_pair(uint32_t a, uint32_t b) {
+    uint32_t byte0 = ((a >> 8) & 0xF0) | ((a >> 7) & 0x0F);
+    uint32_t byte1 = ((a << 3) & 0xF0) | (b >> 12);
+    uint32_t byte2 = ((b >> 3) & 0xF0) | ((b >> 1) & 0x0F);
+    return byte0 | (byte1 << 8) | (byte2 << 16);
+}
+
+void rgb444_pack(const uint16_t *src, size_t numPixels, uint8_t *dst) {
+    const uint8_t *in = (const uint8_t *)src;
+    size_t i = 0;
+
+    // 8 pixels (16 bytes) in, 12 bytes out. Every load of a block happens
+    // before its stores, which is what makes packing in place safe. The word
+    // shuffling assumes little endian like the S3 (and any host we build on).
+    for (; i + 8 <= numPixels; i += 8) {
+        uint32_t words[4];
+        memcpy(words, in + i * 2, sizeof(words));
+        uint32_t p0 = rgb444_pack_pair(words[0] & 0xFFFF, words[0] >> 16);
+        uint32_t p1 = rgb444_pack_pair(words[1] & 0xFFFF, words[1] >> 16);
+        uint32_t p2 = rgb444_pack_pair(words[2] & 0xFFFF, words[2] >> 16);
+        uint32_t p3 = rgb444_pack_pair(words[3] & 0xFFFF, words[3] >> 16);
+        uint32_t out[3] = {
+            p0 | (p1 << 24),
+            (p1 >> 8) | (p2 << 16),
+            (p2 >> 16) | (p3 << 8),
+        };
+        memcpy(dst + i / 2 * 3, out, sizeof(out));
+    }
+
+    for (; i + 2 <= numPixels; i += 2) {
+        uint16_t a;
+        uint16_t b;
+        memcpy(&a, in + i * 2, sizeof(a));
+        memcpy(&b, in + i * 2 + 2, sizeof(b));
+        uint32_t packed = rgb444_pack_pair(a, b);
+        uint8_t *out = dst + i / 2 * 3;
+        out[0] = packed & 0xFF;
+        out[1] = (packed >> 8) & 0xFF;
+        out[2] = (packed >> 16) & 0xFF;
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2025 Boyd Timothy. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#if !defined(TUNER_RGB444_KERNEL)
+#define TUNER_RGB444_KERNEL
+
+// Called from the C display driver so stick to C headers here.
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Number of bytes `rgb444_pack()` writes for `numPixels` pixels.
+#define RGB444_PACKED_SIZE(numPixels)   ((numPixels) * 3 / 2)
+
+/// @brief Packs RGB565 pixels into the ST7789's 12-bit (COLMOD 0x53) format,
+/// two pixels per three bytes: R1G1 B1R2 G2B2. Each channel keeps its top 4
+/// bits.
+///
+/// `dst` may be the same buffer as `src` (the packed data is smaller so it
+/// never overtakes the pixels still to be read), which is how the flush
+/// callback uses it.
+///
+/// @param src RGB565 pixels in native (little) endian.
+/// @param numPixels Number of pixels. Must be even.
+/// @param dst Receives `RGB444_PACKED_SIZE(numPixels)` bytes.
+void rgb444_pack(const uint16_t *src, size_t numPixels, uint8_t *dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2,6 +2,12 @@
 
 #include "esp_lvgl_port.h"
 #include "defines.h"
+#include "rgb444_kernel.h"
+#include "latency_trace.h"
+
+#if LCD_RGB444 && LCD_SOFTWARE_ROTATION
+#error "LCD_RGB444 replaces esp_lvgl_port's flush callback, which is what does the software rotation"
+#endif
 
 static const char *TAG = "LVGL";
 
@@ -22,16 +28,33 @@ bool lvgl_notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_pa
         return false;
     }
     lv_disp_flush_ready(display);
+#if TUNER_PROFILE_LATENCY
+    latency_trace_flush_done();
+#endif
     return false;
 }
 
 void lvgl_flush_cb(lv_display_t *display, const lv_area_t *area, uint8_t * px_map)
 {
+#if LCD_RGB444
+    // LVGL renders RGB565, pack it down to 12 bits in place before it goes out
+    rgb444_pack((const uint16_t *)px_map, lv_area_get_size(area), px_map);
+#endif
     // copy a buffer's content to a specific area of the display
-    esp_lcd_panel_draw_bitmap(panel_handle, area->x1, area->y1, area->x2 + 1, area->y2 + 1, px_map);
+    esp_lcd_panel_draw_bitmap(lcd_panel, area->x1, area->y1, area->x2 + 1, area->y2 + 1, px_map);
     // lv_display_flush_ready(lvgl_display);
 }
 
+#if LCD_RGB444
+/* 12-bit pixels go out in pairs so keep every area an even number of pixels wide */
+static void lvgl_rgb444_rounder_cb(lv_event_t *e)
+{
+    lv_area_t *area = (lv_area_t *)lv_event_get_param(e);
+    area->x1 &= ~1;
+    area->x2 |= 1;
+}
+#endif
+
 // /* Rotate display and touch, when rotated screen in LVGL. Called when driver parameters are updated. */
 // void lvgl_port_update_callback(lv_disp_drv_t *drv)
 // {
@@ -102,5 +125,21 @@ void LVGL_Init(void)
 
     lvgl_display = lvgl_port_add_disp(&disp_cfg);
 
+#if LCD_RGB444 || TUNER_PROFILE_LATENCY
+    // Take over the DMA done callback that tells LVGL the buffer is free
+    // again. It does the same thing as esp_lvgl_port's but also marks the
+    // moment a traced frame's last pixel has been sent.
+    const esp_lcd_panel_io_callbacks_t io_cbs = {
+        .on_color_trans_done = lvgl_notify_lvgl_flush_ready,
+    };
+    esp_lcd_panel_io_register_event_callbacks(lcd_io, &io_cbs, lvgl_display);
+#endif
+
+#if LCD_RGB444
+    // esp_lvgl_port's flush sends LVGL's buffer as is, so take over the flush.
+    lv_display_set_flush_cb(lvgl_display, lvgl_flush_cb);
+    lv_display_add_event_cb(lvgl_display, lvgl_rgb444_rounder_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+#endif
+
 
 }
@@ -37,7 +37,11 @@ esp_err_t LCD_Init(void)
     esp_lcd_panel_dev_st7789t_config_t panel_config = {
         .reset_gpio_num = PIN_NUM_LCD_RST,
         .rgb_endian = LCD_RGB_ENDIAN_BGR,
+#if LCD_RGB444
+        .bits_per_pixel = 12,
+#else
         .bits_per_pixel = 16,
+#endif
     };
     ESP_RETURN_ON_ERROR(esp_lcd_new_panel_st7789t(lcd_io, &panel_config, &lcd_panel), TAG, "Failed to create new ST7789T panel");
 
@@ -47,6 +47,8 @@ typedef struct {
     uint8_t fb_bits_per_pixel;
     uint8_t madctl_val; // save current value of LCD_CMD_MADCTL register
     uint8_t colmod_cal; // save surrent value of LCD_CMD_COLMOD register
+    uint16_t scroll_top; // first line of the scrolling area (VSCRDEF TFA)
+    uint16_t scroll_lines; // height of the scrolling area (VSCRDEF VSA)
 } st7789t_panel_t;
 
 esp_err_t esp_lcd_new_panel_st7789t(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_st7789t_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel)
@@ -82,6 +84,10 @@ esp_err_t esp_lcd_new_panel_st7789t(const esp_lcd_panel_io_handle_t io, const es
 
     uint8_t fb_bits_per_pixel = 0;
     switch (panel_dev_config->bits_per_pixel) {
+    case 12: // RGB444, two pixels packed into three bytes
+        st7789t->colmod_cal = 0x53;
+        fb_bits_per_pixel = 12;
+        break;
     case 16: // RGB565
         st7789t->colmod_cal = 0x55;
         fb_bits_per_pixel = 16;
@@ -100,6 +106,8 @@ esp_err_t esp_lcd_new_panel_st7789t(const esp_lcd_panel_io_handle_t io, const es
     st7789t->fb_bits_per_pixel = fb_bits_per_pixel;
     st7789t->reset_gpio_num = panel_dev_config->reset_gpio_num;
     st7789t->reset_level = panel_dev_config->flags.reset_active_high;
+    st7789t->scroll_top = 0;
+    st7789t->scroll_lines = ST7789T_GATE_LINES;
     st7789t->base.del = panel_st7789t_del;
     st7789t->base.reset = panel_st7789t_reset;
     st7789t->base.init = panel_st7789t_init;
@@ -168,8 +176,8 @@ static esp_err_t panel_st7789t_init(esp_lcd_panel_t *panel)
     
     /* Memory Data Access Control, MX=MV=1, MY=ML=MH=0, RGB=0 */
     esp_lcd_panel_io_tx_param(io, 0x36, (uint8_t []){0x00}, 1);                           // 0x36: 接口像素格式 X镜像，Y镜像
-    /* Interface Pixel Format, 16bits/pixel for RGB/MCU interface */
-    esp_lcd_panel_io_tx_param(io, 0x3A, (uint8_t []){0x55}, 1);                           // 0x3A: Porch 设置
+    /* Interface Pixel Format, 16bits/pixel (or 12bits/pixel) for RGB/MCU interface */
+    esp_lcd_panel_io_tx_param(io, 0x3A, (uint8_t []){st7789t->colmod_cal}, 1);                           // 0x3A: Porch 设置
     
     esp_lcd_panel_io_tx_param(io, 0xB0, (uint8_t []){0x00, 0xE8}, 2);   
     /* Porch Setting */
@@ -208,6 +216,8 @@ static esp_err_t panel_st7789t_draw_bitmap(esp_lcd_panel_t *panel, int x_start,
 {
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     assert((x_start < x_end) && (y_start < y_end) && "start position must be smaller than end position");
+    // 12-bit pixels come in pairs, the controller would wrap a half pair around to the start of the window
+    assert((st7789t->fb_bits_per_pixel != 12 || ((x_end - x_start) * (y_end - y_start)) % 2 == 0) && "12-bit writes must be an even number of pixels");
     esp_lcd_panel_io_handle_t io = st7789t->io;
 
     x_start += st7789t->x_gap;
@@ -305,3 +315,62 @@ static esp_err_t panel_st7789t_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
     esp_lcd_panel_io_tx_param(io, command, NULL, 0);
     return ESP_OK;
 }
+
+esp_err_t esp_lcd_panel_st7789t_set_scroll_area(esp_lcd_panel_handle_t panel, uint16_t top_fixed_lines, uint16_t scroll_lines, uint16_t bottom_fixed_lines)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(top_fixed_lines + scroll_lines + bottom_fixed_lines == ST7789T_GATE_LINES && scroll_lines > 0,
+                        ESP_ERR_INVALID_ARG, TAG, "scroll areas must add up to %d lines", ST7789T_GATE_LINES);
+    st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
+    esp_lcd_panel_io_handle_t io = st7789t->io;
+
+    st7789t->scroll_top = top_fixed_lines;
+    st7789t->scroll_lines = scroll_lines;
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_VSCRDEF, (uint8_t[]) {
+        (top_fixed_lines >> 8) & 0xFF,
+        top_fixed_lines & 0xFF,
+        (scroll_lines >> 8) & 0xFF,
+        scroll_lines & 0xFF,
+        (bottom_fixed_lines >> 8) & 0xFF,
+        bottom_fixed_lines & 0xFF,
+    }, 6);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st7789t_set_scroll_offset(esp_lcd_panel_handle_t panel, uint16_t offset)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
+    esp_lcd_panel_io_handle_t io = st7789t->io;
+
+    // VSCSAD is the frame memory line shown at the top of the scrolling area
+    uint16_t start_line = st7789t->scroll_top + (offset % st7789t->scroll_lines);
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_VSCSAD, (uint8_t[]) {
+        (start_line >> 8) & 0xFF,
+        start_line & 0xFF,
+    }, 2);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st7789t_set_orientation(esp_lcd_panel_handle_t panel, bool swap_axes, bool mirror_x, bool mirror_y)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
+    esp_lcd_panel_io_handle_t io = st7789t->io;
+
+    uint8_t madctl_val = st7789t->madctl_val & ~(LCD_CMD_MV_BIT | LCD_CMD_MX_BIT | LCD_CMD_MY_BIT);
+    if (swap_axes) {
+        madctl_val |= LCD_CMD_MV_BIT;
+    }
+    if (mirror_x) {
+        madctl_val |= LCD_CMD_MX_BIT;
+    }
+    if (mirror_y) {
+        madctl_val |= LCD_CMD_MY_BIT;
+    }
+    st7789t->madctl_val = madctl_val;
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, (uint8_t[]) {
+        st7789t->madctl_val
+    }, 1);
+    return ESP_OK;
+}
@@ -42,6 +42,57 @@ typedef struct {
  */
 esp_err_t esp_lcd_new_panel_st7789t(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_st7789t_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel);
 
+/**
+ * @brief Number of gate lines (the 320 pixel axis) the ST7789T scrolls over
+ */
+#define ST7789T_GATE_LINES  320
+
+/**
+ * @brief Define the vertical scrolling area (VSCRDEF)
+ *
+ * The panel scrolls whole gate lines, which is the long (320 pixel) axis of
+ * the panel no matter how MADCTL rotates the image. Lines outside of the
+ * scrolling area stay put. The fixed areas are counted in gate line order, so
+ * keep them the same size if the panel may be mirrored along that axis.
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st7789t()
+ * @param[in] top_fixed_lines Number of lines before the scrolling area
+ * @param[in] scroll_lines Number of lines in the scrolling area
+ * @param[in] bottom_fixed_lines Number of lines after the scrolling area
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if the three areas don't add up to ST7789T_GATE_LINES
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st7789t_set_scroll_area(esp_lcd_panel_handle_t panel, uint16_t top_fixed_lines, uint16_t scroll_lines, uint16_t bottom_fixed_lines);
+
+/**
+ * @brief Scroll the contents of the scrolling area (VSCSAD)
+ *
+ * Only sends the command and two bytes of data, the frame memory is untouched.
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st7789t()
+ * @param[in] offset Number of lines to scroll by (wraps around the scrolling area)
+ * @return
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st7789t_set_scroll_offset(esp_lcd_panel_handle_t panel, uint16_t offset);
+
+/**
+ * @brief Set the swap and both mirror bits of MADCTL with a single command
+ *
+ * Same result as esp_lcd_panel_swap_xy() followed by esp_lcd_panel_mirror()
+ * but without the intermediate MADCTL write, so the panel never scans out a
+ * frame with only half of the new orientation applied.
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st7789t()
+ * @param[in] swap_axes Exchange rows and columns (MV)
+ * @param[in] mirror_x Mirror the column address order (MX)
+ * @param[in] mirror_y Mirror the row address order (MY)
+ * @return
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st7789t_set_orientation(esp_lcd_panel_handle_t panel, bool swap_axes, bool mirror_x, bool mirror_y);
+
 #ifdef __cplusplus
 }
 #endif
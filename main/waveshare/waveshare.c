@@ -22,6 +22,9 @@
 #include <esp_lcd_touch.h>
 #include "esp_lvgl_port.h"
 #include "ST7789.h"
+#include "esp_lcd_panel_commands.h"
+#include "esp_check.h"
+#include "defines.h"
 
 static const char *TAG = "Waveshare";
 
@@ -32,6 +35,8 @@ esp_lcd_panel_handle_t lcd_panel = NULL;
 esp_lcd_touch_handle_t tp = NULL;
 lv_indev_t *touch_device = NULL;
 
+static lv_display_rotation_t lcd_rotation = LV_DISPLAY_ROTATION_0;
+
 void lvgl_flush_cb(lv_display_t *display, const lv_area_t *area, uint8_t *px_map);
 
 esp_err_t waveshare_lcd_init() {
@@ -68,10 +73,86 @@ esp_err_t lcd_display_brightness_set(uint8_t brightness) {
   }
   
 esp_err_t lcd_display_rotate(lv_display_t * lvgl_disp, lv_display_rotation_t dir) {
-    if (lvgl_disp) {
-        lv_display_set_rotation(lvgl_disp, dir);
-        return ESP_OK;
+    if (!lvgl_disp) {
+        return ESP_FAIL;
+    }
+
+#if LCD_SOFTWARE_ROTATION
+    lv_display_set_rotation(lvgl_disp, dir);
+#else
+    // Let the panel do the rotation so LVGL renders straight into the rotated
+    // resolution and every flush is a plain DMA copy. LVGL's own rotation
+    // stays at 0. These are the same MADCTL bits esp_lvgl_port picks for each
+    // rotation so the image ends up the same way around on the glass.
+    bool swap_xy = false;
+    bool mirror_x = LCD_MIRROR_X;
+    bool mirror_y = LCD_MIRROR_Y;
+    switch (dir) {
+    case LV_DISPLAY_ROTATION_90:
+        swap_xy = true;
+        mirror_y = !LCD_MIRROR_Y;
+        break;
+    case LV_DISPLAY_ROTATION_180:
+        mirror_x = !LCD_MIRROR_X;
+        mirror_y = !LCD_MIRROR_Y;
+        break;
+    case LV_DISPLAY_ROTATION_270:
+        swap_xy = true;
+        mirror_x = !LCD_MIRROR_X;
+        break;
+    default:
+        break;
     }
 
-    return ESP_FAIL;
-}
\ No newline at end of file
+    if (swap_xy) {
+        lv_display_set_resolution(lvgl_disp, LCD_V_RES, LCD_H_RES);
+    } else {
+        lv_display_set_resolution(lvgl_disp, LCD_H_RES, LCD_V_RES);
+    }
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_st7789t_set_orientation(lcd_panel, swap_xy, mirror_x, mirror_y), TAG, "Failed to set panel orientation");
+
+    // The panel now maps what's already in its memory differently. Changing
+    // the resolution only invalidates the screen when the size changes, not
+    // for 0 <-> 180 or 90 <-> 270, so redraw everything here.
+    lv_obj_invalidate(lv_display_get_screen_active(lvgl_disp));
+
+    // LVGL only transforms touch points for its own rotation, so do the same
+    // thing it would have done in the touch driver instead.
+    if (tp) {
+        esp_lcd_touch_set_swap_xy(tp, swap_xy);
+        esp_lcd_touch_set_mirror_x(tp, dir == LV_DISPLAY_ROTATION_180 || dir == LV_DISPLAY_ROTATION_270);
+        esp_lcd_touch_set_mirror_y(tp, dir == LV_DISPLAY_ROTATION_90 || dir == LV_DISPLAY_ROTATION_180);
+    }
+#endif
+
+    lcd_rotation = dir;
+    return ESP_OK;
+}
+
+lv_display_rotation_t lcd_display_get_rotation() {
+    return lcd_rotation;
+}
+
+esp_err_t lcd_display_scroll_area_set(uint16_t first_line, uint16_t num_lines) {
+    if (first_line + num_lines > ST7789T_GATE_LINES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return esp_lcd_panel_st7789t_set_scroll_area(lcd_panel, first_line, num_lines, ST7789T_GATE_LINES - first_line - num_lines);
+}
+
+esp_err_t lcd_display_scroll_offset_set(uint16_t offset) {
+    return esp_lcd_panel_st7789t_set_scroll_offset(lcd_panel, offset);
+}
+
+esp_err_t lcd_display_scroll_reset() {
+    esp_err_t err = esp_lcd_panel_st7789t_set_scroll_area(lcd_panel, 0, ST7789T_GATE_LINES, 0);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = esp_lcd_panel_st7789t_set_scroll_offset(lcd_panel, 0);
+    if (err != ESP_OK) {
+        return err;
+    }
+    // Leave scroll mode
+    return esp_lcd_panel_io_tx_param(lcd_io, LCD_CMD_NORON, NULL, 0);
+}
@@ -30,9 +30,27 @@ esp_err_t waveshare_lcd_init();
 esp_err_t waveshare_lvgl_init();
 esp_err_t waveshare_touch_init();
 
+/// @brief Rotates the screen. Unless LCD_SOFTWARE_ROTATION is set this is done
+/// by the panel (MADCTL) and `lv_display_get_rotation()` stays at 0, so use
+/// `lcd_display_get_rotation()` to find out how the screen is rotated.
 esp_err_t lcd_display_rotate(lv_display_t * lvgl_disp, lv_display_rotation_t dir);
+
+/// @brief Returns the rotation last set with `lcd_display_rotate()`.
+lv_display_rotation_t lcd_display_get_rotation();
 esp_err_t lcd_display_brightness_set(uint8_t brightness);
 
+/// @brief Sets up hardware scrolling of `num_lines` lines starting at
+/// `first_line` along the panel's long (320 pixel) axis. Everything else on
+/// the screen stays put.
+esp_err_t lcd_display_scroll_area_set(uint16_t first_line, uint16_t num_lines);
+
+/// @brief Scrolls the hardware scrolling area by `offset` lines (wrapping).
+esp_err_t lcd_display_scroll_offset_set(uint16_t offset);
+
+/// @brief Turns hardware scrolling back off (the whole panel is one unscrolled
+/// area). Call this before handing the screen to a UI that doesn't scroll.
+esp_err_t lcd_display_scroll_reset();
+
 
 #ifdef __cplusplus
 }